@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+#include <map>
+#include <random>
+#include <vector>
+#include <edyn/util/entity_pair.hpp>
+#include <edyn/util/flat_hash_map.hpp>
+
+// Compares `flat_hash_map` with `std::map`, which used to back `entity_map`
+// and `contact_manifold_map`, using pairs of entities as keys as in the
+// lookups of contact manifolds done by the broadphase.
+
+namespace {
+
+// Wraps `std::map` in the interface of `flat_hash_map`.
+template<typename Key, typename Value>
+class std_map_adapter {
+public:
+    bool contains(const Key &key) const {
+        return m_map.count(key) > 0;
+    }
+
+    void insert_or_assign(const Key &key, const Value &value) {
+        m_map[key] = value;
+    }
+
+    void erase(const Key &key) {
+        m_map.erase(key);
+    }
+
+private:
+    std::map<Key, Value> m_map;
+};
+
+entt::entity make_entity(std::mt19937 &rng, size_t range) {
+    return static_cast<entt::entity>(rng() % range);
+}
+
+std::vector<edyn::entity_pair> make_pairs(std::mt19937 &rng, size_t count, size_t range) {
+    auto pairs = std::vector<edyn::entity_pair>{};
+    pairs.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        pairs.emplace_back(make_entity(rng, range), make_entity(rng, range));
+    }
+
+    return pairs;
+}
+
+// Looks up pairs of entities where about half of them are in the map.
+template<typename Map>
+void lookup(benchmark::State &state) {
+    auto count = static_cast<size_t>(state.range(0));
+    auto range = count * 4;
+    auto rng = std::mt19937(1);
+    auto keys = make_pairs(rng, count, range);
+    auto queries = make_pairs(rng, 4096, range);
+
+    for (size_t i = 0; i < queries.size(); i += 2) {
+        queries[i] = keys[rng() % keys.size()];
+    }
+
+    auto map = Map{};
+
+    for (auto &key : keys) {
+        map.insert_or_assign(key, key.first);
+    }
+
+    for (auto _ : state) {
+        size_t hits = 0;
+
+        for (auto &query : queries) {
+            hits += map.contains(query);
+        }
+
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+// Inserts new pairs and erases old ones while the number of elements stays
+// the same, as contact manifolds are created and destroyed.
+template<typename Map>
+void churn(benchmark::State &state) {
+    auto count = static_cast<size_t>(state.range(0));
+    auto rng = std::mt19937(1);
+    auto keys = make_pairs(rng, count * 2, count * 16);
+    auto map = Map{};
+
+    for (size_t i = 0; i < count; ++i) {
+        map.insert_or_assign(keys[i], keys[i].first);
+    }
+
+    size_t index = 0;
+
+    for (auto _ : state) {
+        auto &key_in = keys[(index + count) % keys.size()];
+        auto &key_out = keys[index];
+        map.insert_or_assign(key_in, key_in.first);
+        map.erase(key_out);
+        index = (index + 1) % keys.size();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+using std_pair_map = std_map_adapter<edyn::entity_pair, entt::entity>;
+using flat_pair_map = edyn::flat_hash_map<edyn::entity_pair, entt::entity>;
+
+}
+
+BENCHMARK_TEMPLATE(lookup, std_pair_map)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK_TEMPLATE(lookup, flat_pair_map)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK_TEMPLATE(churn, std_pair_map)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK_TEMPLATE(churn, flat_pair_map)->Arg(1000)->Arg(10000)->Arg(100000);
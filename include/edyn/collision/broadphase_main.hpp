@@ -54,6 +54,12 @@ public:
     template<typename Func>
     void raycast_non_procedural(vector3 p0, vector3 p1, Func func);
 
+    template<typename Func>
+    void raycast_islands_packet(const ray_packet &packet, uint32_t mask, Func func) const;
+
+    template<typename Func>
+    void raycast_non_procedural_packet(const ray_packet &packet, uint32_t mask, Func func) const;
+
     void on_construct_tree_view(entt::registry &, entt::entity);
     void on_construct_static_kinematic_tag(entt::registry &, entt::entity);
     void on_construct_aabb(entt::registry &, entt::entity);
@@ -96,6 +102,20 @@ void broadphase_main::raycast_non_procedural(vector3 p0, vector3 p1, Func func)
     });
 }
 
+template<typename Func>
+void broadphase_main::raycast_islands_packet(const ray_packet &packet, uint32_t mask, Func func) const {
+    m_island_tree.raycast_packet(packet, mask, [&](tree_node_id_t id, uint32_t hit_mask) {
+        func(m_island_tree.get_node(id).entity, hit_mask);
+    });
+}
+
+template<typename Func>
+void broadphase_main::raycast_non_procedural_packet(const ray_packet &packet, uint32_t mask, Func func) const {
+    m_np_tree.raycast_packet(packet, mask, [&](tree_node_id_t id, uint32_t hit_mask) {
+        func(m_np_tree.get_node(id).entity, hit_mask);
+    });
+}
+
 }
 
 #endif // EDYN_COLLISION_BROADPHASE_MAIN_HPP
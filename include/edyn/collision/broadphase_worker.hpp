@@ -39,9 +39,15 @@ public:
      */
     tree_view view() const;
 
+    template<typename Func>
+    void query(const AABB &aabb, Func func) const;
+
     template<typename Func>
     void raycast(vector3 p0, vector3 p1, Func func);
 
+    template<typename Func>
+    void raycast_packet(const ray_packet &packet, uint32_t mask, Func func) const;
+
     void on_construct_aabb(entt::registry &, entt::entity);
     void on_destroy_tree_resident(entt::registry &, entt::entity);
 
@@ -53,6 +59,16 @@ private:
     std::vector<entity_pair_vector> m_pair_results;
 };
 
+template<typename Func>
+void broadphase_worker::query(const AABB &aabb, Func func) const {
+    m_tree.query(aabb, [&](tree_node_id_t id) {
+        func(m_tree.get_node(id).entity);
+    });
+    m_np_tree.query(aabb, [&](tree_node_id_t id) {
+        func(m_np_tree.get_node(id).entity);
+    });
+}
+
 template<typename Func>
 void broadphase_worker::raycast(vector3 p0, vector3 p1, Func func) {
     m_tree.raycast(p0, p1, [&](tree_node_id_t id) {
@@ -63,6 +79,16 @@ void broadphase_worker::raycast(vector3 p0, vector3 p1, Func func) {
     });
 }
 
+template<typename Func>
+void broadphase_worker::raycast_packet(const ray_packet &packet, uint32_t mask, Func func) const {
+    m_tree.raycast_packet(packet, mask, [&](tree_node_id_t id, uint32_t hit_mask) {
+        func(m_tree.get_node(id).entity, hit_mask);
+    });
+    m_np_tree.raycast_packet(packet, mask, [&](tree_node_id_t id, uint32_t hit_mask) {
+        func(m_np_tree.get_node(id).entity, hit_mask);
+    });
+}
+
 }
 
 #endif // EDYN_COLLISION_BROADPHASE_WORKER_HPP
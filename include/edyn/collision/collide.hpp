@@ -3,6 +3,7 @@
 
 #include "edyn/shapes/shapes.hpp"
 #include "edyn/collision/collision_result.hpp"
+#include "edyn/collision/sat_axis_cache.hpp"
 #include "edyn/util/aabb_util.hpp"
 #include "edyn/util/tuple_util.hpp"
 
@@ -19,6 +20,13 @@ struct collision_context {
 
     scalar threshold;
 
+    // Optional cache of the separating axis found in the previous step, used
+    // by the separating axis tests between boxes and between polyhedra. It
+    // is not carried over to swapped contexts nor to the children of
+    // compounds since it's only valid for the same pair of shapes in the same
+    // order.
+    sat_axis_cache *sat_cache {nullptr};
+
     collision_context swapped() const {
         return {posB, ornB, aabbB,
                 posA, ornA, aabbA,
@@ -293,6 +301,7 @@ void collide(const compound_shape &shA, const T &shB,
         auto child_ctx = ctx;
         child_ctx.posA = to_world_space(nodeA.position, ctx.posA, ctx.ornA);
         child_ctx.ornA = ctx.ornA * nodeA.orientation;
+        child_ctx.sat_cache = nullptr;
 
         collision_result child_result;
         collide(sh, shB, child_ctx, child_result);
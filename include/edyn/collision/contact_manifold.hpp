@@ -8,6 +8,7 @@
 #include "edyn/config/config.h"
 #include "edyn/config/constants.hpp"
 #include "edyn/collision/contact_point.hpp"
+#include "edyn/collision/sat_axis_cache.hpp"
 
 namespace edyn {
 
@@ -26,6 +27,11 @@ struct contact_manifold {
     // Number of contact points in this manifold.
     uint8_t num_points {0};
 
+    // Whether continuous collision detection is enabled for either body, in
+    // which case contact points are created ahead of time and solved as
+    // speculative contacts. Assigned in the narrow-phase.
+    bool speculative {false};
+
     // Ids/indices of contact points in this manifold. Only the entries at
     // indices up to `num_points - 1` are valid.
     std::array<contact_id_type, max_contacts> ids;
@@ -34,6 +40,12 @@ struct contact_manifold {
     // the `ids` array.
     std::array<contact_point, max_contacts> point;
 
+    // Separating axis found in the last collision detection between the
+    // shapes of both bodies, if they're boxes or polyhedra. It is not
+    // serialized, thus it starts over when the manifold is moved to another
+    // island.
+    sat_axis_cache sat_cache;
+
     /**
      * @brief Get a contact point by index.
      * @param index Contact point index.
@@ -74,6 +86,7 @@ void serialize(Archive &archive, contact_manifold &manifold) {
     archive(manifold.body);
     archive(manifold.separation_threshold);
     archive(manifold.num_points);
+    archive(manifold.speculative);
 
     for (unsigned i = 0; i < manifold.num_points; ++i) {
         archive(manifold.ids[i]);
@@ -1,10 +1,10 @@
 #ifndef EDYN_COLLISION_CONTACT_MANIFOLD_MAP
 #define EDYN_COLLISION_CONTACT_MANIFOLD_MAP
 
-#include <map>
 #include <utility>
 #include <entt/entity/fwd.hpp>
 #include "edyn/util/entity_pair.hpp"
+#include "edyn/util/flat_hash_map.hpp"
 
 namespace edyn {
 
@@ -39,7 +39,7 @@ public:
     void on_destroy_contact_manifold(entt::registry &, entt::entity);
 
 private:
-    std::map<entity_pair, entt::entity> m_pair_map;
+    flat_hash_map<entity_pair, entt::entity> m_pair_map;
 };
 
 }
@@ -8,6 +8,7 @@
 #include "edyn/math/geom.hpp"
 #include "edyn/collision/tree_node.hpp"
 #include "edyn/collision/query_tree.hpp"
+#include "edyn/collision/wide_tree.hpp"
 
 namespace edyn {
 
@@ -89,6 +90,16 @@ public:
     template<typename Func>
     void raycast(vector3 p0, vector3 p1, Func func) const;
 
+    /**
+     * @brief Call `func` for all nodes that intersect any ray in the packet.
+     * @param packet The ray packet.
+     * @param mask Set of rays of the packet to traverse with.
+     * @param func Function to be called for each overlapping node. It takes a
+     * `tree_node_id_t` and the `uint32_t` set of rays that intersect the node.
+     */
+    template<typename Func>
+    void raycast_packet(const ray_packet &packet, uint32_t mask, Func func) const;
+
     /**
      * @brief Gets a tree node.
      *
@@ -97,6 +108,14 @@ public:
      */
     const tree_node & get_node(tree_node_id_t) const;
 
+    /**
+     * @brief Collapses the tree into a 4-ary tree which is used for queries
+     * until the tree is modified again, i.e. until a node is created,
+     * destroyed or moved outside of its inflated AABB. Should be called after
+     * updating the tree and before performing many queries.
+     */
+    void update_wide_tree();
+
     tree_view view() const;
 
 private:
@@ -104,16 +123,36 @@ private:
 
     std::vector<tree_node> m_nodes;
     tree_node_id_t m_free_list;
+
+    wide_tree m_wide_tree;
+    bool m_wide_tree_valid {false};
 };
 
 template<typename Func>
 void dynamic_tree::query(const AABB &aabb, Func func) const {
-    query_tree(*this, m_root, null_tree_node_id, aabb, func);
+    if (m_wide_tree_valid) {
+        m_wide_tree.query(aabb, func);
+    } else {
+        query_tree(*this, m_root, null_tree_node_id, aabb, func);
+    }
 }
 
 template<typename Func>
 void dynamic_tree::raycast(vector3 p0, vector3 p1, Func func) const {
-    raycast_tree(*this, m_root, null_tree_node_id, p0, p1, func);
+    if (m_wide_tree_valid) {
+        m_wide_tree.raycast(p0, p1, func);
+    } else {
+        raycast_tree(*this, m_root, null_tree_node_id, p0, p1, func);
+    }
+}
+
+template<typename Func>
+void dynamic_tree::raycast_packet(const ray_packet &packet, uint32_t mask, Func func) const {
+    if (m_wide_tree_valid) {
+        m_wide_tree.raycast_packet(packet, mask, func);
+    } else {
+        raycast_tree_packet(*this, m_root, null_tree_node_id, packet, mask, func);
+    }
 }
 
 }
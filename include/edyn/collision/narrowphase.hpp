@@ -70,6 +70,8 @@ void narrowphase::update_contact_manifolds(Iterator begin, Iterator end,
     auto tr_view = m_registry->view<position, orientation>();
     auto origin_view = m_registry->view<origin>();
     auto vel_view = m_registry->view<angvel>();
+    auto linvel_view = m_registry->view<linvel>();
+    auto ccd_view = m_registry->view<ccd_tag>();
     auto rolling_view = m_registry->view<rolling_tag>();
     auto material_view = m_registry->view<material>();
     auto orn_view = m_registry->view<orientation>();
@@ -83,7 +85,9 @@ void narrowphase::update_contact_manifolds(Iterator begin, Iterator end,
         auto &manifold = manifold_view.template get<contact_manifold>(manifold_entity);
         auto &events = events_view.get<contact_manifold_events>(manifold_entity);
         collision_result result;
-        detect_collision(manifold.body, result, body_view, origin_view, views_tuple);
+        manifold.speculative = ccd_view.contains(manifold.body[0]) || ccd_view.contains(manifold.body[1]);
+        auto threshold = get_collision_threshold(manifold.body, linvel_view, ccd_view, dt);
+        detect_collision(manifold.body, result, body_view, origin_view, views_tuple, threshold, &manifold.sat_cache);
 
         process_collision(manifold_entity, manifold, events, result, tr_view, vel_view,
                           rolling_view, origin_view, orn_view, material_view,
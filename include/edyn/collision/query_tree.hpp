@@ -3,6 +3,9 @@
 
 #include "edyn/comp/aabb.hpp"
 #include "edyn/math/geom.hpp"
+#include "edyn/collision/ray_packet.hpp"
+#include <vector>
+#include <utility>
 
 namespace edyn {
 
@@ -49,6 +52,45 @@ void raycast_tree(const Tree &tree, NodeIdType root_id, NodeIdType null_node_id,
     }, func);
 }
 
+/**
+ * @brief Traverses a tree with a packet of rays. Each node is visited once for
+ * all rays in the packet that intersect it. Rays can be retired during the
+ * traversal by clearing their bit in `packet.active`.
+ * @param packet The ray packet.
+ * @param mask Set of rays of the packet to traverse with.
+ * @param func Function taking the id of a leaf node and the set of rays that
+ * intersect it.
+ */
+template<typename Tree, typename NodeIdType, typename Func>
+void raycast_tree_packet(const Tree &tree, NodeIdType root_id, NodeIdType null_node_id,
+                         const ray_packet &packet, uint32_t mask, Func func) {
+    std::vector<std::pair<NodeIdType, uint32_t>> stack;
+    stack.emplace_back(root_id, mask);
+
+    while (!stack.empty()) {
+        auto [id, node_mask] = stack.back();
+        stack.pop_back();
+
+        if (id == null_node_id) {
+            continue;
+        }
+
+        auto &node = tree.get_node(id);
+        node_mask = packet.intersect_mask(node.aabb, node_mask);
+
+        if (node_mask == 0) {
+            continue;
+        }
+
+        if (node.leaf()) {
+            func(id, node_mask);
+        } else {
+            stack.emplace_back(node.child1, node_mask);
+            stack.emplace_back(node.child2, node_mask);
+        }
+    }
+}
+
 }
 
 #endif // EDYN_COLLISION_QUERY_TREE_HPP
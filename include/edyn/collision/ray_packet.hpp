@@ -0,0 +1,101 @@
+#ifndef EDYN_COLLISION_RAY_PACKET_HPP
+#define EDYN_COLLISION_RAY_PACKET_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include "edyn/comp/aabb.hpp"
+#include "edyn/math/geom.hpp"
+#include "edyn/math/vector3.hpp"
+#include "edyn/config/config.h"
+
+namespace edyn {
+
+/**
+ * @brief A group of segments which are traversed through an AABB tree
+ * together. Sets of rays in the packet are represented by a bit mask where
+ * each bit corresponds to the ray at the same index. Nodes are first tested
+ * against the bounds of the whole packet, thus if the rays are coherent, i.e.
+ * they start and end close to one another, subtrees which are not hit by any
+ * of them are discarded with a single test and the nodes which are hit are
+ * loaded once for all rays.
+ */
+struct ray_packet {
+    static constexpr size_t max_size = 32;
+
+    std::array<vector3, max_size> p0;
+    std::array<vector3, max_size> p1;
+    size_t size {0};
+
+    // Rays which still have to be traversed. Bits can be cleared during
+    // traversal to retire rays, e.g. when any hit is enough.
+    uint32_t active {0};
+
+    // Bounds of all segments in the packet.
+    AABB bounds;
+
+    void push_back(const vector3 &point0, const vector3 &point1) {
+        EDYN_ASSERT(size < max_size);
+        p0[size] = point0;
+        p1[size] = point1;
+        active |= UINT32_C(1) << size;
+        ++size;
+    }
+
+    /**
+     * @brief Recalculates the bounds of the packet. Must be called after all
+     * rays are inserted. End points can be moved closer to the start point
+     * afterwards, e.g. to shorten a ray after a hit, without updating the
+     * bounds since they still enclose the segments.
+     */
+    void update_bounds() {
+        bounds = {vector3_max, -vector3_max};
+
+        for (size_t i = 0; i < size; ++i) {
+            bounds.min = min(bounds.min, min(p0[i], p1[i]));
+            bounds.max = max(bounds.max, max(p0[i], p1[i]));
+        }
+    }
+
+    /**
+     * @brief Finds which of the given rays intersect an AABB.
+     * @param aabb The AABB.
+     * @param mask Set of rays to test.
+     * @return Subset of `mask` containing the rays which intersect `aabb`.
+     */
+    uint32_t intersect_mask(const AABB &aabb, uint32_t mask) const {
+        mask &= active;
+
+        if (mask == 0 || !intersect(aabb, bounds)) {
+            return 0;
+        }
+
+        uint32_t result = 0;
+
+        for (auto m = mask; m != 0; m &= m - 1) {
+            auto i = lowest_bit_index(m);
+
+            if (intersect_segment_aabb(p0[i], p1[i], aabb.min, aabb.max)) {
+                result |= UINT32_C(1) << i;
+            }
+        }
+
+        return result;
+    }
+
+    static unsigned lowest_bit_index(uint32_t mask) {
+        EDYN_ASSERT(mask != 0);
+        unsigned index = 0;
+
+        while ((mask & 1) == 0) {
+            mask >>= 1;
+            ++index;
+        }
+
+        return index;
+    }
+};
+
+}
+
+#endif // EDYN_COLLISION_RAY_PACKET_HPP
@@ -1,10 +1,13 @@
 #ifndef EDYN_COLLISION_RAYCAST_HPP
 #define EDYN_COLLISION_RAYCAST_HPP
 
+#include <vector>
+#include <cstdint>
 #include <variant>
 #include <entt/entity/fwd.hpp>
 #include <entt/entity/entity.hpp>
 #include "edyn/math/vector3.hpp"
+#include "edyn/comp/collision_filter.hpp"
 #include "edyn/shapes/cylinder_shape.hpp"
 #include "edyn/shapes/capsule_shape.hpp"
 
@@ -145,6 +148,72 @@ struct raycast_context {
  */
 raycast_result raycast(entt::registry &registry, vector3 p0, vector3 p1);
 
+/**
+ * @brief A segment in a batch raycast query.
+ */
+struct raycast_ray {
+    // First point in the ray.
+    vector3 p0;
+    // Second point in the ray.
+    vector3 p1;
+};
+
+/**
+ * @brief Options for batch raycast queries.
+ */
+struct raycast_options {
+    // Stop at the first hit found for each ray instead of searching for the
+    // closest one. The hit is not necessarily the closest, which is enough
+    // for line-of-sight tests.
+    bool any_hit {false};
+    // Only entities whose collision group shares a bit with this mask are
+    // hit. Entities without a `collision_filter` belong to all groups.
+    uint64_t mask {collision_filter::all_groups};
+};
+
+/**
+ * @brief All hits of a batch raycast query grouped by ray.
+ */
+struct raycast_hits {
+    // The hits of ray `i` are in `[offsets[i], offsets[i + 1])`, sorted by
+    // fraction.
+    std::vector<raycast_result> hits;
+    std::vector<size_t> offsets;
+};
+
+/**
+ * @brief Performs many raycast queries at once. Rays are split into packets
+ * of consecutive rays which are traversed through the AABB trees together
+ * and packets are processed in parallel in the global `job_dispatcher`.
+ * Traversal is fastest when consecutive rays are close to one another, thus
+ * rays should be sorted accordingly, e.g. by origin. Unlike the single
+ * raycast, only hits within the segment, i.e. with a fraction in [0, 1], are
+ * reported. The registry must not be modified during the query.
+ * @param registry Data source.
+ * @param rays Array of `count` rays.
+ * @param results Array of `count` results where the hit of each ray is
+ * written to. The entity is set to `entt::null` if a ray hits nothing.
+ * @param count Number of rays.
+ * @param options Query options.
+ */
+void raycast(entt::registry &registry, const raycast_ray *rays,
+             raycast_result *results, size_t count,
+             const raycast_options &options = {});
+
+/**
+ * @brief Performs many raycast queries at once and collects all hits of each
+ * ray. See the batch `raycast` overload for details.
+ * @param registry Data source.
+ * @param rays Array of `count` rays.
+ * @param count Number of rays.
+ * @param hits Output hits. Previous contents are replaced.
+ * @param mask Only entities whose collision group shares a bit with this
+ * mask are hit.
+ */
+void raycast_all(entt::registry &registry, const raycast_ray *rays,
+                 size_t count, raycast_hits &hits,
+                 uint64_t mask = collision_filter::all_groups);
+
 // Raycast functions for each shape.
 
 shape_raycast_result shape_raycast(const box_shape &, const raycast_context &);
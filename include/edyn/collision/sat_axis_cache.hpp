@@ -0,0 +1,97 @@
+#ifndef EDYN_COLLISION_SAT_AXIS_CACHE_HPP
+#define EDYN_COLLISION_SAT_AXIS_CACHE_HPP
+
+#include <cstdint>
+#include "edyn/math/scalar.hpp"
+#include "edyn/math/vector3.hpp"
+#include "edyn/math/quaternion.hpp"
+
+namespace edyn {
+
+/**
+ * @brief Stores the axis of greatest separation found by the separating axis
+ * test between two convex shapes so it can be tested first in the next step.
+ * If the shapes are separated along the cached axis by more than the collision
+ * threshold, no other axis has to be tested. Otherwise, a cached face normal
+ * is still the best among all face normals if its separation is greater than
+ * that of every other face normal in the last full test plus the most they
+ * could have changed since then, which is bounded by how much the shapes moved
+ * relative to one another. In that case, the other face normals can be
+ * skipped. This does not hold for edges. The direction of the cross product of
+ * two edges can change arbitrarily fast when they are close to parallel, thus
+ * edge pairs must always be tested and a cached edge axis is only used to find
+ * out that the shapes are still separated.
+ */
+struct sat_axis_cache {
+    enum class axis_kind : uint8_t {
+        none,
+        faceA,
+        faceB,
+        edges
+    };
+
+    // Feature pair which provides the axis. For faces, the index of the
+    // face of the other shape is not used.
+    axis_kind kind {axis_kind::none};
+    uint32_t indexA {0};
+    uint32_t indexB {0};
+
+    // Greatest separation among all other face normals in the last full test.
+    scalar runner_up_distance {0};
+
+    // Sum of the bounding radii of both shapes about their origins.
+    scalar radius {0};
+
+    // Pose of B relative to A in the last full test.
+    vector3 rel_pos {vector3_zero};
+    quaternion rel_orn {quaternion_identity};
+
+    void store(axis_kind axis, uint32_t idxA, uint32_t idxB,
+               scalar runner_up, scalar radiusA, scalar radiusB,
+               const vector3 &posA, const quaternion &ornA,
+               const vector3 &posB, const quaternion &ornB) {
+        kind = axis;
+        indexA = idxA;
+        indexB = idxB;
+        runner_up_distance = runner_up;
+        radius = radiusA + radiusB;
+        rel_orn = conjugate(ornA) * ornB;
+        rel_pos = rotate(conjugate(ornA), posB - posA);
+    }
+
+    /**
+     * @brief Checks whether the cached face normal is still the one of
+     * greatest separation among all face normals.
+     * @param distance Current separation along the cached axis.
+     * @return Whether the other face normals can be skipped. Always false for
+     * edge axes.
+     */
+    bool is_best(scalar distance,
+                 const vector3 &posA, const quaternion &ornA,
+                 const vector3 &posB, const quaternion &ornB) const {
+        if (kind != axis_kind::faceA && kind != axis_kind::faceB) {
+            return false;
+        }
+
+        auto orn = conjugate(ornA) * ornB;
+        auto pos = rotate(conjugate(ornA), posB - posA);
+
+        // Points at distance `r` from the center of rotation are displaced
+        // by at most `2 * r * sin(angle / 2)`, where the sine is the length
+        // of the vector part of the quaternion of the change in orientation.
+        auto delta_orn = conjugate(rel_orn) * orn;
+        auto sin_half_angle = length(vector3{delta_orn.x, delta_orn.y, delta_orn.z});
+        auto bound = length(pos - rel_pos) +
+                     scalar(2) * sin_half_angle * (radius + length(pos));
+
+        return distance >= runner_up_distance + bound;
+    }
+
+    void clear() {
+        kind = axis_kind::none;
+    }
+};
+
+}
+
+#endif // EDYN_COLLISION_SAT_AXIS_CACHE_HPP
@@ -0,0 +1,75 @@
+#ifndef EDYN_COLLISION_SHAPE_QUERY_HPP
+#define EDYN_COLLISION_SHAPE_QUERY_HPP
+
+#include <vector>
+#include <cstdint>
+#include <entt/entity/fwd.hpp>
+#include <entt/entity/entity.hpp>
+#include "edyn/math/vector3.hpp"
+#include "edyn/math/quaternion.hpp"
+#include "edyn/shapes/compound_shape.hpp"
+#include "edyn/comp/collision_filter.hpp"
+
+namespace edyn {
+
+/**
+ * @brief Shapes which can be used in shape queries, i.e. the convex shapes.
+ */
+using query_shape_variant_t = compound_shape::shapes_variant_t;
+
+/**
+ * @brief Information returned from a shape sweep query.
+ */
+struct shape_sweep_result {
+    // Fraction of the displacement where the shape first touches another
+    // shape. The swept shape is then located at
+    // `pos + displacement * fraction`.
+    scalar fraction { EDYN_SCALAR_MAX };
+    // Contact normal in world space pointing towards the swept shape.
+    vector3 normal;
+    // Contact point in world space on the surface of the shape that was hit.
+    vector3 point;
+    // The entity that was hit. It's set to `entt::null` if no entity is hit.
+    entt::entity entity { entt::null };
+};
+
+/**
+ * @brief Moves a shape along a displacement and finds the first entity it
+ * touches. The time of impact is found by conservative advancement using the
+ * same collision functions as the narrow-phase, thus it supports all
+ * combinations of shapes the narrow-phase supports. Contacts the shape moves
+ * away from or slides along are ignored, so a shape resting on another can
+ * be swept along its surface.
+ * @param registry Data source.
+ * @param shape Shape to be swept.
+ * @param pos Initial position of the shape.
+ * @param orn Orientation of the shape, which does not change during the
+ * sweep.
+ * @param displacement Translation applied to the shape.
+ * @param mask Only entities whose collision group shares a bit with this
+ * mask are hit. Entities without a `collision_filter` belong to all groups.
+ * @return Result.
+ */
+shape_sweep_result shape_sweep(entt::registry &registry, const query_shape_variant_t &shape,
+                               const vector3 &pos, const quaternion &orn,
+                               const vector3 &displacement,
+                               uint64_t mask = collision_filter::all_groups);
+
+/**
+ * @brief Finds all entities whose shape intersects the given shape.
+ * @param registry Data source.
+ * @param shape Query shape.
+ * @param pos Position of the shape.
+ * @param orn Orientation of the shape.
+ * @param entities Output entities. Previous contents are replaced.
+ * @param mask Only entities whose collision group shares a bit with this
+ * mask are considered.
+ */
+void shape_overlap(entt::registry &registry, const query_shape_variant_t &shape,
+                   const vector3 &pos, const quaternion &orn,
+                   std::vector<entt::entity> &entities,
+                   uint64_t mask = collision_filter::all_groups);
+
+}
+
+#endif // EDYN_COLLISION_SHAPE_QUERY_HPP
@@ -6,13 +6,166 @@
 #include <iterator>
 #include <numeric>
 #include <algorithm>
+#include <array>
 #include "edyn/collision/query_tree.hpp"
+#include "edyn/collision/wide_tree.hpp"
+#include "edyn/parallel/parallel_for.hpp"
+#include "edyn/parallel/worker.hpp"
 
 namespace edyn {
 
 constexpr uint32_t EDYN_NULL_NODE = UINT32_MAX;
 
+/**
+ * @brief Strategy used to split sets of AABBs when building a `static_tree`.
+ */
+enum class static_tree_build_mode {
+    // Sort along the longest axis and split at its center.
+    median,
+    // Binned surface area heuristic. Builds faster than `median` and produces
+    // trees which are cheaper to query, especially for uneven geometry.
+    sah,
+    // Same as `sah` with subtrees built in parallel in the global job
+    // dispatcher. Falls back to `sah` when called from a worker thread since
+    // waiting for jobs in a worker could cause a deadlock.
+    parallel_sah
+};
+
 namespace detail {
+    constexpr size_t sah_num_bins = 16;
+
+    // Minimum number of AABBs for a parallel build to be worthwhile and the
+    // minimum number of AABBs processed by each parallel job.
+    constexpr size_t sah_parallel_min_count = 4096;
+    constexpr size_t sah_parallel_min_task_size = 1024;
+
+    // Range of ids `[begin, end)` which will be in the subtree of a node.
+    struct sah_range {
+        uint32_t node;
+        uint32_t begin;
+        uint32_t end;
+        AABB aabb;
+    };
+
+    inline AABB sah_empty_aabb() {
+        return {vector3_one * EDYN_SCALAR_MAX, vector3_one * -EDYN_SCALAR_MAX};
+    }
+
+    inline size_t sah_bin_index(scalar pos, scalar min, scalar scale) {
+        auto idx = static_cast<size_t>((pos - min) * scale);
+        return std::min(idx, sah_num_bins - 1);
+    }
+
+    /**
+     * @brief Partitions a range of ids in two using the binned surface area
+     * heuristic. Centroids are assigned to bins of equal size along each
+     * axis and the split between bins with the lowest cost is chosen.
+     * @return Split position, which is always strictly inside the range.
+     */
+    template<typename Iterator_AABB>
+    uint32_t sah_partition(Iterator_AABB aabb_begin, const std::vector<vector3> &centroids,
+                           std::vector<uint32_t> &ids, uint32_t begin, uint32_t end,
+                           AABB &left_aabb, AABB &right_aabb) {
+        auto centroid_aabb = AABB{centroids[ids[begin]], centroids[ids[begin]]};
+
+        for (auto i = begin + 1; i < end; ++i) {
+            auto &centroid = centroids[ids[i]];
+            centroid_aabb.min = min(centroid_aabb.min, centroid);
+            centroid_aabb.max = max(centroid_aabb.max, centroid);
+        }
+
+        auto extent = centroid_aabb.max - centroid_aabb.min;
+        auto best_cost = EDYN_SCALAR_MAX;
+        auto best_axis = size_t{3};
+        auto best_bin = size_t{0};
+
+        // Bin along all axes in a single pass over the range.
+        std::array<std::array<AABB, sah_num_bins>, 3> bin_aabbs;
+        std::array<std::array<uint32_t, sah_num_bins>, 3> bin_counts {};
+        vector3 scale;
+
+        for (size_t axis = 0; axis < 3; ++axis) {
+            bin_aabbs[axis].fill(sah_empty_aabb());
+            scale[axis] = extent[axis] > EDYN_EPSILON ? scalar(sah_num_bins) / extent[axis] : scalar(0);
+        }
+
+        for (auto i = begin; i < end; ++i) {
+            auto id = ids[i];
+            auto &aabb = *(aabb_begin + id);
+
+            for (size_t axis = 0; axis < 3; ++axis) {
+                auto bin = sah_bin_index(centroids[id][axis], centroid_aabb.min[axis], scale[axis]);
+                bin_aabbs[axis][bin] = enclosing_aabb(bin_aabbs[axis][bin], aabb);
+                ++bin_counts[axis][bin];
+            }
+        }
+
+        for (size_t axis = 0; axis < 3; ++axis) {
+            if (!(extent[axis] > EDYN_EPSILON)) {
+                continue;
+            }
+
+            // Bounds and counts of the right side of a split after each bin.
+            std::array<AABB, sah_num_bins - 1> right_aabbs;
+            std::array<uint32_t, sah_num_bins - 1> right_counts;
+            auto accum_aabb = sah_empty_aabb();
+            auto accum_count = uint32_t{0};
+
+            for (auto bin = sah_num_bins - 1; bin > 0; --bin) {
+                accum_aabb = enclosing_aabb(accum_aabb, bin_aabbs[axis][bin]);
+                accum_count += bin_counts[axis][bin];
+                right_aabbs[bin - 1] = accum_aabb;
+                right_counts[bin - 1] = accum_count;
+            }
+
+            accum_aabb = sah_empty_aabb();
+            accum_count = 0;
+
+            for (size_t bin = 0; bin < sah_num_bins - 1; ++bin) {
+                accum_aabb = enclosing_aabb(accum_aabb, bin_aabbs[axis][bin]);
+                accum_count += bin_counts[axis][bin];
+
+                if (accum_count == 0 || right_counts[bin] == 0) {
+                    continue;
+                }
+
+                auto cost = accum_count * accum_aabb.area() + right_counts[bin] * right_aabbs[bin].area();
+
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_bin = bin;
+                    left_aabb = accum_aabb;
+                    right_aabb = right_aabbs[bin];
+                }
+            }
+        }
+
+        if (best_axis < 3) {
+            auto it = std::partition(ids.begin() + begin, ids.begin() + end, [&](uint32_t id) {
+                auto bin = sah_bin_index(centroids[id][best_axis], centroid_aabb.min[best_axis], scale[best_axis]);
+                return bin <= best_bin;
+            });
+            auto mid = static_cast<uint32_t>(std::distance(ids.begin(), it));
+            EDYN_ASSERT(mid > begin && mid < end);
+            return mid;
+        }
+
+        // All centroids are coincident. Split the range in half.
+        auto mid = begin + (end - begin) / 2;
+        left_aabb = right_aabb = sah_empty_aabb();
+
+        for (auto i = begin; i < mid; ++i) {
+            left_aabb = enclosing_aabb(left_aabb, *(aabb_begin + ids[i]));
+        }
+
+        for (auto i = mid; i < end; ++i) {
+            right_aabb = enclosing_aabb(right_aabb, *(aabb_begin + ids[i]));
+        }
+
+        return mid;
+    }
+
     template<typename Iterator_AABB, typename Iterator_ids>
     Iterator_ids aabb_set_partition(Iterator_AABB aabb_begin, Iterator_AABB aabb_end,
                                     Iterator_ids ids_begin, Iterator_ids ids_end,
@@ -76,10 +229,26 @@ public:
     template<typename Func>
     void raycast(vector3 p0, vector3 p1, Func func) const;
 
+    /**
+     * @brief Builds the tree from a set of AABBs.
+     * @param aabb_begin Random access iterator to the first AABB.
+     * @param aabb_end Random access iterator past the last AABB.
+     * @param report_leaf Called for each leaf node with the node and the
+     * range of indices of the AABBs which it contains.
+     * @param max_obj_per_leaf Maximum number of AABBs in a leaf node.
+     * @param mode How to split sets of AABBs.
+     */
     template<typename Iterator, typename Func>
-    void build(Iterator aabb_begin, Iterator aabb_end, Func &report_leaf, uint32_t max_obj_per_leaf = 1) {
+    void build(Iterator aabb_begin, Iterator aabb_end, Func &report_leaf, uint32_t max_obj_per_leaf = 1,
+               static_tree_build_mode mode = static_tree_build_mode::median) {
         EDYN_ASSERT(aabb_begin != aabb_end);
 
+        if (mode != static_tree_build_mode::median) {
+            build_sah(aabb_begin, aabb_end, report_leaf, max_obj_per_leaf,
+                      mode == static_tree_build_mode::parallel_sah);
+            return;
+        }
+
         auto count = std::distance(aabb_begin, aabb_end);
         std::vector<uint32_t> ids(count);
         std::iota(ids.begin(), ids.end(), 0);
@@ -89,6 +258,16 @@ public:
 
         recurse_build(aabb_begin, aabb_end, ids.begin(), ids.end(),
                       0, report_leaf, max_obj_per_leaf);
+
+        build_wide_tree();
+    }
+
+    /**
+     * @brief Collapses the binary tree into a 4-ary tree which is used for
+     * queries from then on. Called by `build` and after deserialization.
+     */
+    void build_wide_tree() {
+        m_wide_tree.build(*this, uint32_t{0}, EDYN_NULL_NODE);
     }
 
     template<typename Iterator_AABB, typename Iterator_ids, typename Func>
@@ -133,6 +312,7 @@ public:
 
     void clear() {
         m_nodes.clear();
+        m_wide_tree.clear();
     }
 
     template<typename Archive>
@@ -140,17 +320,176 @@ public:
     friend size_t serialization_sizeof(const static_tree &tree);
 
 private:
+    template<typename Iterator, typename Func>
+    void build_sah(Iterator aabb_begin, Iterator aabb_end, Func &report_leaf,
+                   uint32_t max_obj_per_leaf, bool parallel) {
+        auto count = static_cast<uint32_t>(std::distance(aabb_begin, aabb_end));
+        std::vector<uint32_t> ids(count);
+        std::iota(ids.begin(), ids.end(), 0);
+
+        std::vector<vector3> centroids(count);
+        auto root_aabb = *aabb_begin;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            auto &aabb = *(aabb_begin + i);
+            centroids[i] = aabb.center();
+            root_aabb = enclosing_aabb(root_aabb, aabb);
+        }
+
+        // Build the top of the tree in this thread and leave ranges smaller
+        // than the task size to be built in parallel.
+        auto &dispatcher = job_dispatcher::global();
+        auto num_workers = dispatcher.num_workers();
+        size_t max_task_size = 0;
+
+        if (parallel && num_workers > 0 && worker::current() == nullptr &&
+            count >= detail::sah_parallel_min_count) {
+            max_task_size = std::max(count / (4 * (num_workers + 1)), detail::sah_parallel_min_task_size);
+        }
+
+        std::vector<detail::sah_range> leaves;
+        std::vector<detail::sah_range> tasks;
+        m_nodes.emplace_back();
+        sah_build_subtree(aabb_begin, centroids, ids, {0, 0, count, root_aabb},
+                          max_obj_per_leaf, max_task_size, m_nodes, leaves, tasks);
+
+        if (!tasks.empty()) {
+            // Each task builds its subtree into a separate array of nodes
+            // where its root is at index zero. Tasks work on disjoint ranges
+            // of ids.
+            struct task_result {
+                std::vector<tree_node> nodes;
+                std::vector<detail::sah_range> leaves;
+            };
+            std::vector<task_result> results(tasks.size());
+
+            auto build_task = [&](size_t task_idx) {
+                auto &result = results[task_idx];
+                auto range = tasks[task_idx];
+                range.node = 0;
+                result.nodes.emplace_back();
+                std::vector<detail::sah_range> no_tasks;
+                sah_build_subtree(aabb_begin, centroids, ids, range, max_obj_per_leaf,
+                                  0, result.nodes, result.leaves, no_tasks);
+            };
+
+            if (tasks.size() > 1) {
+                parallel_for(size_t{0}, tasks.size(), build_task);
+            } else {
+                build_task(0);
+            }
+
+            // Move the subtrees into the main node array, replacing the task
+            // nodes by the subtree roots.
+            for (size_t task_idx = 0; task_idx < tasks.size(); ++task_idx) {
+                auto &result = results[task_idx];
+                auto base = static_cast<uint32_t>(m_nodes.size());
+                auto task_node = tasks[task_idx].node;
+                auto remap = [&](uint32_t local) {
+                    return local == 0 ? task_node : base + local - 1;
+                };
+
+                for (size_t local = 0; local < result.nodes.size(); ++local) {
+                    auto node = result.nodes[local];
+
+                    if (!node.leaf()) {
+                        node.child1 = remap(node.child1);
+                        node.child2 = remap(node.child2);
+                    }
+
+                    if (local == 0) {
+                        m_nodes[task_node] = node;
+                    } else {
+                        m_nodes.push_back(node);
+                    }
+                }
+
+                for (auto leaf : result.leaves) {
+                    leaf.node = remap(leaf.node);
+                    leaves.push_back(leaf);
+                }
+            }
+        }
+
+        for (auto &leaf : leaves) {
+            report_leaf(m_nodes[leaf.node], ids.begin() + leaf.begin, ids.begin() + leaf.end);
+        }
+
+        build_wide_tree();
+    }
+
+    // Splits the range of the root recursively, inserting nodes into `nodes`.
+    // Ranges with no more than `max_task_size` ids are not split and are
+    // inserted into `tasks` instead. Leaves are inserted into `leaves`.
+    template<typename Iterator_AABB>
+    static void sah_build_subtree(Iterator_AABB aabb_begin, const std::vector<vector3> &centroids,
+                                  std::vector<uint32_t> &ids, const detail::sah_range &root,
+                                  uint32_t max_obj_per_leaf, size_t max_task_size,
+                                  std::vector<tree_node> &nodes,
+                                  std::vector<detail::sah_range> &leaves,
+                                  std::vector<detail::sah_range> &tasks) {
+        // Use an explicit stack since trees built with the SAH can be deep.
+        std::vector<detail::sah_range> stack;
+        stack.push_back(root);
+
+        while (!stack.empty()) {
+            auto range = stack.back();
+            stack.pop_back();
+
+            nodes[range.node].aabb = range.aabb;
+            auto count = range.end - range.begin;
+
+            if (count <= max_obj_per_leaf) {
+                nodes[range.node].child1 = EDYN_NULL_NODE;
+                leaves.push_back(range);
+                continue;
+            }
+
+            if (count <= max_task_size) {
+                tasks.push_back(range);
+                continue;
+            }
+
+            AABB left_aabb, right_aabb;
+            auto mid = detail::sah_partition(aabb_begin, centroids, ids, range.begin, range.end,
+                                             left_aabb, right_aabb);
+
+            auto child1 = static_cast<uint32_t>(nodes.size());
+            auto child2 = child1 + 1;
+            nodes[range.node].child1 = child1;
+            nodes[range.node].child2 = child2;
+            nodes.emplace_back();
+            nodes.emplace_back();
+
+            // Push the second child first so the first child is processed
+            // next, which keeps siblings close in memory.
+            stack.push_back({child2, mid, range.end, right_aabb});
+            stack.push_back({child1, range.begin, mid, left_aabb});
+        }
+    }
+
     std::vector<tree_node> m_nodes;
+    wide_tree m_wide_tree;
 };
 
 template<typename Func>
 void static_tree::query(const AABB &aabb, Func func) const {
+    if (!m_wide_tree.empty()) {
+        m_wide_tree.query(aabb, func);
+        return;
+    }
+
     uint32_t root_node_idx = 0;
     query_tree(*this, root_node_idx, EDYN_NULL_NODE, aabb, func);
 }
 
 template<typename Func>
 void static_tree::raycast(vector3 p0, vector3 p1, Func func) const {
+    if (!m_wide_tree.empty()) {
+        m_wide_tree.raycast(p0, p1, func);
+        return;
+    }
+
     uint32_t root_node_idx = 0;
     raycast_tree(*this, root_node_idx, EDYN_NULL_NODE, p0, p1, func);
 }
@@ -60,6 +60,9 @@ public:
     template<typename Func>
     void raycast(vector3 p0, vector3 p1, Func func) const;
 
+    template<typename Func>
+    void raycast_packet(const ray_packet &packet, uint32_t mask, Func func) const;
+
     /**
      * @brief Calls the given function for each leaf node.
      * @tparam Func Type of the function object to invoke.
@@ -158,6 +161,11 @@ void tree_view::raycast(vector3 p0, vector3 p1, Func func) const {
     raycast_tree(*this, m_root, null_tree_node_id, p0, p1, func);
 }
 
+template<typename Func>
+void tree_view::raycast_packet(const ray_packet &packet, uint32_t mask, Func func) const {
+    raycast_tree_packet(*this, m_root, null_tree_node_id, packet, mask, func);
+}
+
 }
 
 #endif // EDYN_COLLISION_TREE_VIEW_HPP
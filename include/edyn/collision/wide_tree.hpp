@@ -0,0 +1,333 @@
+#ifndef EDYN_COLLISION_WIDE_TREE_HPP
+#define EDYN_COLLISION_WIDE_TREE_HPP
+
+#include <array>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include "edyn/comp/aabb.hpp"
+#include "edyn/math/scalar.hpp"
+#include "edyn/math/vector3.hpp"
+#include "edyn/config/config.h"
+#include "edyn/collision/ray_packet.hpp"
+
+namespace edyn {
+
+/**
+ * @brief A 4-ary bounding volume hierarchy obtained by collapsing a binary
+ * tree. The bounds of the children of each node are stored in a
+ * structure-of-arrays layout so all four of them are tested against a query
+ * at once. Leaves refer back to the leaf nodes of the source tree, thus query
+ * results are the same as those of the source tree.
+ */
+class wide_tree {
+public:
+    static constexpr size_t width = 4;
+    static constexpr uint32_t null_child = UINT32_MAX;
+    static constexpr uint32_t leaf_bit = UINT32_C(1) << 31;
+
+    struct node {
+        using lane_array = std::array<scalar, width>;
+        lane_array min_x, min_y, min_z;
+        lane_array max_x, max_y, max_z;
+
+        // Index of child node, or id of a leaf node in the source tree with
+        // `leaf_bit` set, or `null_child` for unused lanes.
+        std::array<uint32_t, width> child;
+    };
+
+    /**
+     * @brief Builds the wide tree from a binary tree. Every node of the wide
+     * tree takes up to four descendants of a node of the binary tree,
+     * repeatedly opening the internal node with the largest surface area.
+     * @param tree The binary tree. Must provide `get_node(id)` returning nodes
+     * with `aabb`, `child1`, `child2` and `leaf()`.
+     * @param root_id Id of the root node of the binary tree.
+     * @param null_node_id Id which represents an invalid node.
+     */
+    template<typename Tree, typename NodeIdType>
+    void build(const Tree &tree, NodeIdType root_id, NodeIdType null_node_id);
+
+    /**
+     * @brief Call `func` for all leaves whose AABB intersects `aabb`.
+     * @param aabb The query AABB.
+     * @param func Function taking the id of a leaf node of the source tree.
+     */
+    template<typename Func>
+    void query(const AABB &aabb, Func func) const;
+
+    /**
+     * @brief Call `func` for all leaves whose AABB intersects the segment
+     * [p0, p1].
+     * @param p0 First point in the segment.
+     * @param p1 Second point in the segment.
+     * @param func Function taking the id of a leaf node of the source tree.
+     */
+    template<typename Func>
+    void raycast(const vector3 &p0, const vector3 &p1, Func func) const;
+
+    /**
+     * @brief Call `func` for all leaves whose AABB intersects any of the rays
+     * in the packet. See `raycast_tree_packet`.
+     * @param packet The ray packet.
+     * @param mask Set of rays of the packet to traverse with.
+     * @param func Function taking the id of a leaf node of the source tree
+     * and the set of rays that intersect it.
+     */
+    template<typename Func>
+    void raycast_packet(const ray_packet &packet, uint32_t mask, Func func) const;
+
+    void clear() {
+        m_nodes.clear();
+    }
+
+    bool empty() const {
+        return m_nodes.empty();
+    }
+
+private:
+    template<typename MaskFunc, typename Func>
+    void traverse(MaskFunc mask_func, Func func) const;
+
+    // Bit mask of the lanes of `node` whose AABB intersects `aabb`. The
+    // loops are over lanes of contiguous arrays without branches, thus they
+    // map directly to SIMD instructions.
+    static unsigned overlap_mask(const node &node, const AABB &aabb) {
+        unsigned mask = 0;
+
+        for (size_t l = 0; l < width; ++l) {
+            auto hit = (node.min_x[l] <= aabb.max.x) & (node.max_x[l] >= aabb.min.x) &
+                       (node.min_y[l] <= aabb.max.y) & (node.max_y[l] >= aabb.min.y) &
+                       (node.min_z[l] <= aabb.max.z) & (node.max_z[l] >= aabb.min.z);
+            mask |= static_cast<unsigned>(hit) << l;
+        }
+
+        return mask;
+    }
+
+    // Lane-wise equivalent of `intersect_segment_aabb`.
+    static unsigned segment_mask(const node &node, const vector3 &midpoint,
+                                 const vector3 &half_length, const vector3 &abs_half_length) {
+        auto abs_half_length_eps = abs_half_length + vector3_one * EDYN_EPSILON;
+        unsigned mask = 0;
+
+        for (size_t l = 0; l < width; ++l) {
+            auto cx = (node.min_x[l] + node.max_x[l]) * scalar(0.5);
+            auto cy = (node.min_y[l] + node.max_y[l]) * scalar(0.5);
+            auto cz = (node.min_z[l] + node.max_z[l]) * scalar(0.5);
+            auto ex = node.max_x[l] - cx;
+            auto ey = node.max_y[l] - cy;
+            auto ez = node.max_z[l] - cz;
+            auto mx = midpoint.x - cx;
+            auto my = midpoint.y - cy;
+            auto mz = midpoint.z - cz;
+
+            auto separated =
+                (std::abs(mx) > ex + abs_half_length.x) |
+                (std::abs(my) > ey + abs_half_length.y) |
+                (std::abs(mz) > ez + abs_half_length.z) |
+                (std::abs(my * half_length.z - mz * half_length.y) > ey * abs_half_length_eps.z + ez * abs_half_length_eps.y) |
+                (std::abs(mz * half_length.x - mx * half_length.z) > ez * abs_half_length_eps.x + ex * abs_half_length_eps.z) |
+                (std::abs(mx * half_length.y - my * half_length.x) > ex * abs_half_length_eps.y + ey * abs_half_length_eps.x);
+            mask |= static_cast<unsigned>(!separated) << l;
+        }
+
+        return mask;
+    }
+
+    std::vector<node> m_nodes;
+};
+
+template<typename Tree, typename NodeIdType>
+void wide_tree::build(const Tree &tree, NodeIdType root_id, NodeIdType null_node_id) {
+    m_nodes.clear();
+
+    if (root_id == null_node_id) {
+        return;
+    }
+
+    // Pairs of wide node index and the source node it's collapsed from.
+    std::vector<std::pair<uint32_t, NodeIdType>> stack;
+    m_nodes.emplace_back();
+    stack.emplace_back(0, root_id);
+
+    while (!stack.empty()) {
+        auto [wide_idx, source_id] = stack.back();
+        stack.pop_back();
+
+        std::array<NodeIdType, width> ids;
+        ids[0] = source_id;
+        size_t count = 1;
+
+        while (count < width) {
+            auto best_idx = width;
+            auto best_area = scalar(-1);
+
+            for (size_t i = 0; i < count; ++i) {
+                auto &source_node = tree.get_node(ids[i]);
+
+                if (!source_node.leaf()) {
+                    auto area = source_node.aabb.area();
+
+                    if (area > best_area) {
+                        best_area = area;
+                        best_idx = i;
+                    }
+                }
+            }
+
+            if (best_idx == width) {
+                break;
+            }
+
+            auto &source_node = tree.get_node(ids[best_idx]);
+            EDYN_ASSERT(source_node.child1 != null_node_id && source_node.child2 != null_node_id);
+            ids[best_idx] = source_node.child1;
+            ids[count++] = source_node.child2;
+        }
+
+        for (size_t l = 0; l < width; ++l) {
+            auto &wide_node = m_nodes[wide_idx];
+
+            if (l >= count) {
+                wide_node.min_x[l] = wide_node.min_y[l] = wide_node.min_z[l] = 0;
+                wide_node.max_x[l] = wide_node.max_y[l] = wide_node.max_z[l] = 0;
+                wide_node.child[l] = null_child;
+                continue;
+            }
+
+            auto &source_node = tree.get_node(ids[l]);
+            wide_node.min_x[l] = source_node.aabb.min.x;
+            wide_node.min_y[l] = source_node.aabb.min.y;
+            wide_node.min_z[l] = source_node.aabb.min.z;
+            wide_node.max_x[l] = source_node.aabb.max.x;
+            wide_node.max_y[l] = source_node.aabb.max.y;
+            wide_node.max_z[l] = source_node.aabb.max.z;
+
+            if (source_node.leaf()) {
+                EDYN_ASSERT((static_cast<uint32_t>(ids[l]) & leaf_bit) == 0);
+                wide_node.child[l] = static_cast<uint32_t>(ids[l]) | leaf_bit;
+            } else {
+                auto child_idx = static_cast<uint32_t>(m_nodes.size());
+                wide_node.child[l] = child_idx;
+                stack.emplace_back(child_idx, ids[l]);
+                // Invalidates `wide_node`, which is fetched again in the
+                // next iteration.
+                m_nodes.emplace_back();
+            }
+        }
+    }
+}
+
+template<typename MaskFunc, typename Func>
+void wide_tree::traverse(MaskFunc mask_func, Func func) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    std::vector<uint32_t> stack;
+    stack.push_back(0);
+
+    while (!stack.empty()) {
+        auto &node = m_nodes[stack.back()];
+        stack.pop_back();
+
+        auto mask = mask_func(node);
+
+        for (size_t l = 0; l < width; ++l) {
+            auto child = node.child[l];
+
+            if ((mask & (1u << l)) == 0 || child == null_child) {
+                continue;
+            }
+
+            if (child & leaf_bit) {
+                func(child & ~leaf_bit);
+            } else {
+                stack.push_back(child);
+            }
+        }
+    }
+}
+
+template<typename Func>
+void wide_tree::query(const AABB &aabb, Func func) const {
+    traverse([&](const node &node) {
+        return overlap_mask(node, aabb);
+    }, func);
+}
+
+template<typename Func>
+void wide_tree::raycast(const vector3 &p0, const vector3 &p1, Func func) const {
+    auto midpoint = (p0 + p1) * scalar(0.5);
+    auto half_length = p1 - midpoint;
+    auto abs_half_length = abs(half_length);
+
+    traverse([&](const node &node) {
+        return segment_mask(node, midpoint, half_length, abs_half_length);
+    }, func);
+}
+
+template<typename Func>
+void wide_tree::raycast_packet(const ray_packet &packet, uint32_t mask, Func func) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    stack.emplace_back(0, mask);
+
+    while (!stack.empty()) {
+        auto [node_idx, node_mask] = stack.back();
+        stack.pop_back();
+
+        node_mask &= packet.active;
+
+        if (node_mask == 0) {
+            continue;
+        }
+
+        auto &node = m_nodes[node_idx];
+
+        // Discard lanes which are not hit by the packet as a whole first.
+        auto packet_lanes = overlap_mask(node, packet.bounds);
+
+        if (packet_lanes == 0) {
+            continue;
+        }
+
+        // Rays which intersect each lane.
+        std::array<uint32_t, width> lane_masks {};
+
+        for (auto m = node_mask; m != 0; m &= m - 1) {
+            auto i = ray_packet::lowest_bit_index(m);
+            auto midpoint = (packet.p0[i] + packet.p1[i]) * scalar(0.5);
+            auto half_length = packet.p1[i] - midpoint;
+            auto lanes = segment_mask(node, midpoint, half_length, abs(half_length)) & packet_lanes;
+
+            for (size_t l = 0; l < width; ++l) {
+                lane_masks[l] |= static_cast<uint32_t>((lanes >> l) & 1) << i;
+            }
+        }
+
+        for (size_t l = 0; l < width; ++l) {
+            auto child = node.child[l];
+
+            if (lane_masks[l] == 0 || child == null_child) {
+                continue;
+            }
+
+            if (child & leaf_bit) {
+                func(child & ~leaf_bit, lane_masks[l]);
+            } else {
+                stack.emplace_back(child, lane_masks[l]);
+            }
+        }
+    }
+}
+
+}
+
+#endif // EDYN_COLLISION_WIDE_TREE_HPP
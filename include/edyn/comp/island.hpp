@@ -4,6 +4,7 @@
 #include <entt/entity/fwd.hpp>
 #include <entt/entity/entity.hpp>
 #include <entt/entity/sparse_set.hpp>
+#include "edyn/math/scalar.hpp"
 
 namespace edyn {
 
@@ -23,6 +24,25 @@ struct island_timestamp {
     double value;
 };
 
+/**
+ * @brief Statistics of the constraint solver in the last step of an island.
+ */
+struct island_solver_stats {
+    // Number of constraint rows.
+    unsigned num_rows {0};
+
+    // Number of velocity iterations performed.
+    unsigned num_iterations {0};
+
+    // Maximum number of velocity iterations allowed, which is adjusted over
+    // time when adaptive solver iterations are enabled.
+    unsigned iteration_budget {0};
+
+    // Largest change in relative velocity caused by a constraint row in the
+    // last iteration. It approaches zero as the solver converges.
+    scalar residual {0};
+};
+
 /**
  * @brief Component assigned to an entity that resides in an island, i.e.
  * procedural entities which can only be present in a single island.
@@ -45,6 +65,14 @@ void serialize(Archive &archive, island_timestamp &timestamp) {
     archive(timestamp.value);
 }
 
+template<typename Archive>
+void serialize(Archive &archive, island_solver_stats &stats) {
+    archive(stats.num_rows);
+    archive(stats.num_iterations);
+    archive(stats.iteration_budget);
+    archive(stats.residual);
+}
+
 }
 
 #endif // EDYN_COMP_ISLAND_HPP
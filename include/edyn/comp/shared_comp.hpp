@@ -35,6 +35,7 @@ namespace edyn {
  */
 using shared_components_t = decltype(std::tuple_cat(std::tuple<
     island_timestamp,
+    island_solver_stats,
     AABB,
     collision_filter,
     collision_exclusion,
@@ -68,6 +69,7 @@ using shared_components_t = decltype(std::tuple_cat(std::tuple<
     rigidbody_tag,
     rolling_tag,
     roll_direction,
+    ccd_tag,
     tree_view,
     discontinuity
 >{}, constraints_tuple, shapes_tuple)); // Concatenate with all shapes and constraints at the end.
@@ -62,6 +62,19 @@ struct continuous_contacts_tag {};
  */
 struct rolling_tag {};
 
+/**
+ * A rigid body with continuous collision detection enabled. Its AABB is swept
+ * along its velocity and speculative contact points are created ahead of time
+ * with the bodies in its path, which prevents it from tunneling through them
+ * at high speeds or large time steps.
+ * @remark Speculative points can be as far from the surface as the body moves
+ * in one step, thus contact started and contact point created events are
+ * triggered before the bodies touch, and for bodies that pass close to one
+ * another, even though they never touch. Check the `distance` of the contact
+ * points to find out whether the bodies are actually touching.
+ */
+struct ccd_tag {};
+
 /**
  * An entity that was created externally and tagged via
  * `edyn::tag_external_entity` (i.e. it doesn't represent any of the internal
@@ -56,6 +56,14 @@ inline constexpr auto island_time_to_sleep = scalar(2);
  */
 inline constexpr auto support_feature_tolerance = scalar(0.005);
 
+/**
+ * Collision detection between polyhedra where either has at least this many
+ * vertices finds support points by hill climbing over the vertex adjacency
+ * and prunes pairs of edges using their Gauss maps, instead of projecting all
+ * vertices and testing all pairs of unique edge directions.
+ */
+inline constexpr size_t large_polyhedron_min_vertices = 32;
+
 /**
  * Error correction rate when solving contact position constraints.
  */
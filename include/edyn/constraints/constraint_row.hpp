@@ -2,14 +2,27 @@
 #define EDYN_COMP_CONSTRAINT_ROW_HPP
 
 #include <array>
+#include <cstdint>
 #include "edyn/math/vector3.hpp"
 #include "edyn/math/matrix3x3.hpp"
 #include "edyn/config/constants.hpp"
 
 namespace edyn {
 
-struct delta_linvel;
-struct delta_angvel;
+/**
+ * State of a rigid body that's accessed in the constraint solver iterations.
+ * The bodies involved in one solver update are stored contiguously and rows
+ * refer to them by index, which avoids chasing pointers into component pools.
+ */
+struct solver_body {
+    // Delta velocities accumulated during the solver iterations.
+    vector3 dv;
+    vector3 dw;
+
+    // Inverse mass and world-space inverse inertia.
+    scalar inv_m;
+    matrix3x3 inv_I;
+};
 
 /**
  * `constraint_row` contains all and only the information that's required
@@ -26,6 +39,13 @@ struct constraint_row {
     // Right hand side Jv + bias.
     scalar rhs;
 
+    // Position error in velocity units and error reduction parameter the bias
+    // in `rhs` was calculated with. The sub-stepping solver recalculates the
+    // bias as bodies move. The erp is zero for rows without position error,
+    // including rows driven at their limits with an error of `large_scalar`.
+    scalar error {0};
+    scalar erp {0};
+
     // Lower and upper limit of impulses to be applied while solving constraints.
     scalar lower_limit;
     scalar upper_limit;
@@ -34,14 +54,9 @@ struct constraint_row {
     // strength of impulse applied.
     scalar impulse;
 
-    // Inverse masses and inertias used during the solver iterations.
-    scalar inv_mA, inv_mB;
-    matrix3x3 inv_IA, inv_IB;
-
-    // Reference to delta velocities used during solver iterations. It is not
-    // safe to dereference these outside of the solver update context.
-    delta_linvel *dvA, *dvB;
-    delta_angvel *dwA, *dwB;
+    // Index of the bodies in the array of solver bodies of the current update,
+    // i.e. `row_cache::bodies`.
+    uint32_t bodyA, bodyB;
 };
 
 /**
@@ -22,6 +22,7 @@ void serialize(Archive &archive, contact_constraint &c) {
 }
 
 struct constraint_row;
+struct solver_body;
 
 namespace internal {
     struct contact_friction_row {
@@ -53,7 +54,8 @@ namespace internal {
         size_t row_count_start_index;
     };
 
-    void solve_friction_row_pair(internal::contact_friction_row_pair &friction_row_pair, constraint_row &normal_row);
+    void solve_friction_row_pair(internal::contact_friction_row_pair &friction_row_pair, constraint_row &normal_row,
+                                 std::vector<solver_body> &bodies);
 }
 
 template<>
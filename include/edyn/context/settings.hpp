@@ -26,9 +26,45 @@ struct settings {
 
     unsigned num_solver_velocity_iterations {8};
     unsigned num_solver_position_iterations {3};
+
+    // Stop the velocity iterations of an island once the largest change in
+    // relative velocity caused by any constraint row in an iteration is below
+    // `solver_convergence_tolerance`, after at least
+    // `min_solver_velocity_iterations`. Islands which do not converge within
+    // their budget get more iterations in the following steps, up to
+    // `max_solver_velocity_iterations`, and then return gradually to
+    // `num_solver_velocity_iterations` once they converge.
+    bool adaptive_solver_iterations {false};
+    scalar solver_convergence_tolerance {scalar(0.001)};
+    unsigned min_solver_velocity_iterations {2};
+    unsigned max_solver_velocity_iterations {32};
+
     unsigned num_restitution_iterations {8};
     unsigned num_individual_restitution_iterations {3};
 
+    // Solve independent constraint rows in SIMD batches.
+    bool solver_row_batching {false};
+
+    // Solve rows of islands with at least this many rows in parallel using
+    // graph coloring. Zero disables it, which is the default. Rows are solved
+    // in a different order, thus results differ from the sequential solver.
+    unsigned parallel_solver_row_threshold {0};
+
+    // Split the velocity solve of islands with at least
+    // `solver_substep_row_threshold` rows into this many substeps. The rows
+    // are prepared once and, after each substep, the bodies are moved and the
+    // position error of each row is updated with the displacement along its
+    // Jacobian. The velocity iterations are distributed among the substeps
+    // and each substep ends with one relaxation iteration. One disables it.
+    unsigned num_solver_substeps {1};
+    unsigned solver_substep_row_threshold {0};
+
+    // Only send AABBs and contact manifolds of awake entities from island
+    // workers to the coordinator if they changed by more than the tolerance
+    // since they were last sent, instead of sending all of them every step.
+    bool incremental_island_sync {false};
+    scalar island_sync_tolerance {scalar(0.001)};
+
     make_reg_op_builder_func_t make_reg_op_builder {&make_reg_op_builder_default};
     std::shared_ptr<component_index_source> index_source;
     external_system_func_t external_system_init {nullptr};
@@ -0,0 +1,87 @@
+#ifndef EDYN_DYNAMICS_PARALLEL_ROW_SOLVER_HPP
+#define EDYN_DYNAMICS_PARALLEL_ROW_SOLVER_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "edyn/math/scalar.hpp"
+
+namespace edyn {
+
+struct constraint_row;
+struct solver_body;
+class job_dispatcher;
+
+namespace detail {
+    struct parallel_color_context;
+}
+
+/**
+ * Partitions the constraint rows of an island into colors where no two rows
+ * of the same color act on the same dynamic rigid body and solves all rows of
+ * one color in parallel, with a barrier in between colors. This results in a
+ * Gauss-Seidel iteration which is equivalent to the sequential one under a
+ * different row ordering.
+ */
+class parallel_row_solver {
+public:
+    /**
+     * @brief Maximum number of colors. Rows which cannot be assigned a color
+     * are solved sequentially after all colors.
+     */
+    static constexpr size_t max_colors = 64;
+
+    parallel_row_solver() = default;
+    parallel_row_solver(const parallel_row_solver &) = delete;
+    parallel_row_solver & operator=(const parallel_row_solver &) = delete;
+    ~parallel_row_solver();
+
+    /**
+     * @brief Assigns a color to each row. The rows must remain alive and in
+     * place until `clear()`.
+     * @param rows Prepared and warm-started constraint rows.
+     * @param bodies Solver bodies the rows refer to.
+     */
+    void build(std::vector<constraint_row> &rows, const std::vector<solver_body> &bodies);
+
+    /**
+     * @brief Runs one Gauss-Seidel iteration over all rows, one color at a
+     * time, splitting the rows of each color among the workers of the given
+     * dispatcher. Blocks until all rows are solved.
+     * @param dispatcher Dispatcher where parallel jobs will be run.
+     * @param bodies Solver bodies the rows refer to.
+     * @return Largest residual among all rows, as in `get_row_residual`.
+     */
+    scalar solve(job_dispatcher &dispatcher, std::vector<solver_body> &bodies);
+
+    void clear();
+
+    size_t num_colors() const {
+        return m_color_offsets.empty() ? 0 : m_color_offsets.size() - 1;
+    }
+
+private:
+    // Rows sorted by color.
+    std::vector<constraint_row *> m_rows;
+
+    // Index of the first row of each color in `m_rows`, plus one past the
+    // end. The last range contains the uncolored rows.
+    std::vector<size_t> m_color_offsets;
+
+    // Colors taken by each solver body during construction, as a bitset.
+    std::vector<uint64_t> m_body_colors;
+    std::vector<uint8_t> m_row_colors;
+
+    // Shared with the jobs which solve rows in parallel. It is created once
+    // and reused for all colors of all iterations. Jobs which start late hold
+    // a reference to it, thus it is deleted by whoever releases it last.
+    detail::parallel_color_context *m_context {nullptr};
+
+    // Incremented for every color solved in parallel. Jobs only take rows of
+    // the color they were dispatched for.
+    uint32_t m_generation {0};
+};
+
+}
+
+#endif // EDYN_DYNAMICS_PARALLEL_ROW_SOLVER_HPP
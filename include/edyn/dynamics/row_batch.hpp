@@ -0,0 +1,98 @@
+#ifndef EDYN_DYNAMICS_ROW_BATCH_HPP
+#define EDYN_DYNAMICS_ROW_BATCH_HPP
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "edyn/math/scalar.hpp"
+
+namespace edyn {
+
+struct constraint_row;
+struct solver_body;
+
+/**
+ * Number of rows solved simultaneously in a batch. Matches the number of
+ * scalars that fit in a SIMD register of the target architecture.
+ */
+#if defined(__AVX__) && !EDYN_DOUBLE_PRECISION
+inline constexpr size_t row_batch_width = 8;
+#else
+inline constexpr size_t row_batch_width = 4;
+#endif
+
+/**
+ * A group of constraint rows in a structure-of-arrays layout where each row
+ * occupies one lane. No two rows in a batch act on the same dynamic rigid body
+ * thus all lanes can be solved at once without write conflicts.
+ */
+struct alignas(32) constraint_row_batch {
+    using lane_array = std::array<scalar, row_batch_width>;
+    using vector_lanes = std::array<lane_array, 3>;
+
+    // Jacobian diagonals, where `J[i][c][l]` is the component `c` of the
+    // i-th Jacobian vector of the row in lane `l`.
+    std::array<vector_lanes, 4> J;
+
+    // Inverse mass and inertia premultiplied by the Jacobian, i.e. M^-1 J^T,
+    // which is all that's needed to apply impulses.
+    std::array<vector_lanes, 4> MJ;
+
+    lane_array eff_mass;
+    lane_array rhs;
+    lane_array lower_limit;
+    lane_array upper_limit;
+    lane_array impulse;
+
+    // Source row of each lane. Limits and rhs are read from and impulses are
+    // written back into it so constraint iteration logic keeps working on
+    // rows. Null for padding lanes.
+    std::array<constraint_row *, row_batch_width> rows;
+
+    // Index of the solver bodies of each lane.
+    std::array<uint32_t, row_batch_width> bodyA, bodyB;
+
+    size_t num_rows;
+};
+
+/**
+ * Packs the constraint rows of one solver update into batches of independent
+ * rows and solves them one batch at a time.
+ */
+class row_batch_cache {
+public:
+    /**
+     * @brief Assigns rows to batches using a greedy coloring where a row goes
+     * into the first open batch which does not contain any of its dynamic
+     * bodies. The rows must remain alive and in place until `clear()`.
+     * @param rows Prepared and warm-started constraint rows.
+     * @param bodies Solver bodies the rows refer to.
+     */
+    void build(std::vector<constraint_row> &rows, const std::vector<solver_body> &bodies);
+
+    /**
+     * @brief Runs one Gauss-Seidel iteration over all batches. Limits and
+     * right hand sides are loaded from the source rows before solving and the accumulated impulses
+     * are stored back into them afterwards.
+     * @param bodies Solver bodies the rows refer to.
+     * @return Largest residual among all rows, as in `get_row_residual`.
+     */
+    scalar solve(std::vector<solver_body> &bodies);
+
+    void clear();
+
+    size_t size() const {
+        return m_batches.size();
+    }
+
+private:
+    std::vector<constraint_row_batch> m_batches;
+
+    // Dynamic bodies referenced by each batch during construction.
+    std::vector<std::array<uint32_t, 2 * row_batch_width>> m_batch_bodies;
+};
+
+}
+
+#endif // EDYN_DYNAMICS_ROW_BATCH_HPP
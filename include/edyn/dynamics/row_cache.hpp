@@ -3,6 +3,11 @@
 
 #include <vector>
 #include <tuple>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <entt/entity/entity.hpp>
+#include "edyn/config/config.h"
 #include "edyn/constraints/constraint_row.hpp"
 
 namespace edyn {
@@ -11,11 +16,46 @@ namespace edyn {
  * Stores the constraint rows for one solver update.
  */
 struct row_cache {
+    static constexpr auto invalid_body_index = std::numeric_limits<uint32_t>::max();
 
     void clear() {
         // Clear caches and keep capacity.
         rows.clear();
         con_num_rows.clear();
+        bodies.clear();
+        std::fill(body_indices.begin(), body_indices.end(), invalid_body_index);
+    }
+
+    /**
+     * @brief Inserts the state of a rigid body into the array of solver bodies.
+     * @param entity The rigid body entity.
+     * @param body Initial solver state.
+     * @return Index of the new solver body.
+     */
+    uint32_t insert_body(entt::entity entity, const solver_body &body) {
+        auto entity_idx = static_cast<size_t>(entt::to_entity(entity));
+
+        if (entity_idx >= body_indices.size()) {
+            body_indices.resize(entity_idx + 1, invalid_body_index);
+        }
+
+        auto index = static_cast<uint32_t>(bodies.size());
+        body_indices[entity_idx] = index;
+        bodies.push_back(body);
+        return index;
+    }
+
+    /**
+     * @brief Get index of the solver body of a rigid body, which must have
+     * been previously inserted with `insert_body`.
+     * @param entity The rigid body entity.
+     * @return Index into `bodies`.
+     */
+    uint32_t body_index(entt::entity entity) const {
+        auto entity_idx = static_cast<size_t>(entt::to_entity(entity));
+        EDYN_ASSERT(entity_idx < body_indices.size());
+        EDYN_ASSERT(body_indices[entity_idx] != invalid_body_index);
+        return body_indices[entity_idx];
     }
 
     std::vector<constraint_row> rows;
@@ -24,6 +64,13 @@ struct row_cache {
     // as in the pool of each constraint type and ordered by the order which
     // the constraint types appear in the `constraints_tuple`.
     std::vector<size_t> con_num_rows;
+
+    // Velocity state of all rigid bodies in this update, which constraint
+    // rows refer to by index.
+    std::vector<solver_body> bodies;
+
+    // Maps the entity index of a rigid body to its index in `bodies`.
+    std::vector<uint32_t> body_indices;
 };
 
 }
@@ -1,14 +1,29 @@
 #ifndef EDYN_DYNAMICS_SOLVER_HPP
 #define EDYN_DYNAMICS_SOLVER_HPP
 
+#include <cmath>
 #include <vector>
 #include <entt/entity/fwd.hpp>
 #include "edyn/math/scalar.hpp"
+#include "edyn/comp/island.hpp"
 #include "edyn/dynamics/row_cache.hpp"
+#include "edyn/dynamics/row_batch.hpp"
+#include "edyn/dynamics/parallel_row_solver.hpp"
 
 namespace edyn {
 
-scalar solve(constraint_row &row);
+scalar solve(constraint_row &row, const std::vector<solver_body> &bodies);
+
+/**
+ * @brief Change in relative velocity caused by an impulse applied to a row.
+ * The largest residual in a solver iteration is used to measure convergence.
+ * @param delta_impulse Impulse applied to the row.
+ * @param eff_mass Effective mass of the row.
+ * @return Magnitude of velocity change.
+ */
+inline scalar get_row_residual(scalar delta_impulse, scalar eff_mass) {
+    return eff_mass > 0 ? std::abs(delta_impulse) / eff_mass : scalar(0);
+}
 
 class solver {
 public:
@@ -17,9 +32,35 @@ public:
 
     void update(scalar dt);
 
+    const island_solver_stats & stats() const {
+        return m_stats;
+    }
+
 private:
+    scalar solve_iteration(bool solve_parallel);
+    void solve_substeps(unsigned num_substeps, bool solve_parallel, scalar dt);
+
+    // Velocity of a solver body at the start of the step and displacement
+    // accumulated over the substeps.
+    struct substep_body {
+        vector3 linvel;
+        vector3 angvel;
+        vector3 linear_displacement;
+        vector3 angular_displacement;
+    };
+
     entt::registry *m_registry;
     row_cache m_row_cache;
+    row_batch_cache m_row_batches;
+    parallel_row_solver m_parallel_rows;
+    std::vector<substep_body> m_substep_bodies;
+
+    // Maximum number of velocity iterations in adaptive mode.
+    unsigned m_iteration_budget {0};
+    island_solver_stats m_stats;
+
+    // Right hand side of each row without the position error bias.
+    std::vector<scalar> m_substep_rhs;
 };
 
 }
@@ -22,6 +22,7 @@
 #include "util/ragdoll.hpp"
 #include "util/constraint_util.hpp"
 #include "util/shape_util.hpp"
+#include "util/convex_hull.hpp"
 #include "util/shape_volume.hpp"
 #include "util/tuple_util.hpp"
 #include "util/exclude_collision.hpp"
@@ -39,6 +40,7 @@
 #include "collision/contact_manifold_map.hpp"
 #include "context/settings.hpp"
 #include "collision/raycast.hpp"
+#include "collision/shape_query.hpp"
 #include <entt/entity/registry.hpp>
 
 namespace edyn {
@@ -303,7 +305,9 @@ entt::entity get_manifold_entity(const entt::registry &registry, entity_pair ent
  * @brief Signal triggered when a contact starts.
  * A contact is considered to start when the first contact point is added to a
  * manifold, i.e. when the number of points in a manifold becomes greater than
- * zero.
+ * zero. Points are added slightly before the bodies touch, or up to a whole
+ * step ahead for bodies with continuous collision detection (`ccd_tag`), which
+ * might never touch. The distance of the contact points tells whether they do.
  * @param registry Data source.
  * @return Sink to observe contact started events.
  */
@@ -401,6 +405,33 @@ unsigned get_solver_position_iterations(const entt::registry &registry);
  */
 void set_solver_position_iterations(entt::registry &registry, unsigned iterations);
 
+/**
+ * @brief Checks whether islands stop solver velocity iterations once they
+ * converge and adjust their own iteration budget.
+ * @param registry Data source.
+ * @return Whether adaptive solver iterations are enabled.
+ */
+bool get_solver_adaptive_iterations(const entt::registry &registry);
+
+/**
+ * @brief Enables or disables adaptive solver iterations. Each island stops
+ * iterating once the largest change in relative velocity caused by any
+ * constraint row in an iteration falls below the tolerance. Islands which do
+ * not converge get more iterations in the following steps, up to the maximum.
+ * The solver statistics of each island are available in the
+ * `edyn::island_solver_stats` component of the island entities.
+ * @param registry Data source.
+ * @param enabled Whether to use adaptive iterations.
+ * @param tolerance Velocity change under which the solver is considered to
+ * have converged.
+ * @param min_iterations Minimum number of velocity iterations.
+ * @param max_iterations Maximum number of velocity iterations.
+ */
+void set_solver_adaptive_iterations(entt::registry &registry, bool enabled,
+                                    scalar tolerance = scalar(0.001),
+                                    unsigned min_iterations = 2,
+                                    unsigned max_iterations = 32);
+
 /**
  * @brief Get the number of restitution iterations.
  * @param registry Data source.
@@ -433,6 +464,97 @@ unsigned get_solver_individual_restitution_iterations(const entt::registry &regi
  */
 void set_solver_individual_restitution_iterations(entt::registry &registry, unsigned iterations);
 
+/**
+ * @brief Checks whether constraint rows are solved in SIMD batches.
+ * @param registry Data source.
+ * @return Whether row batching is enabled.
+ */
+bool get_solver_row_batching(const entt::registry &registry);
+
+/**
+ * @brief Enables or disables solving constraint rows in SIMD batches. Rows
+ * are grouped into batches where no two rows affect the same rigid body, which
+ * are then solved simultaneously. This mostly benefits large islands with a
+ * high number of contacts.
+ * @param registry Data source.
+ * @param enabled Whether to use row batching.
+ */
+void set_solver_row_batching(entt::registry &registry, bool enabled);
+
+/**
+ * @brief Get the minimum number of constraint rows in an island for it to be
+ * solved in parallel.
+ * @param registry Data source.
+ * @return Row count threshold. Zero means disabled.
+ */
+unsigned get_solver_parallel_row_threshold(const entt::registry &registry);
+
+/**
+ * @brief Set the minimum number of constraint rows in an island for its rows
+ * to be partitioned into independent sets by graph coloring and solved in
+ * parallel in the worker threads.
+ * @param registry Data source.
+ * @param threshold Row count threshold. Set to zero to disable.
+ */
+void set_solver_parallel_row_threshold(entt::registry &registry, unsigned threshold);
+
+/**
+ * @brief Get the number of substeps the constraint solver splits a step into.
+ * @param registry Data source.
+ * @return Number of solver substeps. One means disabled.
+ */
+unsigned get_solver_substeps(const entt::registry &registry);
+
+/**
+ * @brief Set the number of substeps the constraint solver splits a step into.
+ * Constraints are prepared once per step and the bodies are moved after each
+ * substep, which updates the position error of the constraints before the
+ * next substep. The velocity iterations are distributed among the substeps.
+ * This improves the stability of tall stacks and long chains for less than
+ * the cost of adding iterations.
+ * @param registry Data source.
+ * @param substeps Number of substeps. Set to one to disable.
+ * @param row_threshold Minimum number of constraint rows in an island for it
+ * to be sub-stepped.
+ */
+void set_solver_substeps(entt::registry &registry, unsigned substeps, unsigned row_threshold = 0);
+
+/**
+ * @brief Check whether island workers only synchronize the AABBs and contact
+ * manifolds which have changed with the main registry.
+ * @param registry Data source.
+ * @return Whether incremental island synchronization is enabled.
+ */
+bool get_incremental_island_sync(const entt::registry &registry);
+
+/**
+ * @brief Enable or disable incremental island synchronization. When enabled,
+ * AABBs and contact manifolds of awake entities are only sent from island
+ * workers to the main registry after they change by more than the island sync
+ * tolerance, which reduces the amount of data that has to be processed in the
+ * main thread when there are many rigid bodies.
+ * @param registry Data source.
+ * @param enabled Whether to use incremental island synchronization.
+ */
+void set_incremental_island_sync(entt::registry &registry, bool enabled);
+
+/**
+ * @brief Get the tolerance used in incremental island synchronization.
+ * @param registry Data source.
+ * @return Tolerance distance.
+ */
+scalar get_island_sync_tolerance(const entt::registry &registry);
+
+/**
+ * @brief Set the tolerance used in incremental island synchronization. An AABB
+ * is synchronized when any of its bounds moves by more than this distance.
+ * Contact manifolds are synchronized when contact points are added or removed
+ * or when their pivots or normals change by more than this amount.
+ * @param registry Data source.
+ * @param tolerance Tolerance distance.
+ */
+void set_island_sync_tolerance(entt::registry &registry, scalar tolerance);
+
 /**
  * @brief Use the provided material when two rigid bodies with the given
  * material ids collide.
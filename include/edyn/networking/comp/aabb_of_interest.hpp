@@ -2,6 +2,7 @@
 #define EDYN_NETWORKING_AABB_OF_INTEREST_HPP
 
 #include "edyn/comp/aabb.hpp"
+#include "edyn/util/flat_hash_map.hpp"
 #include <entt/signal/sigh.hpp>
 #include <entt/entity/sparse_set.hpp>
 #include <vector>
@@ -16,13 +17,21 @@ struct aabb_of_interest {
     // The AABB of interest.
     AABB aabb {vector3_one * -500, vector3_one * 500};
 
-    // Islands whose AABB intersects this AABB of interest.
-    entt::sparse_set island_entities {};
-
-    // Entities in the islands above, including nodes and edges. This is used
-    // as a way to tell which entities have entered and exited the AABB.
+    // Entities of interest to the client, which are the bodies in the cells
+    // of the interest grid that overlap the AABB, the non-procedural entities
+    // that intersect the AABB, the constraints whose bodies are all of
+    // interest and the clients that own any of these entities. It is updated
+    // incrementally as entities enter and exit the AABB.
     entt::sparse_set entities {};
 
+    // Non-procedural entities that intersect the AABB.
+    entt::sparse_set non_procedural_entities {};
+
+    // Owner of the entities of interest that are owned by a client and the
+    // number of entities of interest owned by each client.
+    flat_hash_map<entt::entity, entt::entity> entity_owners;
+    flat_hash_map<entt::entity, unsigned> owner_counts;
+
     // Entities that entered and exited the AABB in the last update. These
     // containers are for temporary data storage in the AABB of interest update
     // and so they get cleared up in every update and should not be modified.
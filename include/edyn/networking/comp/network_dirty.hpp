@@ -46,6 +46,17 @@ struct network_dirty {
         }
     }
 
+    // Removes types marked as dirty at or before the given time.
+    void erase_until(double time) {
+        for (unsigned i = 0; i < size;) {
+            if (entries[i].time <= time) {
+                entries[i] = entries[--size];
+            } else {
+                ++i;
+            }
+        }
+    }
+
     bool empty() const {
         return size == 0;
     }
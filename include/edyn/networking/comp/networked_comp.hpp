@@ -57,6 +57,7 @@ static const auto networked_components = std::tuple_cat(std::tuple<
     rigidbody_tag,
     rolling_tag,
     roll_direction,
+    ccd_tag,
     null_constraint,
     gravity_constraint,
     point_constraint,
@@ -4,8 +4,11 @@
 #include <vector>
 #include <entt/entity/fwd.hpp>
 #include "edyn/util/entity_map.hpp"
+#include "edyn/util/flat_hash_map.hpp"
 #include "edyn/networking/packet/edyn_packet.hpp"
+#include "edyn/networking/comp/network_dirty.hpp"
 #include "edyn/networking/util/clock_sync.hpp"
+#include "edyn/networking/util/snapshot_codec.hpp"
 
 namespace edyn {
 
@@ -39,6 +42,37 @@ struct remote_client {
     // Rate of registry snapshots, i.e. registry snapshots sent per second.
     double snapshot_rate {10};
 
+    // Sequence number of the next compressed registry snapshot.
+    uint32_t next_snapshot_sequence {1};
+
+    // Sequence number of the latest snapshot acknowledged by the client.
+    uint32_t last_acked_snapshot {0};
+
+    // Quantized values sent in the latest snapshots, which are used as a
+    // baseline once acknowledged.
+    snapshot_baseline_history snapshot_baselines;
+
+    // Accumulated priority of entities in the AABB of interest that have
+    // not been sent since it was reset.
+    flat_hash_map<entt::entity, scalar> snapshot_priorities;
+
+    // Components of entities in the AABB of interest that changed and have
+    // not reached this client yet. Unlike `network_dirty`, these do not expire,
+    // thus entities held back by the snapshot byte budget are still sent
+    // eventually.
+    flat_hash_map<entt::entity, network_dirty> pending_dirty;
+
+    // Snapshots which have not been acknowledged yet. Once acknowledged, the
+    // pending dirty components of the entities it contained which changed
+    // before it was sent are erased.
+    struct sent_snapshot {
+        uint32_t sequence;
+        double time;
+        std::vector<entt::entity> entities;
+    };
+
+    std::vector<sent_snapshot> unacked_snapshots;
+
     // Whether this client will be given temporary ownership of all entities in
     // the island where entities owned by it reside, thus allowing the state of
     // those entities to be set by the client.
@@ -6,6 +6,7 @@
 #include "edyn/networking/util/client_snapshot_importer.hpp"
 #include "edyn/networking/util/client_snapshot_exporter.hpp"
 #include "edyn/networking/util/clock_sync.hpp"
+#include "edyn/networking/util/snapshot_codec.hpp"
 #include <entt/entity/fwd.hpp>
 #include <entt/entity/entity.hpp>
 #include <entt/entity/sparse_set.hpp>
@@ -41,12 +42,24 @@ struct client_network_context {
     entt::sparse_set requested_entities {};
 
     double last_snapshot_time {0};
+
+    // Quantized values of the latest compressed snapshots received from the
+    // server, which might be used as a baseline to decode the next ones.
+    snapshot_baseline_history snapshot_baselines;
+
+    // Sequence number of the latest compressed snapshot received.
+    uint32_t latest_snapshot_sequence {0};
+
     double server_playout_delay {0.3};
 
     // Without full ownership, the client will only send input components to server.
     bool allow_full_ownership {true};
 
     std::vector<extrapolation_job_context> extrapolation_jobs;
+
+    // Finished extrapolation jobs kept around to be restarted, which allows
+    // reusing their registries and static entities.
+    std::vector<std::unique_ptr<extrapolation_job>> idle_extrapolation_jobs;
     std::shared_ptr<input_state_history> input_history;
 
     using packet_observer_func_t = void(const packet::edyn_packet &);
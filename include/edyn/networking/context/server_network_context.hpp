@@ -6,6 +6,7 @@
 #include <entt/signal/sigh.hpp>
 #include "edyn/networking/util/server_snapshot_importer.hpp"
 #include "edyn/networking/util/server_snapshot_exporter.hpp"
+#include "edyn/networking/util/interest_grid.hpp"
 
 namespace edyn {
 
@@ -17,6 +18,14 @@ struct server_network_context {
     std::shared_ptr<server_snapshot_importer> snapshot_importer;
     std::shared_ptr<server_snapshot_exporter> snapshot_exporter;
 
+    // Spatial index of bodies and clients' AABBs of interest.
+    interest_grid interest;
+
+    // Entities destroyed and constraints created since the last update of
+    // the AABBs of interest, which are not tracked by the interest grid.
+    std::vector<entt::entity> interest_destroyed_entities;
+    std::vector<entt::entity> interest_created_edges;
+
     // Packet signals contain the client entity and the packet.
     using packet_observer_func_t = void(entt::entity, const packet::edyn_packet &);
     entt::sigh<packet_observer_func_t> packet_signal;
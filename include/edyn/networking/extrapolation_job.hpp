@@ -33,6 +33,7 @@ class extrapolation_job final {
     };
 
     void load_input();
+    void release_previous_input();
     void init();
     bool should_step();
     void begin_step();
@@ -53,6 +54,30 @@ public:
                       const material_mix_table &material_table,
                       std::shared_ptr<input_state_history> input_history);
 
+    /**
+     * @brief Reuses this job for a new extrapolation once it has finished.
+     * Static entities which are also present in the new input are kept along
+     * with their broadphase state, thus they can be left out of the input's
+     * registry operations. All other entities are destroyed and must be fully
+     * included in the new input.
+     * @param input The new extrapolation input.
+     * @param settings Current settings.
+     * @param material_table Current material mixing table.
+     */
+    void restart(extrapolation_input &&input,
+                 const settings &settings,
+                 const material_mix_table &material_table);
+
+    /**
+     * @brief Checks whether an entity from the main registry is present in
+     * this job's registry. Must not be called while the job is running.
+     * @param remote_entity Entity in the main registry.
+     * @return Whether the entity is present.
+     */
+    bool contains_entity(entt::entity remote_entity) const {
+        return m_entity_map.contains(remote_entity);
+    }
+
     void reschedule();
 
     bool is_finished() const {
@@ -82,6 +107,7 @@ private:
     unsigned m_step_count {0};
     std::atomic<bool> m_finished {false};
     bool m_destroying_node {false};
+    bool m_initialized {false};
 
     std::shared_ptr<input_state_history> m_input_history;
 
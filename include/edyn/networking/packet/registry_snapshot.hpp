@@ -21,6 +21,14 @@ struct registry_snapshot {
     std::vector<entt::entity> entities;
     std::vector<pool_snapshot> pools;
 
+    // Sequence number of snapshots which have packed pools, which is sent
+    // back in a `snapshot_ack`. Zero if there are no packed pools.
+    uint32_t sequence {0};
+
+    // Sequence number of the snapshot the packed pools were encoded against.
+    // Zero if they were encoded in full.
+    uint32_t baseline_sequence {0};
+
     void convert_remloc(const entt::registry &registry, const entity_map &emap) {
         for (auto &entity : entities) {
             entity = emap.at(entity);
@@ -35,6 +43,8 @@ struct registry_snapshot {
 template<typename Archive>
 void serialize(Archive &archive, registry_snapshot &snapshot) {
     archive(snapshot.timestamp);
+    archive(snapshot.sequence);
+    archive(snapshot.baseline_sequence);
     archive(snapshot.entities);
     archive(snapshot.pools);
 }
@@ -1,6 +1,10 @@
 #ifndef EDYN_NETWORKING_SETTINGS_SERVER_NETWORK_SETTINGS_HPP
 #define EDYN_NETWORKING_SETTINGS_SERVER_NETWORK_SETTINGS_HPP
 
+#include <cstddef>
+#include "edyn/math/scalar.hpp"
+#include "edyn/networking/util/snapshot_codec.hpp"
+
 namespace edyn {
 
 struct server_network_settings {
@@ -15,6 +19,37 @@ struct server_network_settings {
     // longer be delayed, they'll be applied immediately instead, which can lead
     // to jitter.
     double max_playout_delay {2};
+
+    // Whether to quantize and bit-pack positions, orientations and velocities
+    // in registry snapshots, encoding them as differences to the last snapshot
+    // acknowledged by the client.
+    bool snapshot_compression_enabled {true};
+
+    // Quantization parameters, which determine the error bounds of the
+    // compressed values.
+    snapshot_codec_settings snapshot_codec {};
+
+    // Maximum estimated size in bytes of the entities and components in a
+    // registry snapshot. Entities that do not fit are sent in later
+    // snapshots. Entities are chosen in order of a priority which accumulates
+    // over time until they are sent, so all of them are sent eventually.
+    size_t snapshot_byte_budget {1200};
+
+    // Priority of entities decreases with the distance to the center of the
+    // AABB of interest of the client. At this distance, it's halved.
+    scalar snapshot_priority_distance_scale {scalar(20)};
+
+    // Priority of entities increases with speed. This is the increase per
+    // meter per second.
+    scalar snapshot_priority_speed_factor {scalar(0.1)};
+
+    // Priority multiplier of entities owned by the client.
+    scalar snapshot_priority_owned_multiplier {scalar(4)};
+
+    // Size of the cells of the spatial hash used to find which bodies are
+    // inside the AABB of interest of each client. Bodies are of interest to a
+    // client if the cell that contains them overlaps its AABB of interest.
+    scalar interest_grid_cell_size {scalar(32)};
 };
 
 }
@@ -0,0 +1,145 @@
+#ifndef EDYN_NETWORKING_UTIL_INTEREST_GRID_HPP
+#define EDYN_NETWORKING_UTIL_INTEREST_GRID_HPP
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <entt/entity/entity.hpp>
+#include "edyn/comp/aabb.hpp"
+#include "edyn/math/scalar.hpp"
+#include "edyn/math/vector3.hpp"
+#include "edyn/util/flat_hash_map.hpp"
+
+namespace edyn {
+
+/**
+ * @brief Spatial hash used for interest management in the server. Bodies are
+ * assigned to the cell that contains their position and clients subscribe to
+ * all cells that overlap their AABB of interest. A body is of interest to a
+ * client if its cell is subscribed by the client. Whenever a body moves to
+ * another cell or a client moves its AABB of interest, the bodies that entered
+ * and exited each client's area are recorded, thus the set of entities of
+ * interest is updated incrementally instead of being recalculated from
+ * scratch.
+ */
+class interest_grid {
+public:
+    using cell_coords = std::array<int32_t, 3>;
+
+    struct cell_range {
+        cell_coords min;
+        cell_coords max;
+
+        bool contains(const cell_coords &coords) const {
+            return coords[0] >= min[0] && coords[0] <= max[0] &&
+                   coords[1] >= min[1] && coords[1] <= max[1] &&
+                   coords[2] >= min[2] && coords[2] <= max[2];
+        }
+
+        bool operator==(const cell_range &other) const {
+            return min == other.min && max == other.max;
+        }
+    };
+
+    // A body that entered or exited the area of a client. Changes must be
+    // applied in order since a body can enter and exit in the same update.
+    struct interest_change {
+        entt::entity entity;
+        bool entered;
+    };
+
+    interest_grid(scalar cell_size = scalar(32));
+
+    /**
+     * @brief Changes the size of the cells and reassigns bodies and clients to
+     * the new cells, recording the change of interest it might cause.
+     * @param cell_size New cell size.
+     */
+    void set_cell_size(scalar cell_size);
+
+    scalar cell_size() const {
+        return m_cell_size;
+    }
+
+    /**
+     * @brief Inserts a body or updates its cell.
+     * @param entity Body entity.
+     * @param pos Position of the body.
+     */
+    void move_body(entt::entity entity, const vector3 &pos);
+
+    /**
+     * @brief Removes a body without generating exit events. Meant for bodies
+     * that are destroyed, which are handled separately.
+     * @param entity Body entity.
+     */
+    void remove_body(entt::entity entity);
+
+    bool contains_body(entt::entity entity) const {
+        return m_body_cells.contains(entity);
+    }
+
+    /**
+     * @brief Inserts a client or updates the cells it is subscribed to.
+     * @param entity Client entity.
+     * @param aabb The client's AABB of interest.
+     */
+    void move_client(entt::entity entity, const AABB &aabb);
+
+    void remove_client(entt::entity entity);
+
+    /**
+     * @brief Returns the bodies that entered and exited the area of a client
+     * since the last call to `clear_changes`, in order.
+     * @param entity Client entity.
+     * @return Pointer to changes or null if the client is not in the grid.
+     */
+    const std::vector<interest_change> * changes(entt::entity entity) const;
+
+    void clear_changes();
+
+    cell_coords coords_of(const vector3 &pos) const;
+    cell_range range_of(const AABB &aabb) const;
+
+private:
+    struct cell {
+        cell_coords coords;
+        std::vector<entt::entity> entities;
+    };
+
+    struct body_entry {
+        vector3 position;
+        uint32_t cell_index;
+    };
+
+    struct client {
+        entt::entity entity;
+        AABB aabb;
+        cell_range range;
+        std::vector<interest_change> changes;
+    };
+
+    static uint64_t cell_key(const cell_coords &coords);
+    uint32_t get_or_create_cell(const cell_coords &coords);
+    void insert_into_cell(uint32_t cell_index, entt::entity entity);
+    void remove_from_cell(uint32_t cell_index, entt::entity entity);
+
+    template<typename Func>
+    void visit_cells(const cell_range &range, Func func);
+
+    scalar m_cell_size;
+
+    // Cells are created on demand and are never removed, thus the number of
+    // cells is bounded by the volume of the region where bodies have been.
+    std::vector<cell> m_cells;
+    flat_hash_map<uint64_t, uint32_t> m_cell_indices;
+    flat_hash_map<entt::entity, body_entry> m_body_cells;
+
+    // Few clients are expected, thus they're stored in a plain array and
+    // every one of them is visited when a body changes cells.
+    std::vector<client> m_clients;
+};
+
+}
+
+#endif // EDYN_NETWORKING_UTIL_INTEREST_GRID_HPP
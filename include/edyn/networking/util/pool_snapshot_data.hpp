@@ -11,6 +11,8 @@
 #include "edyn/parallel/map_child_entity.hpp"
 #include "edyn/serialization/memory_archive.hpp"
 #include "edyn/util/entity_map.hpp"
+#include "edyn/networking/util/snapshot_codec.hpp"
+#include "edyn/serialization/std_s11n.hpp"
 #include "edyn/config/config.h"
 
 namespace edyn {
@@ -28,6 +30,37 @@ struct pool_snapshot_data {
                                        const entity_map &emap) = 0;
     virtual entt::id_type get_type_id() const = 0;
 
+    /**
+     * @brief Quantizes and bit-packs the components if there's a
+     * `snapshot_codec` for this component type. Otherwise, does nothing.
+     * @param settings Quantization parameters.
+     * @param pool_entities Entities of the snapshot.
+     * @param baseline Baseline of the acknowledged snapshot the components are
+     * encoded against. If null, all values are encoded in full.
+     * @param current Baseline of this snapshot, where the values that the
+     * other end is going to decode will be inserted.
+     */
+    virtual void pack([[maybe_unused]] const snapshot_codec_settings &settings,
+                      [[maybe_unused]] const std::vector<entt::entity> &pool_entities,
+                      [[maybe_unused]] const snapshot_baseline *baseline,
+                      [[maybe_unused]] snapshot_baseline &current) {}
+
+    /**
+     * @brief Decodes components packed with `pack`. Does nothing if the pool
+     * is not packed.
+     * @param pool_entities Entities of the snapshot, in the same space they
+     * were in when packed.
+     * @param baseline Baseline the components were encoded against.
+     * @param current Baseline of this snapshot, where the decoded values will
+     * be inserted.
+     * @return Whether the packed data was valid.
+     */
+    virtual bool unpack([[maybe_unused]] const std::vector<entt::entity> &pool_entities,
+                        [[maybe_unused]] const snapshot_baseline *baseline,
+                        [[maybe_unused]] snapshot_baseline &current) {
+        return true;
+    }
+
     bool empty() const {
         return entity_indices.empty();
     }
@@ -36,8 +69,13 @@ struct pool_snapshot_data {
 template<typename Component>
 struct pool_snapshot_data_impl : public pool_snapshot_data {
     static constexpr auto is_empty_type = std::is_empty_v<Component>;
+    static constexpr auto has_codec = snapshot_codec<Component>::is_specialized;
     std::vector<Component> components;
 
+    // Quantized and bit-packed components, which replace `components` on the
+    // wire if not empty.
+    std::vector<uint8_t> packed;
+
     void convert_remloc(const entt::registry &registry, const entity_map &emap) override {
         if constexpr(!is_empty_type) {
             for (auto &comp : components) {
@@ -54,6 +92,16 @@ struct pool_snapshot_data_impl : public pool_snapshot_data {
             archive(idx);
         }
 
+        if constexpr(has_codec) {
+            auto is_packed = !packed.empty();
+            archive(is_packed);
+
+            if (is_packed) {
+                archive(packed);
+                return;
+            }
+        }
+
         if constexpr(!is_empty_type) {
             for (auto &comp : components) {
                 archive(comp);
@@ -70,6 +118,18 @@ struct pool_snapshot_data_impl : public pool_snapshot_data {
             archive(idx);
         }
 
+        if constexpr(has_codec) {
+            bool is_packed;
+            archive(is_packed);
+
+            if (is_packed) {
+                // Components will be decoded later in `unpack` since that
+                // requires the baseline.
+                archive(packed);
+                return;
+            }
+        }
+
         if constexpr(!is_empty_type) {
             components.resize(num_entities);
 
@@ -167,6 +227,100 @@ struct pool_snapshot_data_impl : public pool_snapshot_data {
         }
     }
 
+    void pack(const snapshot_codec_settings &settings,
+              const std::vector<entt::entity> &pool_entities,
+              const snapshot_baseline *baseline,
+              snapshot_baseline &current) override {
+        if constexpr(has_codec) {
+            using codec = snapshot_codec<Component>;
+            EDYN_ASSERT(entity_indices.size() == components.size());
+
+            auto resolution = codec::resolution(settings);
+            auto *baseline_values = baseline ? &(*baseline)[codec::slot] : nullptr;
+            auto &current_values = current[codec::slot];
+
+            packed.clear();
+            auto writer = bit_writer(packed);
+            writer.write_float(static_cast<float>(resolution));
+            // Read back the resolution as it'll be decoded in the other end.
+            resolution = static_cast<float>(resolution);
+
+            for (size_t i = 0; i < entity_indices.size(); ++i) {
+                auto entity = pool_entities[entity_indices[i]];
+                auto value = codec::quantize(components[i], resolution);
+                const quantized_value *baseline_value = nullptr;
+
+                if (baseline_values && baseline_values->contains(entity)) {
+                    baseline_value = &baseline_values->at(entity);
+                    auto unchanged = value == *baseline_value;
+                    writer.write(unchanged, 1);
+
+                    if (unchanged) {
+                        current_values.insert_or_assign(entity, value);
+                        continue;
+                    }
+                }
+
+                codec::encode(writer, value, baseline_value);
+                current_values.insert_or_assign(entity, value);
+            }
+
+            writer.flush();
+        }
+    }
+
+    bool unpack(const std::vector<entt::entity> &pool_entities,
+                const snapshot_baseline *baseline,
+                snapshot_baseline &current) override {
+        if constexpr(has_codec) {
+            if (packed.empty()) {
+                return true;
+            }
+
+            using codec = snapshot_codec<Component>;
+            auto reader = bit_reader(packed.data(), packed.size());
+            auto resolution = static_cast<scalar>(reader.read_float());
+            auto *baseline_values = baseline ? &(*baseline)[codec::slot] : nullptr;
+            auto &current_values = current[codec::slot];
+            components.resize(entity_indices.size());
+
+            for (size_t i = 0; i < entity_indices.size(); ++i) {
+                if (entity_indices[i] >= pool_entities.size()) {
+                    return false;
+                }
+
+                auto entity = pool_entities[entity_indices[i]];
+
+                // Null cannot be stored in the baseline.
+                if (entity == entt::null) {
+                    return false;
+                }
+
+                auto value = quantized_value{};
+                const quantized_value *baseline_value = nullptr;
+
+                if (baseline_values && baseline_values->contains(entity)) {
+                    baseline_value = &baseline_values->at(entity);
+                }
+
+                if (baseline_value && reader.read(1)) {
+                    value = *baseline_value;
+                } else {
+                    codec::decode(reader, value, baseline_value);
+                }
+
+                current_values.insert_or_assign(entity, value);
+                codec::dequantize(value, resolution, components[i]);
+            }
+
+            packed.clear();
+
+            return !reader.failed();
+        } else {
+            return true;
+        }
+    }
+
     entt::id_type get_type_id() const override {
         return entt::type_index<Component>::value();
     }
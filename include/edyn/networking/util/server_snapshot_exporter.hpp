@@ -6,6 +6,8 @@
 #include <type_traits>
 #include "edyn/networking/comp/entity_owner.hpp"
 #include "edyn/networking/comp/network_dirty.hpp"
+#include "edyn/networking/comp/remote_client.hpp"
+#include "edyn/networking/util/snapshot_codec.hpp"
 #include "edyn/networking/packet/registry_snapshot.hpp"
 #include "edyn/comp/dirty.hpp"
 
@@ -24,6 +26,15 @@ public:
     // Write all dirty entities and components into a snapshot.
     virtual void export_dirty(const entt::registry &registry, packet::registry_snapshot &snap,
                               entt::entity dest_client_entity) = 0;
+
+    // Estimate the number of bytes the dirty components of an entity take in
+    // a snapshot. If codec settings are provided, components with a codec
+    // are assumed to be packed against the given baseline, which can be null.
+    // Otherwise, components are assumed to be written in full.
+    virtual size_t estimate_dirty_size(const entt::registry &registry, entt::entity entity,
+                                       entt::entity dest_client_entity,
+                                       const snapshot_codec_settings *codec_settings,
+                                       const snapshot_baseline *baseline) const = 0;
 };
 
 template<typename... Components>
@@ -38,6 +49,75 @@ class server_snapshot_exporter_impl : public server_snapshot_exporter {
             internal::snapshot_insert_entity<Components>(registry, entity, snap, ComponentIndex) : void(0)), ...);
     }
 
+    template<typename Component>
+    static size_t estimate_component_bits(const entt::registry &registry, entt::entity entity,
+                                          const snapshot_codec_settings *codec_settings,
+                                          const snapshot_baseline *baseline) {
+        if constexpr(std::is_empty_v<Component>) {
+            return 0;
+        } else {
+            auto *comp = registry.try_get<Component>(entity);
+
+            if (comp == nullptr) {
+                return 0;
+            }
+
+            if constexpr(snapshot_codec<Component>::is_specialized) {
+                if (codec_settings != nullptr) {
+                    // Mirrors `pool_snapshot_data_impl::pack`.
+                    using codec = snapshot_codec<Component>;
+                    auto resolution = static_cast<scalar>(static_cast<float>(codec::resolution(*codec_settings)));
+                    auto value = codec::quantize(*comp, resolution);
+
+                    if (baseline && (*baseline)[codec::slot].contains(entity)) {
+                        auto &baseline_value = (*baseline)[codec::slot].at(entity);
+                        return value == baseline_value ? 1 : 1 + codec::encoded_bits(value, &baseline_value);
+                    }
+
+                    return codec::encoded_bits(value, nullptr);
+                }
+            }
+
+            return sizeof(Component) * 8;
+        }
+    }
+
+    // Visits the ids of the dirty components of an entity which should be
+    // sent to the destination client, which includes the components that
+    // are pending for that client.
+    template<typename Func>
+    static void each_dirty_id(const entt::registry &registry, entt::entity entity,
+                              entt::entity dest_client_entity, Func func) {
+        auto owner_view = registry.view<entity_owner>();
+        auto owned_by_client = !owner_view.contains(entity) ? false :
+            std::get<0>(owner_view.get(entity)).client_entity == dest_client_entity;
+        auto n_dirty = network_dirty{};
+
+        if (auto *entity_dirty = registry.try_get<network_dirty>(entity)) {
+            n_dirty = *entity_dirty;
+        }
+
+        if (auto *client = registry.try_get<remote_client>(dest_client_entity);
+            client && client->pending_dirty.contains(entity)) {
+            auto &pending = client->pending_dirty.at(entity);
+
+            for (unsigned i = 0; i < pending.size; ++i) {
+                n_dirty.insert(pending.entries[i].type_id, pending.entries[i].time);
+            }
+        }
+
+        n_dirty.each([&](entt::id_type id) {
+            // Do not include input components of entities owned by destination
+            // client as to not override client input on the client-side.
+            // Clients own their input.
+            if (owned_by_client && ((*g_is_networked_input_component)(id) || (*g_is_action_list_component)(id))) {
+                return;
+            }
+
+            func(id);
+        });
+    }
+
 public:
     server_snapshot_exporter_impl(std::tuple<Components...>) {}
 
@@ -48,27 +128,29 @@ public:
     }
 
     void export_dirty(const entt::registry &registry, packet::registry_snapshot &snap, entt::entity dest_client_entity) override {
-        auto network_dirty_view = registry.view<network_dirty>();
-        auto owner_view = registry.view<entity_owner>();
         constexpr auto indices = std::make_integer_sequence<unsigned, sizeof...(Components)>{};
 
         for (auto entity : snap.entities) {
-            auto owned_by_client = !owner_view.contains(entity) ? false :
-                std::get<0>(owner_view.get(entity)).client_entity == dest_client_entity;
-            auto [n_dirty] = network_dirty_view.get(entity);
-
-            n_dirty.each([&](entt::id_type id) {
-                // Do not include input components of entities owned by destination
-                // client as to not override client input on the client-side.
-                // Clients own their input.
-                if (owned_by_client && ((*g_is_networked_input_component)(id) || (*g_is_action_list_component)(id))) {
-                    return;
-                }
-
+            each_dirty_id(registry, entity, dest_client_entity, [&](entt::id_type id) {
                 export_by_type_id(registry, entity, id, snap, indices);
             });
         }
     }
+
+    size_t estimate_dirty_size(const entt::registry &registry, entt::entity entity,
+                               entt::entity dest_client_entity,
+                               const snapshot_codec_settings *codec_settings,
+                               const snapshot_baseline *baseline) const override {
+        size_t bits = 0;
+
+        each_dirty_id(registry, entity, dest_client_entity, [&](entt::id_type id) {
+            bits += sizeof(pool_snapshot_data::index_type) * 8;
+            ((bits += entt::type_index<Components>::value() == id ?
+                estimate_component_bits<Components>(registry, entity, codec_settings, baseline) : 0), ...);
+        });
+
+        return (bits + 7) / 8;
+    }
 };
 
 }
@@ -0,0 +1,475 @@
+#ifndef EDYN_NETWORKING_UTIL_SNAPSHOT_CODEC_HPP
+#define EDYN_NETWORKING_UTIL_SNAPSHOT_CODEC_HPP
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <entt/entity/fwd.hpp>
+#include "edyn/math/scalar.hpp"
+#include "edyn/math/vector3.hpp"
+#include "edyn/math/quaternion.hpp"
+#include "edyn/comp/position.hpp"
+#include "edyn/comp/orientation.hpp"
+#include "edyn/comp/linvel.hpp"
+#include "edyn/comp/angvel.hpp"
+#include "edyn/util/flat_hash_map.hpp"
+#include "edyn/config/config.h"
+
+namespace edyn {
+
+/**
+ * @brief Writes unsigned values with an arbitrary number of bits into a byte
+ * buffer, least significant bits first.
+ */
+class bit_writer {
+public:
+    bit_writer(std::vector<uint8_t> &data)
+        : m_data(&data)
+    {}
+
+    void write(uint32_t value, unsigned num_bits) {
+        EDYN_ASSERT(num_bits <= 32);
+        EDYN_ASSERT(num_bits == 32 || value < (UINT64_C(1) << num_bits));
+        m_scratch |= static_cast<uint64_t>(value) << m_scratch_bits;
+        m_scratch_bits += num_bits;
+
+        while (m_scratch_bits >= 8) {
+            m_data->push_back(static_cast<uint8_t>(m_scratch & 0xff));
+            m_scratch >>= 8;
+            m_scratch_bits -= 8;
+        }
+    }
+
+    void write_float(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        write(bits, 32);
+    }
+
+    // Writes the remaining bits, padding the last byte with zeros.
+    void flush() {
+        if (m_scratch_bits > 0) {
+            m_data->push_back(static_cast<uint8_t>(m_scratch & 0xff));
+            m_scratch = 0;
+            m_scratch_bits = 0;
+        }
+    }
+
+private:
+    std::vector<uint8_t> *m_data;
+    uint64_t m_scratch {0};
+    unsigned m_scratch_bits {0};
+};
+
+/**
+ * @brief Reads values written by a `bit_writer`. Reading past the end yields
+ * zeros and sets the failure flag.
+ */
+class bit_reader {
+public:
+    bit_reader(const uint8_t *data, size_t size)
+        : m_data(data)
+        , m_size(size)
+    {}
+
+    uint32_t read(unsigned num_bits) {
+        EDYN_ASSERT(num_bits <= 32);
+
+        while (m_scratch_bits < num_bits) {
+            uint64_t byte = 0;
+
+            if (m_position < m_size) {
+                byte = m_data[m_position++];
+            } else {
+                m_failed = true;
+            }
+
+            m_scratch |= byte << m_scratch_bits;
+            m_scratch_bits += 8;
+        }
+
+        auto value = static_cast<uint32_t>(m_scratch & ((UINT64_C(1) << num_bits) - 1));
+        m_scratch >>= num_bits;
+        m_scratch_bits -= num_bits;
+        return value;
+    }
+
+    float read_float() {
+        auto bits = read(32);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    bool failed() const {
+        return m_failed;
+    }
+
+private:
+    const uint8_t *m_data;
+    size_t m_size;
+    size_t m_position {0};
+    uint64_t m_scratch {0};
+    unsigned m_scratch_bits {0};
+    bool m_failed {false};
+};
+
+/**
+ * @brief Quantization parameters of snapshot compression. Each is the size of
+ * one quantization step, thus the maximum error of a decoded value is half of
+ * it.
+ */
+struct snapshot_codec_settings {
+    // Quantization step of positions, in meters.
+    scalar position_resolution {scalar(0.0002)};
+
+    // Quantization step of linear velocities in meters per second and of
+    // angular velocities in radians per second.
+    scalar velocity_resolution {scalar(0.001)};
+
+    // Quantization step of the three smallest components of orientations.
+    scalar orientation_resolution {scalar(0.00005)};
+};
+
+/**
+ * @brief Quantized representation of a component. Values are quantized on a
+ * fixed grid which is the same in all snapshots, thus the difference with
+ * the value of a previous snapshot is usually small and is encoded with
+ * fewer bits.
+ */
+using quantized_value = std::array<int32_t, 4>;
+
+namespace detail {
+    // Quantized values are clamped to this range so the difference between
+    // any two of them fits in 31 bits after zigzag encoding.
+    inline constexpr int32_t max_quantized_value = (INT32_C(1) << 29) - 1;
+
+    // Number of bits used to store the bit length of a difference.
+    inline constexpr unsigned delta_length_bits = 5;
+
+    // Calculated in double precision since the limits are not representable
+    // as floats.
+    inline int32_t quantize(scalar value, scalar resolution) {
+        auto q = std::round(static_cast<double>(value) / static_cast<double>(resolution));
+        q = std::clamp(q, double(-max_quantized_value), double(max_quantized_value));
+        return static_cast<int32_t>(q);
+    }
+
+    inline uint32_t zigzag_delta(int32_t value, int32_t base) {
+        auto delta = static_cast<int64_t>(value) - static_cast<int64_t>(base);
+        return static_cast<uint32_t>(delta < 0 ? (-delta) * 2 - 1 : delta * 2);
+    }
+
+    inline unsigned bit_length(uint32_t value) {
+        unsigned length = 0;
+
+        while (length < 32 && (value >> length) != 0) {
+            ++length;
+        }
+
+        return length;
+    }
+
+    // Number of bits `write_delta` takes to encode a difference.
+    inline unsigned delta_bits(int32_t value, int32_t base) {
+        auto length = bit_length(zigzag_delta(value, base));
+        return delta_length_bits + (length > 1 ? length - 1 : 0);
+    }
+
+    // Writes the difference between two quantized values as the number of
+    // significant bits of its zigzag encoding followed by these bits, minus
+    // the leading one which is implied.
+    inline void write_delta(bit_writer &writer, int32_t value, int32_t base) {
+        auto zigzag = zigzag_delta(value, base);
+        auto length = bit_length(zigzag);
+        EDYN_ASSERT(length < (1u << delta_length_bits));
+        writer.write(length, delta_length_bits);
+
+        if (length > 1) {
+            writer.write(zigzag & ~(UINT32_C(1) << (length - 1)), length - 1);
+        }
+    }
+
+    inline int32_t read_delta(bit_reader &reader, int32_t base) {
+        auto length = reader.read(delta_length_bits);
+        uint32_t zigzag = 0;
+
+        if (length == 1) {
+            zigzag = 1;
+        } else if (length > 1) {
+            zigzag = reader.read(length - 1) | (UINT32_C(1) << (length - 1));
+        }
+
+        auto delta = (zigzag & 1) ? -static_cast<int64_t>((zigzag + 1) / 2) : static_cast<int64_t>(zigzag / 2);
+        return static_cast<int32_t>(static_cast<int64_t>(base) + delta);
+    }
+
+    struct vector3_codec {
+        static constexpr bool is_specialized = true;
+
+        static quantized_value quantize(const vector3 &v, scalar resolution) {
+            return {detail::quantize(v.x, resolution), detail::quantize(v.y, resolution), detail::quantize(v.z, resolution), 0};
+        }
+
+        static vector3 dequantize(const quantized_value &value, scalar resolution) {
+            return {value[0] * resolution, value[1] * resolution, value[2] * resolution};
+        }
+
+        static void encode(bit_writer &writer, const quantized_value &value, const quantized_value *baseline) {
+            for (size_t i = 0; i < 3; ++i) {
+                write_delta(writer, value[i], baseline ? (*baseline)[i] : 0);
+            }
+        }
+
+        static unsigned encoded_bits(const quantized_value &value, const quantized_value *baseline) {
+            unsigned bits = 0;
+
+            for (size_t i = 0; i < 3; ++i) {
+                bits += delta_bits(value[i], baseline ? (*baseline)[i] : 0);
+            }
+
+            return bits;
+        }
+
+        static void decode(bit_reader &reader, quantized_value &value, const quantized_value *baseline) {
+            for (size_t i = 0; i < 3; ++i) {
+                value[i] = read_delta(reader, baseline ? (*baseline)[i] : 0);
+            }
+
+            value[3] = 0;
+        }
+    };
+}
+
+/**
+ * @brief Compact encoding of a component in server snapshots. Specializations
+ * quantize the component and encode it as a difference to its value in a
+ * baseline snapshot the client has acknowledged. Components without a
+ * specialization are sent in full.
+ *
+ * Specializations provide a `slot`, which is an unique index of the codec in
+ * a `snapshot_baseline`, the `resolution` taken from the settings, and
+ * functions to quantize, dequantize, encode and decode the component, as well
+ * as `encoded_bits` which returns the size of the encoded component.
+ */
+template<typename Component>
+struct snapshot_codec {
+    static constexpr bool is_specialized = false;
+};
+
+template<>
+struct snapshot_codec<position> : detail::vector3_codec {
+    static constexpr size_t slot = 0;
+
+    static scalar resolution(const snapshot_codec_settings &settings) {
+        return settings.position_resolution;
+    }
+
+    static void dequantize(const quantized_value &value, scalar resolution, position &pos) {
+        pos = vector3_codec::dequantize(value, resolution);
+    }
+};
+
+template<>
+struct snapshot_codec<linvel> : detail::vector3_codec {
+    static constexpr size_t slot = 1;
+
+    static scalar resolution(const snapshot_codec_settings &settings) {
+        return settings.velocity_resolution;
+    }
+
+    static void dequantize(const quantized_value &value, scalar resolution, linvel &vel) {
+        vel = vector3_codec::dequantize(value, resolution);
+    }
+};
+
+template<>
+struct snapshot_codec<angvel> : detail::vector3_codec {
+    static constexpr size_t slot = 2;
+
+    static scalar resolution(const snapshot_codec_settings &settings) {
+        return settings.velocity_resolution;
+    }
+
+    static void dequantize(const quantized_value &value, scalar resolution, angvel &vel) {
+        vel = vector3_codec::dequantize(value, resolution);
+    }
+};
+
+/**
+ * Orientations use the smallest-three encoding. The component with the
+ * largest magnitude is left out and recovered from the unit length constraint.
+ * The sign of the quaternion is flipped to make it positive, which represents
+ * the same rotation. The remaining three components lie in [-1/√2, 1/√2].
+ */
+template<>
+struct snapshot_codec<orientation> {
+    static constexpr bool is_specialized = true;
+    static constexpr size_t slot = 3;
+
+    static scalar resolution(const snapshot_codec_settings &settings) {
+        return settings.orientation_resolution;
+    }
+
+    static quantized_value quantize(const quaternion &q, scalar resolution) {
+        size_t largest = 0;
+
+        for (size_t i = 1; i < 4; ++i) {
+            if (std::abs(q[i]) > std::abs(q[largest])) {
+                largest = i;
+            }
+        }
+
+        auto sign = q[largest] < 0 ? scalar(-1) : scalar(1);
+        auto value = quantized_value{};
+        value[0] = static_cast<int32_t>(largest);
+
+        for (size_t i = 0, j = 1; i < 4; ++i) {
+            if (i != largest) {
+                value[j++] = detail::quantize(q[i] * sign, resolution);
+            }
+        }
+
+        return value;
+    }
+
+    static void dequantize(const quantized_value &value, scalar resolution, orientation &orn) {
+        auto largest = static_cast<size_t>(value[0]);
+        auto q = quaternion{};
+        auto sum_sq = scalar(0);
+
+        for (size_t i = 0, j = 1; i < 4; ++i) {
+            if (i != largest) {
+                q[i] = value[j++] * resolution;
+                sum_sq += q[i] * q[i];
+            }
+        }
+
+        q[largest] = std::sqrt(std::max(scalar(1) - sum_sq, scalar(0)));
+        orn = normalize(q);
+    }
+
+    static void encode(bit_writer &writer, const quantized_value &value, const quantized_value *baseline) {
+        writer.write(static_cast<uint32_t>(value[0]), 2);
+
+        // The difference is only meaningful if the same component is left out.
+        if (baseline && (*baseline)[0] != value[0]) {
+            baseline = nullptr;
+        }
+
+        for (size_t i = 1; i < 4; ++i) {
+            detail::write_delta(writer, value[i], baseline ? (*baseline)[i] : 0);
+        }
+    }
+
+    static unsigned encoded_bits(const quantized_value &value, const quantized_value *baseline) {
+        if (baseline && (*baseline)[0] != value[0]) {
+            baseline = nullptr;
+        }
+
+        unsigned bits = 2;
+
+        for (size_t i = 1; i < 4; ++i) {
+            bits += detail::delta_bits(value[i], baseline ? (*baseline)[i] : 0);
+        }
+
+        return bits;
+    }
+
+    static void decode(bit_reader &reader, quantized_value &value, const quantized_value *baseline) {
+        value[0] = static_cast<int32_t>(reader.read(2));
+
+        if (baseline && (*baseline)[0] != value[0]) {
+            baseline = nullptr;
+        }
+
+        for (size_t i = 1; i < 4; ++i) {
+            value[i] = detail::read_delta(reader, baseline ? (*baseline)[i] : 0);
+        }
+    }
+};
+
+inline constexpr size_t num_snapshot_codecs = 4;
+
+/**
+ * @brief Quantized values of all encoded components in a snapshot, per codec
+ * slot and entity. Entities are in the server's registry space.
+ */
+using snapshot_baseline = std::array<flat_hash_map<entt::entity, quantized_value>, num_snapshot_codecs>;
+
+/**
+ * @brief Stores the baselines of the latest snapshots. Once full, the oldest
+ * snapshot is replaced.
+ */
+class snapshot_baseline_history {
+public:
+    static constexpr size_t max_size = 32;
+
+    /**
+     * @brief Finds the baseline of a snapshot.
+     * @param sequence Sequence number of snapshot.
+     * @return Pointer to the baseline or null if not found.
+     */
+    const snapshot_baseline * find(uint32_t sequence) const {
+        if (sequence == 0) {
+            return nullptr;
+        }
+
+        auto &entry = m_entries[sequence % max_size];
+        return entry.sequence == sequence ? &entry.baseline : nullptr;
+    }
+
+    /**
+     * @brief Prepares an empty baseline for a snapshot, replacing the older
+     * snapshot that took the same place in the history.
+     * @param sequence Sequence number of snapshot. Must not be zero.
+     * @return Pointer to the empty baseline or null if the snapshot is too
+     * old, i.e. its place is taken by a newer snapshot.
+     */
+    snapshot_baseline * insert(uint32_t sequence) {
+        EDYN_ASSERT(sequence != 0);
+        auto &entry = m_entries[sequence % max_size];
+
+        if (entry.sequence > sequence) {
+            return nullptr;
+        }
+
+        entry.sequence = sequence;
+
+        for (auto &map : entry.baseline) {
+            map.clear();
+        }
+
+        return &entry.baseline;
+    }
+
+    /**
+     * @brief Removes all snapshots, e.g. when the sequence numbers restart
+     * after reconnecting.
+     */
+    void clear() {
+        for (auto &entry : m_entries) {
+            entry.sequence = 0;
+
+            for (auto &map : entry.baseline) {
+                map.clear();
+            }
+        }
+    }
+
+private:
+    struct entry {
+        uint32_t sequence {0};
+        snapshot_baseline baseline;
+    };
+
+    std::array<entry, max_size> m_entries;
+};
+
+}
+
+#endif // EDYN_NETWORKING_UTIL_SNAPSHOT_CODEC_HPP
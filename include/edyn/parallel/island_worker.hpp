@@ -61,6 +61,7 @@ class island_worker final {
     void go_to_sleep();
     bool should_split();
     void sync();
+    void sync_changed(scalar tolerance);
     void sync_dirty();
     void update();
 
@@ -128,6 +129,7 @@ private:
 
     std::vector<entt::entity> m_new_polyhedron_shapes;
     std::vector<entt::entity> m_new_compound_shapes;
+    std::vector<entt::entity> m_changed_entities;
 
     std::atomic<int> m_reschedule_counter {0};
 
@@ -7,6 +7,7 @@
 #include <thread>
 #include <mutex>
 #include <shared_mutex>
+#include <condition_variable>
 #include "edyn/parallel/worker.hpp"
 #include "edyn/parallel/job_scheduler.hpp"
 
@@ -17,7 +18,9 @@ class job_queue;
 class job_queue_scheduler;
 
 /**
- * Manages a set of worker threads and dispatches jobs to them.
+ * Manages a set of worker threads and dispatches jobs to them. Jobs scheduled
+ * from a worker thread are kept in that worker and are stolen by other
+ * workers once they run out of work.
  */
 class job_dispatcher {
 public:
@@ -38,6 +41,12 @@ public:
      */
     void async(const job &);
 
+    /**
+     * Schedules a set of jobs to run asynchronously in worker threads. Wakes
+     * up as many sleeping workers as needed at once.
+     */
+    void async_batch(const std::vector<job> &);
+
     /**
      * Schedules a job to run asynchronously in a worker thread after a delay.
      */
@@ -81,8 +90,33 @@ public:
     size_t num_workers() const;
 
 private:
+    friend class worker;
+
+    /**
+     * Attempts to take a job from any worker other than the given one.
+     */
+    bool steal_job(size_t thief_index, job &);
+
+    /**
+     * Blocks the worker's thread until new jobs are scheduled.
+     */
+    void park_worker(worker &);
+
+    /**
+     * Wakes up to `count` sleeping workers, if any.
+     */
+    void notify_workers(size_t count);
+
+    bool has_pending_jobs() const;
+
     std::vector<std::unique_ptr<std::thread>> m_threads;
-    std::map<std::thread::id, std::unique_ptr<worker>> m_workers;
+    std::vector<std::unique_ptr<worker>> m_workers;
+
+    // Sleeping workers wait until the epoch changes.
+    std::mutex m_park_mutex;
+    std::condition_variable m_park_cv;
+    uint64_t m_park_epoch {0};
+    std::atomic<size_t> m_num_parked {0};
 
     // Job queue for regular threads.
     std::vector<job_queue *> m_queues;
@@ -3,6 +3,7 @@
 
 #include <mutex>
 #include <queue>
+#include <atomic>
 #include <condition_variable>
 #include "edyn/parallel/job.hpp"
 
@@ -21,9 +22,18 @@ public:
 
     size_t size() const;
 
+    /**
+     * @brief Number of jobs without locking, which might be outdated if other
+     * threads are inserting or removing jobs concurrently.
+     */
+    size_t size_hint() const {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
 private:
     mutable std::mutex m_mutex;
     std::queue<job> m_jobs;
+    std::atomic<size_t> m_size {0};
     std::condition_variable m_cv;
 };
 
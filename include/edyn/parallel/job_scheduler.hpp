@@ -1,11 +1,13 @@
 #ifndef EDYN_PARALLEL_JOB_SCHEDULER_HPP
 #define EDYN_PARALLEL_JOB_SCHEDULER_HPP
 
+#include <array>
 #include <mutex>
 #include <thread>
 #include <memory>
 #include <vector>
 #include <atomic>
+#include <cstdint>
 #include <condition_variable>
 #include "edyn/parallel/job.hpp"
 
@@ -14,16 +16,31 @@ namespace edyn {
 class job_dispatcher;
 
 /**
- * Schedules jobs for execution at a later time in a `job_dispatcher`.
+ * Schedules jobs for execution at a later time in a `job_dispatcher`. Jobs are
+ * stored in a hashed timing wheel, which makes scheduling a constant time
+ * operation. All jobs that are due in one tick are dispatched as a batch.
  */
 class job_scheduler final {
     struct timed_job {
         job m_job;
-        double m_timestamp;
+        uint64_t m_tick;
     };
 
+    // Duration of a tick of the timing wheel in seconds.
+    static constexpr double tick_duration = 0.001;
+
+    // Number of slots in the timing wheel. Jobs due further in the future than
+    // this number of ticks stay in their slot for more than one revolution.
+    static constexpr size_t num_slots = 256;
+
+    static constexpr auto no_tick = UINT64_MAX;
+
     void update();
 
+    uint64_t time_to_tick(double time) const;
+
+    uint64_t find_next_tick() const;
+
 public:
     job_scheduler(job_dispatcher &);
     ~job_scheduler();
@@ -36,7 +53,12 @@ public:
 private:
     job_dispatcher *m_dispatcher;
     std::unique_ptr<std::thread> m_thread;
-    std::vector<timed_job> m_jobs;
+    std::array<std::vector<timed_job>, num_slots> m_slots;
+    std::vector<job> m_due_jobs;
+    size_t m_num_jobs {0};
+    double m_start_time {0};
+    uint64_t m_current_tick {0};
+    uint64_t m_next_tick {no_tick};
     std::mutex m_mutex;
     std::condition_variable m_cv;
     std::atomic_bool m_running;
@@ -0,0 +1,82 @@
+#ifndef EDYN_PARALLEL_WORK_STEALING_DEQUE_HPP
+#define EDYN_PARALLEL_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "edyn/parallel/job.hpp"
+
+namespace edyn {
+
+/**
+ * Lock-free Chase-Lev deque of jobs. Only the owner thread can push jobs into
+ * it while any thread, including the owner, can take jobs from the other end.
+ * Jobs are thus taken in the same order they were pushed.
+ * Based on "Correct and Efficient Work-Stealing for Weak Memory Models" by
+ * Lê, Pop, Cohen and Zappa Nardelli.
+ */
+class work_stealing_deque {
+    // A job stored as words which are accessed atomically. A thief might read
+    // a slot while the owner overwrites it, in which case the job that was
+    // read is discarded. Relaxed atomic accesses make that well-defined.
+    struct slot {
+        static constexpr size_t num_words = sizeof(job) / sizeof(uint64_t);
+        static_assert(sizeof(job) % sizeof(uint64_t) == 0);
+
+        void store(const job &j);
+        job load() const;
+
+        std::atomic<uint64_t> words[num_words];
+    };
+
+    struct buffer {
+        buffer(int64_t capacity)
+            : capacity(capacity)
+            , slots(new slot[capacity])
+        {}
+
+        slot & at(int64_t index) {
+            return slots[index & (capacity - 1)];
+        }
+
+        const int64_t capacity;
+        std::unique_ptr<slot[]> slots;
+    };
+
+public:
+    /**
+     * @param initial_capacity Must be a power of two.
+     */
+    work_stealing_deque(int64_t initial_capacity = 256);
+
+    /**
+     * @brief Inserts a job into the deque. Must only be called from the owner
+     * thread.
+     * @param j The job.
+     */
+    void push(const job &j);
+
+    /**
+     * @brief Attempts to take the oldest job. Can be called from any thread.
+     * @param j Assigned the job that was taken, if any.
+     * @return Whether a job was taken. Might fail spuriously if another thread
+     * took a job concurrently.
+     */
+    bool steal(job &j);
+
+    size_t size() const;
+
+private:
+    alignas(64) std::atomic<int64_t> m_top {0};
+    alignas(64) std::atomic<int64_t> m_bottom {0};
+    std::atomic<buffer *> m_buffer;
+
+    // All buffers ever allocated. Old buffers are kept alive until the deque
+    // is destroyed since other threads could still be reading from them.
+    std::vector<std::unique_ptr<buffer>> m_buffers;
+};
+
+}
+
+#endif // EDYN_PARALLEL_WORK_STEALING_DEQUE_HPP
@@ -4,58 +4,77 @@
 #include <atomic>
 #include <memory>
 #include "edyn/parallel/job_queue.hpp"
+#include "edyn/parallel/work_stealing_deque.hpp"
 
 namespace edyn {
 
+class job_dispatcher;
+
 /**
- * A worker that runs jobs in a thread.
+ * A worker that runs jobs in a thread. Jobs scheduled from the worker thread
+ * itself go into a lock-free deque whereas jobs scheduled from other threads
+ * go into a regular queue. Idle workers steal jobs from other workers and
+ * only go to sleep after spinning for a while without finding any work.
  */
 class worker {
 public:
-    void push_job(const job &j) {
-        m_queue.push(j);
-        ++m_size;
-    }
+    worker(job_dispatcher &dispatcher, size_t index);
 
-    void run() {
-        m_running = true;
+    /**
+     * @brief Inserts a job in this worker's deque if called from this worker's
+     * thread or in its queue otherwise.
+     * @param j The job.
+     */
+    void push_job(const job &j);
 
-        for (;;) {
-            auto j = m_queue.pop();
-            j();
-            --m_size;
+    /**
+     * @brief Attempts to take a job from this worker. Can be called from any
+     * thread.
+     * @param j Assigned the job that was taken, if any.
+     * @return Whether a job was taken.
+     */
+    bool try_take_job(job &j);
 
-            if (!m_running) {
-                break;
-            }
-        }
-    }
+    void run();
+
+    void once();
 
-    void once() {
-        job j;
-        while (m_queue.try_pop(j)) {
-            j();
-            --m_size;
-        }
+    void stop();
+
+    bool running() const {
+        return m_running.load(std::memory_order_relaxed);
     }
 
-    void stop() {
-        m_running = false;
-        m_queue.push(job::noop()); // Unblock queue with a no-op job.
+    size_t size() const {
+        return m_deque.size() + m_queue.size();
     }
 
-    size_t size() {
-        return m_size.load();
+    /**
+     * @brief Whether this worker seems to have jobs, without locking. Can be
+     * called from any thread and might be outdated.
+     */
+    bool has_jobs_hint() const {
+        return m_deque.size() > 0 || m_queue.size_hint() > 0;
     }
 
-    job_queue &get_queue() {
-        return m_queue;
+    size_t index() const {
+        return m_index;
     }
 
+    /**
+     * @brief Returns the worker running in the current thread, or null if
+     * this is not a worker thread.
+     */
+    static worker * current();
+
 private:
-    std::atomic_bool m_running {false};
+    bool find_job(job &j);
+
+    job_dispatcher *m_dispatcher;
+    size_t m_index;
+    std::atomic_bool m_running {true};
+    work_stealing_deque m_deque;
     job_queue m_queue;
-    std::atomic<size_t> m_size {0};
 };
 
 }
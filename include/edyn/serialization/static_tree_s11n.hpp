@@ -16,6 +16,12 @@ void serialize(Archive &archive, static_tree::tree_node &node) {
 template<typename Archive>
 void serialize(Archive &archive, static_tree &tree) {
     archive(tree.m_nodes);
+
+    if constexpr(Archive::is_input::value) {
+        if (!tree.m_nodes.empty()) {
+            tree.build_wide_tree();
+        }
+    }
 }
 
 inline
@@ -26,6 +26,16 @@ struct convex_mesh {
     // vertices of an edge in the `vertices` array.
     std::vector<uint32_t> edges;
 
+    // Each subsequent pair of integers represents the indices of the two
+    // faces that share the edge at the same position in `edges`.
+    std::vector<uint32_t> edge_faces;
+
+    // Indices of the vertices connected to each vertex by an edge. The
+    // neighbors of vertex `i` are in `vertex_neighbors` in the range
+    // `[vertex_neighbor_offsets[i], vertex_neighbor_offsets[i + 1])`.
+    std::vector<uint32_t> vertex_neighbor_offsets;
+    std::vector<uint32_t> vertex_neighbors;
+
     // Each subsequent pair of integers represents the index of the first
     // vertex of a face in the `indices` array and the number of vertices
     // in the face.
@@ -110,9 +120,25 @@ struct convex_mesh {
      */
     std::array<vector3, 2> get_rotated_edge(const rotated_mesh &, size_t idx) const;
 
+    /**
+     * @brief Finds the vertex furthest along a direction by walking from a
+     * vertex to the neighbor that's further along the direction until there
+     * is none. Since the mesh is convex, the vertex where it stops is a
+     * global maximum. Starting from the result of a previous query in a
+     * similar direction usually takes only a few steps.
+     * @param points Vertex positions, i.e. the vertices of this mesh or of
+     * its rotated mesh.
+     * @param dir Direction.
+     * @param start Index of vertex where the search starts.
+     * @return Index of support vertex.
+     */
+    uint32_t hill_climb_support_vertex(const std::vector<vector3> &points,
+                                       const vector3 &dir, uint32_t start) const;
+
     void shift_to_centroid();
     void calculate_normals();
     void calculate_edges();
+    void calculate_vertex_neighbors();
     void calculate_relevant_normals();
     void calculate_relevant_edges();
 
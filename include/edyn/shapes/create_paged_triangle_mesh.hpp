@@ -218,7 +218,8 @@ void create_paged_triangle_mesh(
 
     // Build tree and submeshes.
     auto builder = detail::submesh_builder{};
-    paged_tri_mesh.m_tree.build(aabbs.begin(), aabbs.end(), builder, max_tri_per_submesh);
+    paged_tri_mesh.m_tree.build(aabbs.begin(), aabbs.end(), builder, max_tri_per_submesh,
+                                static_tree_build_mode::parallel_sah);
     builder.build(paged_tri_mesh, global_tri_mesh, vertex_begin, index_begin, vertex_colors);
 
     // Resize LRU queue to have the number of leaves.
@@ -10,6 +10,8 @@
 #include "edyn/comp/orientation.hpp"
 #include "edyn/comp/origin.hpp"
 #include "edyn/comp/angvel.hpp"
+#include "edyn/comp/linvel.hpp"
+#include "edyn/comp/tag.hpp"
 #include "edyn/shapes/shapes.hpp"
 #include "edyn/collision/contact_point.hpp"
 #include "edyn/collision/contact_manifold.hpp"
@@ -94,13 +96,29 @@ using detect_collision_body_view_t = entt::basic_view<entt::entity,
 
 using origin_view_t = entt::basic_view<entt::entity, entt::get_t<origin>, entt::exclude_t<>>;
 
+using linvel_view_t = entt::basic_view<entt::entity, entt::get_t<linvel>, entt::exclude_t<>>;
+using ccd_view_t = entt::basic_view<entt::entity, entt::get_t<ccd_tag>, entt::exclude_t<>>;
+
+/**
+ * Calculates the distance under which contact points are created between two
+ * bodies. If continuous collision detection is enabled for either of them, it
+ * is extended by the distance they can move towards each other in one step,
+ * thus speculative contact points are created before they touch.
+ */
+scalar get_collision_threshold(std::array<entt::entity, 2> body,
+                               const linvel_view_t &, const ccd_view_t &, scalar dt);
+
 /**
  * Detects collision between two bodies and adds closest points to the given
- * collision result
+ * collision result. Points separated by a distance greater than `threshold`
+ * are ignored. If a `sat_cache` is provided, the separating axis found is
+ * stored in it and tested first in the next call.
  */
 void detect_collision(std::array<entt::entity, 2> body, collision_result &,
                       const detect_collision_body_view_t &, const origin_view_t &,
-                      const tuple_of_shape_views_t &);
+                      const tuple_of_shape_views_t &,
+                      scalar threshold = collision_threshold,
+                      sat_axis_cache *sat_cache = nullptr);
 
 /**
  * Processes a collision result and inserts/replaces points into the manifold.
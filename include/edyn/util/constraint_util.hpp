@@ -1,6 +1,7 @@
 #ifndef EDYN_UTIL_CONSTRAINT_UTIL_HPP
 #define EDYN_UTIL_CONSTRAINT_UTIL_HPP
 
+#include <vector>
 #include <entt/entity/registry.hpp>
 #include "edyn/comp/dirty.hpp"
 #include "edyn/math/vector3.hpp"
@@ -10,6 +11,7 @@ namespace edyn {
 struct contact_manifold;
 struct constraint_row;
 struct constraint_row_options;
+struct solver_body;
 struct matrix3x3;
 
 namespace internal {
@@ -63,7 +65,7 @@ void make_contact_manifold(entt::entity contact_entity, entt::registry &,
 
 void swap_manifold(contact_manifold &manifold);
 
-scalar get_effective_mass(const constraint_row &);
+scalar get_effective_mass(const constraint_row &, const std::vector<solver_body> &bodies);
 
 scalar get_effective_mass(const std::array<vector3, 4> &J,
                           scalar inv_mA, const matrix3x3 &inv_IA,
@@ -76,13 +78,14 @@ scalar get_relative_speed(const std::array<vector3, 4> &J,
                           const vector3 &angvelB);
 
 void prepare_row(constraint_row &row,
+                 const std::vector<solver_body> &bodies,
                  const constraint_row_options &options,
                  const vector3 &linvelA, const vector3 &angvelA,
                  const vector3 &linvelB, const vector3 &angvelB);
 
-void apply_impulse(scalar impulse, constraint_row &row);
+void apply_impulse(scalar impulse, const constraint_row &row, std::vector<solver_body> &bodies);
 
-void warm_start(constraint_row &row);
+void warm_start(const constraint_row &row, std::vector<solver_body> &bodies);
 
 }
 
@@ -0,0 +1,50 @@
+#ifndef EDYN_UTIL_CONVEX_HULL_HPP
+#define EDYN_UTIL_CONVEX_HULL_HPP
+
+#include <vector>
+#include <cstddef>
+#include "edyn/math/scalar.hpp"
+#include "edyn/math/vector3.hpp"
+
+namespace edyn {
+
+struct convex_mesh;
+
+struct convex_hull_options {
+    // Maximum number of vertices in the hull. Zero means no limit. Points
+    // are added to the hull in order of distance to it, thus if the limit is
+    // reached, the hull contains the points which contribute the most to its
+    // shape and the remaining points may lie slightly outside of it. Must be
+    // zero or at least 4.
+    size_t max_vertices {0};
+
+    // Points closer than this to the hull are considered to be inside of it.
+    scalar tolerance {scalar(0.0001)};
+
+    // Adjacent faces are merged into a single polygonal face if all their
+    // vertices are within this distance of the plane of the face where the
+    // merge started. Setting it to zero only merges faces that are coplanar
+    // within `tolerance`.
+    scalar coplanar_tolerance {scalar(0.0005)};
+};
+
+/**
+ * @brief Calculates the convex hull of a point cloud using the quickhull
+ * algorithm and assigns it to a convex mesh. Coplanar triangles are merged
+ * into polygons and vertices which end up in the middle of a face or of an
+ * edge are removed, which results in fewer faces and vertices and makes
+ * collision detection cheaper.
+ * @remark The mesh is initialized, thus its vertices are shifted so the
+ * centroid is at the origin.
+ * @param points Point cloud.
+ * @param mesh Convex mesh to be replaced by the hull.
+ * @param options Options.
+ * @return Whether the hull could be built. Fails if there are fewer than four
+ * points or if they're all coplanar.
+ */
+bool make_convex_hull(const std::vector<vector3> &points, convex_mesh &mesh,
+                      const convex_hull_options &options = {});
+
+}
+
+#endif // EDYN_UTIL_CONVEX_HULL_HPP
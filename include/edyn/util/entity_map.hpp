@@ -1,16 +1,23 @@
 #ifndef EDYN_UTIL_ENTITY_MAP_HPP
 #define EDYN_UTIL_ENTITY_MAP_HPP
 
-#include <map>
 #include <entt/entity/fwd.hpp>
+#include "edyn/util/flat_hash_map.hpp"
 
 namespace edyn {
 
 class entity_map {
 public:
+    // Pairs which contain a null entity are ignored. Entities might come from
+    // remote packets, thus this must be checked in release builds as well
+    // since null cannot be stored in the underlying maps.
     void insert(entt::entity entity, entt::entity other) {
-        map[entity] = other;
-        others[other] = entity;
+        if (entity == entt::null || other == entt::null) {
+            return;
+        }
+
+        map.insert_or_assign(entity, other);
+        others.insert_or_assign(other, entity);
     }
 
     void erase(entt::entity entity) {
@@ -26,11 +33,11 @@ public:
     }
 
     bool contains(entt::entity entity) const {
-        return map.count(entity) > 0;
+        return map.contains(entity);
     }
 
     bool contains_other(entt::entity other) const {
-        return others.count(other) > 0;
+        return others.contains(other);
     }
 
     entt::entity at(entt::entity entity) const {
@@ -43,30 +50,30 @@ public:
 
     template<typename Predicate>
     void erase_if(Predicate predicate) {
-        for (auto it = map.begin(); it != map.end();) {
-            if (predicate(it->first, it->second)) {
-                others.erase(it->second);
-                it = map.erase(it);
-            } else {
-                ++it;
+        map.erase_if([&](entt::entity entity, entt::entity other) {
+            if (predicate(entity, other)) {
+                others.erase(other);
+                return true;
             }
-        }
+
+            return false;
+        });
     }
 
+    // Visits all pairs in an unspecified order, which changes as entries are
+    // inserted and erased.
     template<typename Func>
     void each(Func func) const {
-        for (auto it = map.begin(); it != map.end(); ++it) {
-            func(it->first, it->second);
-        }
+        map.each(func);
     }
 
     void swap() {
-        std::swap(map, others);
+        map.swap(others);
     }
 
 private:
-    std::map<entt::entity, entt::entity> map;
-    std::map<entt::entity, entt::entity> others;
+    flat_hash_map<entt::entity, entt::entity> map;
+    flat_hash_map<entt::entity, entt::entity> others;
 };
 
 }
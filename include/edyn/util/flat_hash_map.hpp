@@ -0,0 +1,288 @@
+#ifndef EDYN_UTIL_FLAT_HASH_MAP_HPP
+#define EDYN_UTIL_FLAT_HASH_MAP_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <entt/entity/entity.hpp>
+#include "edyn/config/config.h"
+#include "edyn/util/entity_pair.hpp"
+
+namespace edyn {
+
+/**
+ * @brief Hashing and empty key for the keys of a `flat_hash_map`. The empty
+ * key marks free slots thus it cannot be inserted into the map.
+ */
+template<typename Key>
+struct flat_hash_traits;
+
+template<>
+struct flat_hash_traits<entt::entity> {
+    static entt::entity empty_key() {
+        return entt::null;
+    }
+
+    static uint64_t hash(entt::entity entity) {
+        // Fibonacci hashing. The map takes the upper bits of the result which
+        // depend on all bits of the entity, i.e. both identifier and version.
+        return static_cast<uint64_t>(entt::to_integral(entity)) * UINT64_C(0x9E3779B97F4A7C15);
+    }
+};
+
+template<>
+struct flat_hash_traits<entity_pair> {
+    static entity_pair empty_key() {
+        return {entt::null, entt::null};
+    }
+
+    static uint64_t hash(const entity_pair &pair) {
+        auto h = static_cast<uint64_t>(entt::to_integral(pair.first)) * UINT64_C(0x9E3779B97F4A7C15);
+        h ^= static_cast<uint64_t>(entt::to_integral(pair.second));
+        return h * UINT64_C(0xBF58476D1CE4E5B9);
+    }
+};
+
+template<>
+struct flat_hash_traits<uint64_t> {
+    static uint64_t empty_key() {
+        return UINT64_MAX;
+    }
+
+    static uint64_t hash(uint64_t key) {
+        // Fold upper bits onto lower bits first so that all fields of packed
+        // keys, such as grid coordinates, influence the result evenly.
+        key ^= key >> 32;
+        return key * UINT64_C(0x9E3779B97F4A7C15);
+    }
+};
+
+/**
+ * @brief An open-addressing hash map with linear probing which stores keys
+ * and values inline in a single array. Meant for small trivially copyable
+ * keys and values, such as entities. Erasing uses backward shifting thus
+ * there are no tombstones and lookups never degrade over time.
+ */
+template<typename Key, typename Value, typename Traits = flat_hash_traits<Key>>
+class flat_hash_map {
+    struct slot_type {
+        Key key;
+        Value value;
+    };
+
+    static constexpr size_t min_capacity = 16;
+    static constexpr size_t npos = SIZE_MAX;
+
+    size_t home_index(const Key &key) const {
+        return static_cast<size_t>(Traits::hash(key) >> m_shift);
+    }
+
+    size_t next_index(size_t index) const {
+        return (index + 1) & (m_slots.size() - 1);
+    }
+
+    bool is_free(size_t index) const {
+        return m_slots[index].key == Traits::empty_key();
+    }
+
+    size_t find_index(const Key &key) const {
+        if (m_slots.empty()) {
+            return npos;
+        }
+
+        for (auto i = home_index(key);; i = next_index(i)) {
+            if (is_free(i)) {
+                return npos;
+            }
+
+            if (m_slots[i].key == key) {
+                return i;
+            }
+        }
+    }
+
+    void rehash(size_t capacity) {
+        EDYN_ASSERT(capacity >= min_capacity && (capacity & (capacity - 1)) == 0);
+        auto old_slots = std::move(m_slots);
+        m_slots.assign(capacity, slot_type{Traits::empty_key(), Value{}});
+        m_shift = 64;
+
+        for (; capacity > 1; capacity >>= 1) {
+            --m_shift;
+        }
+
+        for (auto &slot : old_slots) {
+            if (slot.key == Traits::empty_key()) {
+                continue;
+            }
+
+            auto i = home_index(slot.key);
+
+            while (!is_free(i)) {
+                i = next_index(i);
+            }
+
+            m_slots[i] = slot;
+        }
+    }
+
+    void erase_at(size_t hole) {
+        auto mask = m_slots.size() - 1;
+
+        // Shift back the following elements in the cluster which are allowed
+        // to occupy the hole, i.e. the hole lies between their home slot and
+        // their current slot.
+        for (auto i = next_index(hole); !is_free(i); i = next_index(i)) {
+            auto home = home_index(m_slots[i].key);
+
+            if (((i - home) & mask) >= ((i - hole) & mask)) {
+                m_slots[hole] = m_slots[i];
+                hole = i;
+            }
+        }
+
+        m_slots[hole].key = Traits::empty_key();
+        --m_size;
+    }
+
+public:
+    bool contains(const Key &key) const {
+        return find_index(key) != npos;
+    }
+
+    Value & at(const Key &key) {
+        auto index = find_index(key);
+        EDYN_ASSERT(index != npos);
+        return m_slots[index].value;
+    }
+
+    const Value & at(const Key &key) const {
+        auto index = find_index(key);
+        EDYN_ASSERT(index != npos);
+        return m_slots[index].value;
+    }
+
+    /**
+     * @brief Inserts a value or replaces the existing value of a key.
+     * @return Whether the key was inserted.
+     */
+    bool insert_or_assign(const Key &key, const Value &value) {
+        EDYN_ASSERT(!(key == Traits::empty_key()));
+
+        // Keep load factor at or below one half to keep probe sequences short.
+        if ((m_size + 1) * 2 > m_slots.size()) {
+            rehash(m_slots.empty() ? min_capacity : m_slots.size() * 2);
+        }
+
+        for (auto i = home_index(key);; i = next_index(i)) {
+            if (is_free(i)) {
+                m_slots[i] = slot_type{key, value};
+                ++m_size;
+                return true;
+            }
+
+            if (m_slots[i].key == key) {
+                m_slots[i].value = value;
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief Erases a key.
+     * @return Whether the key was present.
+     */
+    bool erase(const Key &key) {
+        auto index = find_index(key);
+
+        if (index == npos) {
+            return false;
+        }
+
+        erase_at(index);
+        return true;
+    }
+
+    template<typename Predicate>
+    void erase_if(Predicate predicate) {
+        if (m_size == 0) {
+            return;
+        }
+
+        // Start right after a free slot so no cluster wraps around the
+        // starting point. Otherwise, backward shifting could move elements
+        // that were already visited into slots yet to be visited.
+        size_t start = 0;
+
+        while (!is_free(start)) {
+            ++start;
+        }
+
+        auto i = next_index(start);
+
+        for (size_t count = 1; count < m_slots.size();) {
+            if (!is_free(i) && predicate(m_slots[i].key, m_slots[i].value)) {
+                // Another element might have been shifted into this slot
+                // thus visit it again.
+                erase_at(i);
+                continue;
+            }
+
+            i = next_index(i);
+            ++count;
+        }
+    }
+
+    template<typename Func>
+    void each(Func func) const {
+        for (auto &slot : m_slots) {
+            if (!(slot.key == Traits::empty_key())) {
+                func(slot.key, slot.value);
+            }
+        }
+    }
+
+    void reserve(size_t count) {
+        auto capacity = min_capacity;
+
+        while (capacity < count * 2) {
+            capacity *= 2;
+        }
+
+        if (capacity > m_slots.size()) {
+            rehash(capacity);
+        }
+    }
+
+    void clear() {
+        for (auto &slot : m_slots) {
+            slot.key = Traits::empty_key();
+        }
+
+        m_size = 0;
+    }
+
+    void swap(flat_hash_map &other) {
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_size, other.m_size);
+        std::swap(m_shift, other.m_shift);
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+private:
+    std::vector<slot_type> m_slots;
+    size_t m_size {0};
+    unsigned m_shift {64};
+};
+
+}
+
+#endif // EDYN_UTIL_FLAT_HASH_MAP_HPP
@@ -7,7 +7,7 @@
 namespace edyn {
 
 template<typename It>
-entt::sparse_set collect_islands_from_residents(entt::registry &registry, It first_entity, It last_entity,
+entt::sparse_set collect_islands_from_residents(const entt::registry &registry, It first_entity, It last_entity,
                                                 bool include_multi_resident = true) {
     entt::sparse_set island_entities;
 
@@ -45,6 +45,11 @@ class component_operation_impl : public component_operation {
             EDYN_ASSERT(entities.size() == components.size());
         }
 
+        // Grow the pool once for the entire batch.
+        auto &storage = registry.storage<Component>();
+        storage.reserve(storage.size() + entities.size());
+        [[maybe_unused]] auto meta_type = entt::resolve<Component>();
+
         for (size_t i = 0; i < entities.size(); ++i) {
             auto remote_entity = entities[i];
 
@@ -54,7 +59,7 @@ class component_operation_impl : public component_operation {
 
             auto local_entity = entity_map.at(remote_entity);
 
-            if (!registry.valid(local_entity) || registry.all_of<Component>(local_entity)) {
+            if (!registry.valid(local_entity) || storage.contains(local_entity)) {
                 continue;
             }
 
@@ -62,7 +67,12 @@ class component_operation_impl : public component_operation {
                 registry.emplace<Component>(local_entity);
             } else {
                 auto comp = components[i];
-                internal::map_child_entity(registry, entity_map, comp);
+
+                if (meta_type) {
+                    internal::map_child_entity_meta(entity_map, meta_type, comp);
+                    internal::set_invalid_child_entity_to_null_meta(registry, meta_type, comp);
+                }
+
                 registry.emplace<Component>(local_entity, comp);
             }
         }
@@ -75,6 +85,12 @@ class component_operation_impl : public component_operation {
                     const entity_map &entity_map) const {
         EDYN_ASSERT(entities.size() == components.size());
 
+        // Access the pool directly instead of going through the registry for
+        // every entity. Resolving the meta type isn't free either thus do it
+        // once. Components without a meta type have no child entities.
+        auto &storage = registry.storage<Component>();
+        auto meta_type = entt::resolve<Component>();
+
         for (size_t i = 0; i < entities.size(); ++i) {
             auto remote_entity = entities[i];
 
@@ -84,13 +100,20 @@ class component_operation_impl : public component_operation {
 
             auto local_entity = entity_map.at(remote_entity);
 
-            if (!registry.valid(local_entity) || !registry.all_of<Component>(local_entity)) {
+            // The pool takes the entity version into account thus it won't
+            // contain entities that have been destroyed.
+            if (!storage.contains(local_entity)) {
                 continue;
             }
 
             auto comp = components[i];
-            internal::map_child_entity(registry, entity_map, comp);
-            registry.patch<Component>(local_entity, [&](auto &&current) {
+
+            if (meta_type) {
+                internal::map_child_entity_meta(entity_map, meta_type, comp);
+                internal::set_invalid_child_entity_to_null_meta(registry, meta_type, comp);
+            }
+
+            storage.patch(local_entity, [&](auto &&current) {
                 merge_component(current, comp);
             });
         }
@@ -86,6 +86,25 @@ class registry_operation_builder {
         }
     }
 
+    template<typename Component>
+    void insert_all_components(const entt::registry &registry, registry_op_type op_type) {
+        auto &op = find_or_create_component_operation<Component>(op_type);
+        auto &storage = registry.storage<Component>();
+        const entt::sparse_set &entities = storage;
+
+        // Entities and components are packed contiguously in the pool and
+        // are iterated in the same order, thus the entire pool can be copied
+        // in bulk instead of one entity at a time.
+        op.entities.insert(op.entities.end(), entities.begin(), entities.end());
+
+        if constexpr(!std::is_empty_v<Component>) {
+            if (op.operation != registry_op_type::remove) {
+                auto *components = static_cast<component_operation_impl<Component> *>(op.components.get());
+                components->components.insert(components->components.end(), storage.begin(), storage.end());
+            }
+        }
+    }
+
 public:
     virtual ~registry_operation_builder() = default;
 
@@ -118,8 +137,7 @@ public:
 
     template<typename Component>
     void emplace(const entt::registry &registry) {
-        auto view = registry.view<Component>();
-        emplace<Component>(registry, view.begin(), view.end());
+        insert_all_components<Component>(registry, registry_op_type::emplace);
     }
 
     template<typename Component>
@@ -137,8 +155,7 @@ public:
 
     template<typename Component>
     void replace(const entt::registry &registry) {
-        auto view = registry.view<Component>();
-        replace<Component>(registry, view.begin(), view.end());
+        insert_all_components<Component>(registry, registry_op_type::replace);
     }
 
     template<typename Component>
@@ -164,8 +181,7 @@ public:
 
     template<typename Component>
     void remove(const entt::registry &registry) {
-        auto view = registry.view<Component>();
-        remove<Component>(registry, view.begin(), view.end());
+        insert_all_components<Component>(registry, registry_op_type::remove);
     }
 
     template<typename Component>
@@ -231,7 +247,13 @@ public:
     }
 
     registry_operation_collection finish() {
-        return registry_operation_collection{std::move(operations)};
+        // The same kinds of operations are usually built every time, thus
+        // preallocate for the next batch.
+        auto num_operations = operations.size();
+        auto collection = registry_operation_collection{std::move(operations)};
+        operations = {};
+        operations.reserve(num_operations);
+        return collection;
     }
 
 private:
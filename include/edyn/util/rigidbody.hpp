@@ -62,6 +62,13 @@ struct rigidbody_def {
     // Mark all contacts involving this rigid body as continuous.
     bool continuous_contacts {false};
 
+    // Enable continuous collision detection for fast moving rigid bodies,
+    // which would otherwise tunnel through thin objects in a single step.
+    // Only applies to dynamic rigid bodies. Contact events are triggered
+    // early for these bodies since speculative contact points are created
+    // ahead of time. See `ccd_tag`.
+    bool ccd {false};
+
     // Whether this entity will be used for presentation and needs
     // position/orientation interpolation.
     bool presentation {true};
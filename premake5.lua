@@ -49,6 +49,7 @@ project "edyn"
         "src/edyn/collision/should_collide.cpp",
         "src/edyn/collision/collision_result.cpp",
         "src/edyn/collision/raycast.cpp",
+        "src/edyn/collision/shape_query.cpp",
         "src/edyn/constraints/contact_constraint.cpp",
         "src/edyn/constraints/distance_constraint.cpp",
         "src/edyn/constraints/soft_distance_constraint.cpp",
@@ -60,6 +61,8 @@ project "edyn"
         "src/edyn/constraints/null_constraint.cpp",
         "src/edyn/constraints/gravity_constraint.cpp",
         "src/edyn/dynamics/solver.cpp",
+        "src/edyn/dynamics/row_batch.cpp",
+        "src/edyn/dynamics/parallel_row_solver.cpp",
         "src/edyn/dynamics/restitution_solver.cpp",
         "src/edyn/sys/update_aabbs.cpp",
         "src/edyn/sys/update_rotated_meshes.cpp",
@@ -69,6 +72,7 @@ project "edyn"
         "src/edyn/util/rigidbody.cpp",
         "src/edyn/util/constraint_util.cpp",
         "src/edyn/util/shape_util.cpp",
+        "src/edyn/util/convex_hull.cpp",
         "src/edyn/util/aabb_util.cpp",
         "src/edyn/util/moment_of_inertia.cpp",
         "src/edyn/util/shape_volume.cpp",
@@ -89,6 +93,8 @@ project "edyn"
         "src/edyn/parallel/job_dispatcher.cpp",
         "src/edyn/parallel/job_scheduler.cpp",
         "src/edyn/parallel/job_queue_scheduler.cpp",
+        "src/edyn/parallel/worker.cpp",
+        "src/edyn/parallel/work_stealing_deque.cpp",
         "src/edyn/parallel/island_worker.cpp",
         "src/edyn/parallel/island_coordinator.cpp",
         "src/edyn/parallel/island_worker_context.cpp",
@@ -105,6 +111,7 @@ project "edyn"
         "src/edyn/networking/util/pool_snapshot.cpp",
         "src/edyn/networking/util/clock_sync.cpp",
         "src/edyn/networking/util/process_update_entity_map_packet.cpp",
+        "src/edyn/networking/util/interest_grid.cpp",
         "src/edyn/networking/networking_external.cpp",
         "src/edyn/context/settings.cpp",
         "src/edyn/edyn.cpp",
@@ -74,6 +74,9 @@ void broadphase_main::update() {
         m_np_tree.move(node.id, aabb);
     });
 
+    m_island_tree.update_wide_tree();
+    m_np_tree.update_wide_tree();
+
     // Search for island pairs with intersecting AABBs, i.e. the AABB of the root
     // node of their trees intersect.
     auto tree_view_not_sleeping_view = m_registry->view<tree_view>(exclude_sleeping);
@@ -131,6 +131,9 @@ void broadphase_worker::common_update() {
     kinematic_aabb_node_view.each([&](tree_resident &node, AABB &aabb) {
         m_np_tree.move(node.id, aabb);
     });
+
+    m_tree.update_wide_tree();
+    m_np_tree.update_wide_tree();
 }
 
 void broadphase_worker::update() {
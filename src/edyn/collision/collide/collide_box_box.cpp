@@ -33,69 +33,126 @@ void collide(const box_shape &shA, const box_shape &shB,
         quaternion_z(ornB)
     };
 
-    scalar distance = -EDYN_SCALAR_MAX;
-    vector3 sep_axis;
+    // Axes are indexed as: 0-2 faces of A, 3-5 faces of B, 6-14 edge pairs.
+    // Returns the separation along the axis or `-EDYN_SCALAR_MAX` if the
+    // edges are parallel.
+    auto axis_distance = [&](size_t axis_idx, vector3 &dir) -> scalar {
+        if (axis_idx < 3) {
+            auto i = axis_idx;
+            dir = axesA[i];
+            if (dot(posA - posB, dir) < 0) {
+                dir = -dir; // Point towards A.
+            }
 
-    // A's faces.
-    for (size_t i = 0; i < 3; ++i) {
-        auto dir = axesA[i];
-        if (dot(posA - posB, dir) < 0) {
-            dir = -dir; // Point towards A.
+            auto projA = dot(posA, dir) - shA.half_extents[i];
+            auto projB = shB.support_projection(posB, ornB, dir);
+            return projA - projB;
         }
 
-        auto projA = dot(posA, dir) - shA.half_extents[i];
-        auto projB = shB.support_projection(posB, ornB, dir);
-        auto dist = projA - projB;
+        if (axis_idx < 6) {
+            auto i = axis_idx - 3;
+            dir = axesB[i];
+            if (dot(posA - posB, dir) < 0) {
+                dir = -dir; // Point towards A.
+            }
 
-        if (dist > distance) {
-            distance = dist;
-            sep_axis = dir;
+            auto projA = -shA.support_projection(posA, ornA, -dir);
+            auto projB = dot(posB, dir) + shB.half_extents[i];
+            return projA - projB;
         }
-    }
 
-    // B's faces.
-    for (size_t i = 0; i < 3; ++i) {
-        auto dir = axesB[i];
+        auto i = (axis_idx - 6) / 3;
+        auto j = (axis_idx - 6) % 3;
+        dir = cross(axesA[i], axesB[j]);
+        auto dir_len_sqr = length_sqr(dir);
+
+        if (!(dir_len_sqr > EDYN_EPSILON)) {
+            return -EDYN_SCALAR_MAX;
+        }
+
+        dir /= std::sqrt(dir_len_sqr);
+
         if (dot(posA - posB, dir) < 0) {
-            dir = -dir; // Point towards A.
+            // Make it point towards A.
+            dir *= -1;
         }
 
         auto projA = -shA.support_projection(posA, ornA, -dir);
-        auto projB = dot(posB, dir) + shB.half_extents[i];
-        auto dist = projA - projB;
+        auto projB = shB.support_projection(posB, ornB, dir);
+        return projA - projB;
+    };
 
-        if (dist > distance) {
-            distance = dist;
-            sep_axis = dir;
-        }
-    }
+    using axis_kind = sat_axis_cache::axis_kind;
+    auto *cache = ctx.sat_cache;
+    scalar distance = -EDYN_SCALAR_MAX;
+    vector3 sep_axis;
+    bool found_axis = false;
 
-    // Edge-edge.
-    for (size_t i = 0; i < 3; ++i) {
-        for (size_t j = 0; j < 3; ++j) {
-            auto dir = cross(axesA[i], axesB[j]);
-            auto dir_len_sqr = length_sqr(dir);
+    // Test the axis of the previous step first.
+    if (cache && cache->kind != axis_kind::none) {
+        auto axis_idx = cache->kind == axis_kind::faceA ? cache->indexA :
+                         cache->kind == axis_kind::faceB ? 3 + cache->indexB :
+                         6 + cache->indexA * 3 + cache->indexB;
+        distance = axis_distance(axis_idx, sep_axis);
 
-            if (!(dir_len_sqr > EDYN_EPSILON)) {
-                continue;
-            }
+        if (distance > threshold) {
+            return;
+        }
 
-            dir /= std::sqrt(dir_len_sqr);
+        found_axis = distance > -EDYN_SCALAR_MAX &&
+                     cache->is_best(distance, posA, ornA, posB, ornB);
+    }
 
-            if (dot(posA - posB, dir) < 0) {
-                // Make it point towards A.
-                dir *= -1;
-            }
+    if (!found_axis) {
+        distance = -EDYN_SCALAR_MAX;
+        auto runner_up_distance = -EDYN_SCALAR_MAX;
+        size_t best_idx = 0;
 
-            auto projA = -shA.support_projection(posA, ornA, -dir);
-            auto projB = shB.support_projection(posB, ornB, dir);
-            auto dist = projA - projB;
+        for (size_t axis_idx = 0; axis_idx < 6; ++axis_idx) {
+            vector3 dir;
+            auto dist = axis_distance(axis_idx, dir);
 
             if (dist > distance) {
+                runner_up_distance = distance;
                 distance = dist;
                 sep_axis = dir;
+                best_idx = axis_idx;
+            } else if (dist > runner_up_distance) {
+                runner_up_distance = dist;
             }
         }
+
+        if (cache) {
+            auto kind = best_idx < 3 ? axis_kind::faceA : axis_kind::faceB;
+            auto idxA = best_idx < 3 ? best_idx : 0;
+            auto idxB = best_idx < 3 ? 0 : best_idx - 3;
+            cache->store(kind, static_cast<uint32_t>(idxA), static_cast<uint32_t>(idxB),
+                         runner_up_distance, length(shA.half_extents), length(shB.half_extents),
+                         posA, ornA, posB, ornB);
+        }
+    }
+
+    // Edge pairs are always tested since the cache can only tell whether a
+    // face normal is still the best among face normals.
+    auto face_distance = distance;
+    size_t best_edge_idx = 0;
+
+    for (size_t axis_idx = 6; axis_idx < 15; ++axis_idx) {
+        vector3 dir;
+        auto dist = axis_distance(axis_idx, dir);
+
+        if (dist > distance) {
+            distance = dist;
+            sep_axis = dir;
+            best_edge_idx = axis_idx;
+        }
+    }
+
+    if (cache && best_edge_idx > 0) {
+        cache->store(axis_kind::edges, static_cast<uint32_t>((best_edge_idx - 6) / 3),
+                     static_cast<uint32_t>((best_edge_idx - 6) % 3), face_distance,
+                     length(shA.half_extents), length(shB.half_extents),
+                     posA, ornA, posB, ornB);
     }
 
     if (distance > threshold) {
@@ -5,37 +5,126 @@
 #include "edyn/math/transform.hpp"
 #include "edyn/math/constants.hpp"
 #include "edyn/util/shape_util.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace edyn {
 
+// Calculates the separation along the normal of the i-th relevant face of A.
+// If `support_hint` is not null, the support point of B is found by hill
+// climbing starting at the vertex it points to, which is then updated.
+static
+scalar face_distance(const polyhedron_shape &shA, const rotated_mesh &rotatedA, const vector3 &posA,
+                     const polyhedron_shape &shB, const rotated_mesh &rotatedB, const vector3 &posB,
+                     size_t i, vector3 &dir, scalar &projectionA, scalar &projectionB,
+                     uint32_t *support_hint) {
+    auto normal_world = -rotatedA.relevant_normals[i]; // Normal pointing towards A.
+    auto vertexA = rotatedA.vertices[shA.mesh->relevant_indices[i]];
+    auto vertex_world = vertexA + posA;
+    auto projA = dot(vertex_world, normal_world);
+
+    // Find point on B that's furthest along the opposite direction
+    // of the face normal.
+    scalar projB;
+
+    if (support_hint) {
+        *support_hint = shB.mesh->hill_climb_support_vertex(rotatedB.vertices, normal_world, *support_hint);
+        projB = dot(rotatedB.vertices[*support_hint] + posB, normal_world);
+    } else {
+        projB = point_cloud_support_projection(rotatedB.vertices, normal_world) + dot(posB, normal_world);
+    }
+
+    dir = normal_world;
+    projectionA = projA;
+    projectionB = projB;
+    return projA - projB;
+}
+
+// Calculates the separation along the cross product of the i-th relevant edge
+// of A and the j-th relevant edge of B. Returns `-EDYN_SCALAR_MAX` if the
+// edges are parallel.
+static
+scalar edge_distance(const rotated_mesh &rotatedA, const vector3 &posA,
+                     const rotated_mesh &rotatedB, const vector3 &posB, size_t i, size_t j,
+                     vector3 &dir, scalar &projectionA, scalar &projectionB) {
+    dir = cross(rotatedA.relevant_edges[i], rotatedB.relevant_edges[j]);
+
+    if (!try_normalize(dir)) {
+        return -EDYN_SCALAR_MAX;
+    }
+
+    if (dot(posA - posB, dir) < 0) {
+        // Make it point towards A.
+        dir *= -1;
+    }
+
+    projectionA = -point_cloud_support_projection(rotatedA.vertices, -dir) + dot(posA, dir);
+    projectionB = point_cloud_support_projection(rotatedB.vertices, dir) + dot(posB, dir);
+    return projectionA - projectionB;
+}
+
+// Calculates the separation along the cross product of the i-th edge of A
+// and the j-th edge of B, i.e. indices into `convex_mesh::edges`, finding
+// the support points by hill climbing starting at the vertices of the edges.
+// Returns `-EDYN_SCALAR_MAX` if the edges are parallel.
+static
+scalar mesh_edge_distance(const polyhedron_shape &shA, const rotated_mesh &rotatedA, const vector3 &posA,
+                          const polyhedron_shape &shB, const rotated_mesh &rotatedB, const vector3 &posB,
+                          size_t i, size_t j, vector3 &dir, scalar &projectionA, scalar &projectionB) {
+    auto edgeA = shA.mesh->get_rotated_edge(rotatedA, i);
+    auto edgeB = shB.mesh->get_rotated_edge(rotatedB, j);
+    dir = cross(edgeA[1] - edgeA[0], edgeB[1] - edgeB[0]);
+
+    if (!try_normalize(dir)) {
+        return -EDYN_SCALAR_MAX;
+    }
+
+    if (dot(posA - posB, dir) < 0) {
+        // Make it point towards A.
+        dir *= -1;
+    }
+
+    auto idxA = shA.mesh->hill_climb_support_vertex(rotatedA.vertices, -dir, shA.mesh->edges[i * 2]);
+    auto idxB = shB.mesh->hill_climb_support_vertex(rotatedB.vertices, dir, shB.mesh->edges[j * 2]);
+    projectionA = dot(rotatedA.vertices[idxA] + posA, dir);
+    projectionB = dot(rotatedB.vertices[idxB] + posB, dir);
+    return projectionA - projectionB;
+}
+
 // Finds the direction that maximizes the projected distance between
-// A and B among all face normals of A.
+// A and B among all face normals of A. Also provides the index of the face
+// and the greatest distance among the other faces. If `hill_climbing` is set,
+// support points of B are found by hill climbing starting at the support
+// point of the previous face.
 static
 void max_support_direction(const polyhedron_shape &shA, const rotated_mesh &rotatedA, const vector3 &posA,
                            const polyhedron_shape &shB, const rotated_mesh &rotatedB, const vector3 &posB,
-                           vector3 &dir, scalar &distance, scalar &projectionA, scalar &projectionB) {
+                           bool hill_climbing, vector3 &dir, scalar &distance,
+                           scalar &projectionA, scalar &projectionB,
+                           size_t &index, scalar &runner_up_distance) {
     scalar max_proj_A = EDYN_SCALAR_MAX;
     scalar max_proj_B = -EDYN_SCALAR_MAX;
     scalar max_distance = -EDYN_SCALAR_MAX;
+    scalar runner_up = -EDYN_SCALAR_MAX;
     auto best_dir = vector3_zero;
+    size_t best_index = 0;
+    uint32_t support_hint = 0;
 
     for (size_t i = 0; i < rotatedA.relevant_normals.size(); ++i) {
-        auto normal_world = -rotatedA.relevant_normals[i]; // Normal pointing towards A.
-        auto vertexA = rotatedA.vertices[shA.mesh->relevant_indices[i]];
-        auto vertex_world = vertexA + posA;
-        auto projA = dot(vertex_world, normal_world);
-
-        // Find point on B that's furthest along the opposite direction
-        // of the face normal.
-        auto projB = point_cloud_support_projection(rotatedB.vertices, normal_world) + dot(posB, normal_world);
-
-        auto dist = projA - projB;
+        vector3 normal_world;
+        scalar projA, projB;
+        auto dist = face_distance(shA, rotatedA, posA, shB, rotatedB, posB, i, normal_world, projA, projB,
+                                  hill_climbing ? &support_hint : nullptr);
 
         if (dist > max_distance) {
+            runner_up = max_distance;
             max_distance = dist;
             max_proj_A = projA;
             max_proj_B = projB;
             best_dir = normal_world;
+            best_index = i;
+        } else if (dist > runner_up) {
+            runner_up = dist;
         }
     }
 
@@ -43,6 +132,118 @@ void max_support_direction(const polyhedron_shape &shA, const rotated_mesh &rota
     distance = max_distance;
     projectionA = max_proj_A;
     projectionB = max_proj_B;
+    index = best_index;
+    runner_up_distance = runner_up;
+}
+
+// Finds the edge pair of greatest separation among the pairs whose arcs on the
+// Gauss maps of A and of the negated B intersect, i.e. the pairs that form a
+// face of the Minkowski difference. Only these can provide the axis of
+// greatest separation. The edges of such a pair are the support features
+// along their cross product, thus the separation is calculated from their
+// vertices without searching for support points. Also provides the indices
+// of the edges.
+static
+void max_edge_distance_gauss_map(const polyhedron_shape &shA, const rotated_mesh &rotatedA,
+                                 const vector3 &posA, const quaternion &ornA,
+                                 const polyhedron_shape &shB, const rotated_mesh &rotatedB,
+                                 const vector3 &posB, const quaternion &ornB,
+                                 vector3 &dir, scalar &distance,
+                                 scalar &projectionA, scalar &projectionB,
+                                 size_t &indexA, size_t &indexB) {
+    auto &meshA = *shA.mesh;
+    auto &meshB = *shB.mesh;
+
+    // The rotated mesh only has the unique normals. All face normals are
+    // needed for the Gauss map. Reuse the buffers of previous calls in this
+    // thread to avoid allocations.
+    static thread_local std::vector<vector3> t_normalsA, t_normalsB;
+    auto &normalsA = t_normalsA;
+    auto &normalsB = t_normalsB;
+    normalsA.resize(meshA.normals.size());
+    normalsB.resize(meshB.normals.size());
+
+    for (size_t i = 0; i < normalsA.size(); ++i) {
+        normalsA[i] = rotate(ornA, meshA.normals[i]);
+    }
+
+    for (size_t i = 0; i < normalsB.size(); ++i) {
+        normalsB[i] = rotate(ornB, meshB.normals[i]);
+    }
+
+    scalar max_distance = -EDYN_SCALAR_MAX;
+
+    for (size_t i = 0; i < meshA.num_edges(); ++i) {
+        // The normals of the adjacent faces are the end points of the arc
+        // of the edge on the Gauss map.
+        auto &a = normalsA[meshA.edge_faces[i * 2]];
+        auto &b = normalsA[meshA.edge_faces[i * 2 + 1]];
+        auto b_x_a = cross(b, a);
+        auto edgeA = meshA.get_rotated_edge(rotatedA, i);
+        auto dirA = edgeA[1] - edgeA[0];
+
+        for (size_t j = 0; j < meshB.num_edges(); ++j) {
+            auto c = -normalsB[meshB.edge_faces[j * 2]];
+            auto d = -normalsB[meshB.edge_faces[j * 2 + 1]];
+            auto d_x_c = cross(d, c);
+
+            // The arcs intersect if the end points of each are on opposite
+            // sides of the plane of the other and they're in the same
+            // hemisphere.
+            auto cba = dot(c, b_x_a);
+            auto dba = dot(d, b_x_a);
+            auto adc = dot(a, d_x_c);
+            auto bdc = dot(b, d_x_c);
+
+            if (!(cba * dba < 0 && adc * bdc < 0 && cba * bdc > 0)) {
+                continue;
+            }
+
+            auto edgeB = meshB.get_rotated_edge(rotatedB, j);
+            auto dirB = edgeB[1] - edgeB[0];
+            auto axis = cross(dirA, dirB);
+
+            // Nearly parallel edges are covered by the face normals.
+            if (length_sqr(axis) < square(support_feature_tolerance) * length_sqr(dirA) * length_sqr(dirB)) {
+                continue;
+            }
+
+            axis = normalize(axis);
+
+            // Make it point outwards of A. The vertices are relative to the
+            // centroid, which is inside of A.
+            if (dot(axis, edgeA[0]) < 0) {
+                axis *= -1;
+            }
+
+            auto pointA = edgeA[0] + posA;
+            auto pointB = edgeB[0] + posB;
+            auto dist = dot(pointB - pointA, axis);
+
+            if (dist > max_distance) {
+                max_distance = dist;
+                // The separating axis points towards A.
+                dir = -axis;
+                projectionA = dot(pointA, dir);
+                projectionB = dot(pointB, dir);
+                indexA = i;
+                indexB = j;
+            }
+        }
+    }
+
+    distance = max_distance;
+}
+
+static
+scalar point_cloud_radius(const std::vector<vector3> &points) {
+    scalar radius_sqr = 0;
+
+    for (auto &point : points) {
+        radius_sqr = std::max(radius_sqr, length_sqr(point));
+    }
+
+    return std::sqrt(radius_sqr);
 }
 
 void collide(const polyhedron_shape &shA, const polyhedron_shape &shB,
@@ -60,59 +261,154 @@ void collide(const polyhedron_shape &shA, const polyhedron_shape &shB,
     auto &rmeshA = *shA.rotated;
     auto &rmeshB = *shB.rotated;
 
+    // Large meshes find support points by hill climbing over the vertex
+    // adjacency and only test the edge pairs which form a face of the
+    // Minkowski difference. In that case, the indices of edges stored in the
+    // cache refer to `convex_mesh::edges` instead of the relevant edges.
+    const auto hill_climbing = shA.mesh->vertices.size() >= large_polyhedron_min_vertices ||
+                               shB.mesh->vertices.size() >= large_polyhedron_min_vertices;
+    uint32_t support_hint = 0;
+    auto *support_hint_ptr = hill_climbing ? &support_hint : nullptr;
+
+    using axis_kind = sat_axis_cache::axis_kind;
+    auto *cache = ctx.sat_cache;
     scalar distance = -EDYN_SCALAR_MAX;
     scalar projectionA = EDYN_SCALAR_MAX;
     scalar projectionB = -EDYN_SCALAR_MAX;
     auto sep_axis = vector3_zero;
+    bool found_axis = false;
+
+    // Test the axis of the previous step first. The indices are validated
+    // in case the shapes changed.
+    if (cache && cache->kind != axis_kind::none) {
+        auto valid = true;
+
+        if (cache->kind == axis_kind::faceA && cache->indexA < rmeshA.relevant_normals.size()) {
+            distance = face_distance(shA, rmeshA, posA, shB, rmeshB, posB, cache->indexA,
+                                     sep_axis, projectionA, projectionB, support_hint_ptr);
+        } else if (cache->kind == axis_kind::faceB && cache->indexB < rmeshB.relevant_normals.size()) {
+            distance = face_distance(shB, rmeshB, posB, shA, rmeshA, posA, cache->indexB,
+                                     sep_axis, projectionB, projectionA, support_hint_ptr);
+            // Signs must be flipped because parameters were swapped above.
+            sep_axis *= -1;
+            projectionA *= -1;
+            projectionB *= -1;
+        } else if (cache->kind == axis_kind::edges && hill_climbing &&
+                   cache->indexA < shA.mesh->num_edges() &&
+                   cache->indexB < shB.mesh->num_edges()) {
+            distance = mesh_edge_distance(shA, rmeshA, posA, shB, rmeshB, posB,
+                                          cache->indexA, cache->indexB,
+                                          sep_axis, projectionA, projectionB);
+        } else if (cache->kind == axis_kind::edges && !hill_climbing &&
+                   cache->indexA < rmeshA.relevant_edges.size() &&
+                   cache->indexB < rmeshB.relevant_edges.size()) {
+            distance = edge_distance(rmeshA, posA, rmeshB, posB, cache->indexA, cache->indexB,
+                                     sep_axis, projectionA, projectionB);
+        } else {
+            valid = false;
+        }
 
-    // Find best support direction among all face normals of A.
-    max_support_direction(shA, rmeshA, posA, shB, rmeshB, posB,
-                          sep_axis, distance, projectionA, projectionB);
-
-    // Find best support direction among all face normals of B.
-    {
-        scalar dist, projA, projB;
-        vector3 dir;
-        max_support_direction(shB, rmeshB, posB, shA, rmeshA, posA,
-                              dir, dist, projB, projA);
+        if (valid) {
+            if (distance > threshold) {
+                return;
+            }
 
-        if (dist > distance) {
-            // Signs must be flipped because parameters were swapped above.
-            dir *= -1;
-            projA *= -1;
-            projB *= -1;
-
-            distance = dist;
-            projectionA = projA;
-            projectionB = projB;
-            sep_axis = dir;
+            found_axis = distance > -EDYN_SCALAR_MAX &&
+                         cache->is_best(distance, posA, ornA, posB, ornB);
         }
     }
 
-    // Edge vs edge.
-    for (auto &edgeA : rmeshA.relevant_edges) {
-        for (auto &edgeB : rmeshB.relevant_edges) {
-            auto dir = cross(edgeA, edgeB);
+    if (!found_axis) {
+        distance = -EDYN_SCALAR_MAX;
+        auto runner_up_distance = -EDYN_SCALAR_MAX;
+        auto best_kind = axis_kind::faceA;
+        size_t best_indexA = 0, best_indexB = 0;
+
+        // Find best support direction among all face normals of A.
+        max_support_direction(shA, rmeshA, posA, shB, rmeshB, posB, hill_climbing,
+                              sep_axis, distance, projectionA, projectionB,
+                              best_indexA, runner_up_distance);
+
+        // Find best support direction among all face normals of B.
+        {
+            scalar dist, projA, projB, runner_up;
+            vector3 dir;
+            size_t index;
+            max_support_direction(shB, rmeshB, posB, shA, rmeshA, posA, hill_climbing,
+                                  dir, dist, projB, projA, index, runner_up);
 
-            if (!try_normalize(dir)) {
-                continue;
-            }
-
-            if (dot(posA - posB, dir) < 0) {
-                // Make it point towards A.
+            if (dist > distance) {
+                // Signs must be flipped because parameters were swapped above.
                 dir *= -1;
+                projA *= -1;
+                projB *= -1;
+
+                runner_up_distance = std::max(distance, runner_up);
+                distance = dist;
+                projectionA = projA;
+                projectionB = projB;
+                sep_axis = dir;
+                best_kind = axis_kind::faceB;
+                best_indexB = index;
+            } else {
+                runner_up_distance = std::max(runner_up_distance, dist);
             }
+        }
 
-            auto projA = -point_cloud_support_projection(rmeshA.vertices, -dir);
-            auto projB = point_cloud_support_projection(rmeshB.vertices, dir) + dot(posB, dir);
-            auto dist = projA - projB;
+        if (cache) {
+            cache->store(best_kind, static_cast<uint32_t>(best_indexA), static_cast<uint32_t>(best_indexB),
+                         runner_up_distance, point_cloud_radius(rmeshA.vertices),
+                         point_cloud_radius(rmeshB.vertices), posA, ornA, posB, ornB);
+        }
+    }
+
+    // Edge vs edge. Always tested since the cache can only tell whether a face
+    // normal is still the best among face normals.
+    {
+        auto face_distance = distance;
+        auto found_edges = false;
+        size_t best_indexA = 0, best_indexB = 0;
+
+        if (hill_climbing) {
+            vector3 dir;
+            scalar dist, projA, projB;
+            size_t indexA = 0, indexB = 0;
+            max_edge_distance_gauss_map(shA, rmeshA, posA, ornA, shB, rmeshB, posB, ornB,
+                                        dir, dist, projA, projB, indexA, indexB);
 
             if (dist > distance) {
                 distance = dist;
                 projectionA = projA;
                 projectionB = projB;
                 sep_axis = dir;
+                found_edges = true;
+                best_indexA = indexA;
+                best_indexB = indexB;
             }
+        } else {
+            for (size_t i = 0; i < rmeshA.relevant_edges.size(); ++i) {
+                for (size_t j = 0; j < rmeshB.relevant_edges.size(); ++j) {
+                    vector3 dir;
+                    scalar projA, projB;
+                    auto dist = edge_distance(rmeshA, posA, rmeshB, posB, i, j, dir, projA, projB);
+
+                    if (dist > distance) {
+                        distance = dist;
+                        projectionA = projA;
+                        projectionB = projB;
+                        sep_axis = dir;
+                        found_edges = true;
+                        best_indexA = i;
+                        best_indexB = j;
+                    }
+                }
+            }
+        }
+
+        if (cache && found_edges) {
+            cache->store(axis_kind::edges, static_cast<uint32_t>(best_indexA), static_cast<uint32_t>(best_indexB),
+                         face_distance, point_cloud_radius(rmeshA.vertices),
+                         point_cloud_radius(rmeshB.vertices), posA, ornA, posB, ornB);
         }
     }
 
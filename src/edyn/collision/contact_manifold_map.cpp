@@ -10,7 +10,7 @@ contact_manifold_map::contact_manifold_map(entt::registry &registry) {
 }
 
 bool contact_manifold_map::contains(entity_pair pair) const {
-    return m_pair_map.count(pair) > 0;
+    return m_pair_map.contains(pair);
 }
 
 bool contact_manifold_map::contains(entt::entity first, entt::entity second) const {
@@ -31,9 +31,9 @@ void contact_manifold_map::on_construct_contact_manifold(entt::registry &registr
     // Insert all permutations.
     auto p = std::make_pair(manifold.body[0], manifold.body[1]);
     auto q = std::make_pair(manifold.body[1], manifold.body[0]);
-    EDYN_ASSERT(m_pair_map.count(p) == 0 && m_pair_map.count(q) == 0);
-    m_pair_map[p] = entity;
-    m_pair_map[q] = entity;
+    EDYN_ASSERT(!m_pair_map.contains(p) && !m_pair_map.contains(q));
+    m_pair_map.insert_or_assign(p, entity);
+    m_pair_map.insert_or_assign(q, entity);
 }
 
 void contact_manifold_map::on_destroy_contact_manifold(entt::registry &registry, entt::entity entity) {
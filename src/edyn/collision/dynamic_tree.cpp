@@ -125,6 +125,8 @@ tree_node_id_t dynamic_tree::best(const AABB &aabb) {
 }
 
 void dynamic_tree::insert(tree_node_id_t leaf) {
+    m_wide_tree_valid = false;
+
     if (m_root == null_tree_node_id) {
         m_root = leaf;
         m_nodes[m_root].parent = null_tree_node_id;
@@ -176,6 +178,8 @@ void dynamic_tree::insert(tree_node_id_t leaf) {
 }
 
 void dynamic_tree::remove(tree_node_id_t leaf) {
+    m_wide_tree_valid = false;
+
     if (leaf == m_root) {
         m_root = null_tree_node_id;
         return;
@@ -344,6 +348,13 @@ const tree_node & dynamic_tree::get_node(tree_node_id_t id) const {
     return m_nodes[id];
 }
 
+void dynamic_tree::update_wide_tree() {
+    if (!m_wide_tree_valid) {
+        m_wide_tree.build(*this, m_root, null_tree_node_id);
+        m_wide_tree_valid = true;
+    }
+}
+
 tree_view dynamic_tree::view() const {
     std::vector<tree_view::tree_node> view_nodes;
     view_nodes.reserve(m_nodes.size());
@@ -40,6 +40,8 @@ void narrowphase::update_async(job &completion_job) {
     auto body_view = m_registry->view<AABB, shape_index, position, orientation>();
     auto tr_view = m_registry->view<position, orientation>();
     auto vel_view = m_registry->view<angvel>();
+    auto linvel_view = m_registry->view<linvel>();
+    auto ccd_view = m_registry->view<ccd_tag>();
     auto rolling_view = m_registry->view<rolling_tag>();
     auto origin_view = m_registry->view<origin>();
     auto material_view = m_registry->view<material>();
@@ -56,7 +58,7 @@ void narrowphase::update_async(job &completion_job) {
     auto &dispatcher = job_dispatcher::global();
 
     parallel_for_async(dispatcher, size_t{0}, manifold_view.size(), size_t{1}, completion_job,
-            [this, body_view, tr_view, vel_view, rolling_view, origin_view,
+            [this, body_view, tr_view, vel_view, linvel_view, ccd_view, rolling_view, origin_view,
              manifold_view, events_view, orn_view, material_view, mesh_shape_view,
              paged_mesh_shape_view, shapes_views_tuple, dt](size_t index) {
         auto entity = manifold_view[index];
@@ -66,7 +68,9 @@ void narrowphase::update_async(job &completion_job) {
         auto &construction_info = m_cp_construction_infos[index];
         auto &destruction_info = m_cp_destruction_infos[index];
 
-        detect_collision(manifold.body, result, body_view, origin_view, shapes_views_tuple);
+        manifold.speculative = ccd_view.contains(manifold.body[0]) || ccd_view.contains(manifold.body[1]);
+        auto threshold = get_collision_threshold(manifold.body, linvel_view, ccd_view, dt);
+        detect_collision(manifold.body, result, body_view, origin_view, shapes_views_tuple, threshold, &manifold.sat_cache);
         process_collision(entity, manifold, events, result, tr_view, vel_view,
                           rolling_view, origin_view, orn_view, material_view,
                           mesh_shape_view, paged_mesh_shape_view, dt,
@@ -4,16 +4,20 @@
 #include "edyn/comp/orientation.hpp"
 #include "edyn/comp/origin.hpp"
 #include "edyn/comp/shape_index.hpp"
+#include "edyn/comp/collision_filter.hpp"
 #include "edyn/collision/tree_view.hpp"
 #include "edyn/collision/broadphase_main.hpp"
 #include "edyn/collision/broadphase_worker.hpp"
+#include "edyn/collision/ray_packet.hpp"
 #include "edyn/math/geom.hpp"
 #include "edyn/math/math.hpp"
 #include "edyn/math/transform.hpp"
 #include "edyn/shapes/shapes.hpp"
 #include "edyn/util/triangle_util.hpp"
 #include "edyn/util/tuple_util.hpp"
+#include "edyn/parallel/parallel_for.hpp"
 #include <entt/entity/registry.hpp>
+#include <algorithm>
 
 namespace edyn {
 
@@ -64,6 +68,158 @@ raycast_result raycast(entt::registry &registry, vector3 p0, vector3 p1) {
     return {result, hit_entity};
 }
 
+// Splits the rays into packets and raycasts them in parallel. `on_hit` is
+// called for each shape hit by a ray with the packet, the index of the ray in
+// the packet, the index of the ray in `rays`, the entity and the result. It
+// can modify the packet to shorten or retire the ray. Each packet is processed
+// by a single job thus `on_hit` can write to data owned by the ray without
+// synchronization.
+template<typename HitFunc>
+static void raycast_packets(entt::registry &registry, const raycast_ray *rays,
+                            size_t count, uint64_t mask, HitFunc on_hit) {
+    if (count == 0) {
+        return;
+    }
+
+    // Views are obtained once and only read from by all jobs.
+    auto index_view = registry.view<shape_index>();
+    auto tr_view = registry.view<position, orientation>();
+    auto origin_view = registry.view<origin>();
+    auto tree_view_view = registry.view<tree_view>();
+    auto filter_view = registry.view<collision_filter>();
+    auto shape_views_tuple = get_tuple_of_shape_views(registry);
+    const auto *bphase_main = registry.ctx().find<broadphase_main>();
+    const auto *bphase_worker = bphase_main != nullptr ? nullptr : &registry.ctx().at<broadphase_worker>();
+
+    auto process_packet = [&](size_t packet_idx) {
+        auto first = packet_idx * ray_packet::max_size;
+        auto last = std::min(first + ray_packet::max_size, count);
+
+        ray_packet packet;
+
+        for (auto i = first; i < last; ++i) {
+            packet.push_back(rays[i].p0, rays[i].p1);
+        }
+
+        packet.update_bounds();
+
+        auto raycast_shape = [&](entt::entity entity, uint32_t hit_mask) {
+            if (filter_view.contains(entity) &&
+                (filter_view.get<collision_filter>(entity).group & mask) == 0) {
+                return;
+            }
+
+            auto sh_idx = index_view.get<shape_index>(entity);
+            auto pos = origin_view.contains(entity) ? static_cast<vector3>(origin_view.get<origin>(entity)) : tr_view.get<position>(entity);
+            auto orn = tr_view.get<orientation>(entity);
+
+            visit_shape(sh_idx, entity, shape_views_tuple, [&](auto &&shape) {
+                for (auto m = hit_mask & packet.active; m != 0; m &= m - 1) {
+                    auto i = ray_packet::lowest_bit_index(m);
+                    auto &ray = rays[first + i];
+                    auto res = shape_raycast(shape, raycast_context{pos, orn, ray.p0, ray.p1});
+
+                    // Some shapes report intersections past the end of the
+                    // segment, which are not hits.
+                    if (res.fraction <= 1) {
+                        on_hit(packet, i, first + i, entity, res);
+                    }
+                }
+            });
+        };
+
+        // This function works both in the coordinator and in an island
+        // worker. Pick the available broadphase and raycast their AABB trees.
+        if (bphase_main != nullptr) {
+            bphase_main->raycast_islands_packet(packet, packet.active, [&](entt::entity island_entity, uint32_t island_mask) {
+                auto &tree_view = tree_view_view.get<edyn::tree_view>(island_entity);
+                tree_view.raycast_packet(packet, island_mask, [&](tree_node_id_t id, uint32_t hit_mask) {
+                    raycast_shape(tree_view.get_node(id).entity, hit_mask);
+                });
+            });
+
+            bphase_main->raycast_non_procedural_packet(packet, packet.active, raycast_shape);
+        } else {
+            bphase_worker->raycast_packet(packet, packet.active, raycast_shape);
+        }
+    };
+
+    auto num_packets = (count + ray_packet::max_size - 1) / ray_packet::max_size;
+
+    if (num_packets > 1) {
+        parallel_for(size_t{0}, num_packets, process_packet);
+    } else {
+        process_packet(0);
+    }
+}
+
+void raycast(entt::registry &registry, const raycast_ray *rays,
+             raycast_result *results, size_t count,
+             const raycast_options &options) {
+    std::fill(results, results + count, raycast_result{});
+
+    raycast_packets(registry, rays, count, options.mask,
+                    [&](ray_packet &packet, unsigned i, size_t ray_idx,
+                        entt::entity entity, const shape_raycast_result &res) {
+        auto &result = results[ray_idx];
+
+        if (res.fraction >= result.fraction) {
+            return;
+        }
+
+        static_cast<shape_raycast_result &>(result) = res;
+        result.entity = entity;
+
+        if (options.any_hit) {
+            packet.active &= ~(UINT32_C(1) << i);
+        } else {
+            // Only hits closer than this one matter from now on, thus
+            // shorten the ray so fewer nodes are visited.
+            auto &ray = rays[ray_idx];
+            packet.p1[i] = lerp(ray.p0, ray.p1, res.fraction);
+        }
+    });
+}
+
+void raycast_all(entt::registry &registry, const raycast_ray *rays,
+                 size_t count, raycast_hits &hits, uint64_t mask) {
+    // Hits are collected per packet in parallel and then grouped by ray.
+    auto num_packets = (count + ray_packet::max_size - 1) / ray_packet::max_size;
+    auto packet_hits = std::vector<std::vector<std::pair<size_t, raycast_result>>>(num_packets);
+
+    raycast_packets(registry, rays, count, mask,
+                    [&](ray_packet &, unsigned, size_t ray_idx,
+                        entt::entity entity, const shape_raycast_result &res) {
+        packet_hits[ray_idx / ray_packet::max_size].emplace_back(ray_idx, raycast_result{res, entity});
+    });
+
+    hits.offsets.assign(count + 1, 0);
+
+    for (auto &packet : packet_hits) {
+        for (auto &[ray_idx, hit] : packet) {
+            ++hits.offsets[ray_idx + 1];
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        hits.offsets[i + 1] += hits.offsets[i];
+    }
+
+    hits.hits.resize(hits.offsets[count]);
+    auto cursors = std::vector<size_t>(hits.offsets.begin(), hits.offsets.end() - 1);
+
+    for (auto &packet : packet_hits) {
+        for (auto &[ray_idx, hit] : packet) {
+            hits.hits[cursors[ray_idx]++] = hit;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        std::sort(hits.hits.begin() + hits.offsets[i], hits.hits.begin() + hits.offsets[i + 1],
+                  [](auto &&lhs, auto &&rhs) { return lhs.fraction < rhs.fraction; });
+    }
+}
+
 shape_raycast_result shape_raycast(const box_shape &box, const raycast_context &ctx) {
     // Reference: Real-Time Collision Detection - Christer Ericson,
     // Section 5.3.3 - Intersecting Ray or Segment Against Box.
@@ -0,0 +1,300 @@
+#include "edyn/collision/shape_query.hpp"
+#include "edyn/collision/collide.hpp"
+#include "edyn/collision/tree_view.hpp"
+#include "edyn/collision/broadphase_main.hpp"
+#include "edyn/collision/broadphase_worker.hpp"
+#include "edyn/comp/aabb.hpp"
+#include "edyn/comp/position.hpp"
+#include "edyn/comp/orientation.hpp"
+#include "edyn/comp/origin.hpp"
+#include "edyn/comp/shape_index.hpp"
+#include "edyn/math/math.hpp"
+#include "edyn/math/transform.hpp"
+#include "edyn/shapes/shapes.hpp"
+#include "edyn/sys/update_rotated_meshes.hpp"
+#include "edyn/util/aabb_util.hpp"
+#include <entt/entity/registry.hpp>
+#include <algorithm>
+#include <type_traits>
+#include <variant>
+
+namespace edyn {
+
+// Contacts closer than this are considered touching in a sweep.
+static constexpr auto sweep_tolerance = scalar(0.001);
+
+// Maximum number of conservative advancement steps per entity in a sweep. If
+// the sweep doesn't converge, the closest contact at the last position is
+// reported as the point of impact so that the swept shape never passes
+// through another.
+static constexpr unsigned max_sweep_iterations = 32;
+
+// Rotated meshes used in queries, which are reused between queries in the
+// same thread to avoid allocations. One is for the query shape and the other
+// for the shapes in the world.
+enum class query_mesh_slot {
+    query,
+    world
+};
+
+static rotated_mesh & query_rotated_mesh(query_mesh_slot slot) {
+    static thread_local rotated_mesh t_meshes[2];
+    return t_meshes[static_cast<size_t>(slot)];
+}
+
+// Polyhedra hold a pointer to their mesh rotated to their current orientation
+// which is only kept up to date in island workers. Queries rotate the mesh
+// themselves into one of the reusable meshes and pass a copy of the shape
+// pointing to it to `func`. The rotated mesh is valid until the next call
+// with the same slot.
+template<typename ShapeType, typename Func>
+static void with_rotated_mesh(const ShapeType &shape, const quaternion &orn,
+                              query_mesh_slot slot, Func func) {
+    if constexpr(std::is_same_v<ShapeType, polyhedron_shape>) {
+        auto &mesh = *shape.mesh;
+        auto &rotated = query_rotated_mesh(slot);
+        rotated.vertices.resize(mesh.vertices.size());
+        rotated.relevant_normals.resize(mesh.relevant_normals.size());
+        rotated.relevant_edges.resize(mesh.relevant_edges.size());
+        update_rotated_mesh(rotated, mesh, orn);
+
+        auto poly = shape;
+        poly.rotated = &rotated;
+        func(poly);
+    } else {
+        func(shape);
+    }
+}
+
+// Collides a query shape with a shape in the world. Compounds are decomposed
+// here instead of in `collide` so that the rotated meshes of polyhedra in
+// them can be provided. Polyhedra in the world must have been rotated with
+// `with_rotated_mesh` already.
+template<typename ShapeAType, typename ShapeBType>
+static void collide_query(const ShapeAType &shA, const ShapeBType &shB,
+                          const collision_context &ctx, collision_result &result) {
+    if constexpr(std::is_same_v<ShapeBType, compound_shape>) {
+        auto aabbA_in_B = aabb_to_object_space(ctx.aabbA, ctx.posB, ctx.ornB);
+
+        shB.visit(aabbA_in_B, [&](auto &&sh, auto node_index) {
+            auto &nodeB = shB.nodes[node_index];
+            auto child_ctx = ctx;
+            child_ctx.posB = to_world_space(nodeB.position, ctx.posB, ctx.ornB);
+            child_ctx.ornB = ctx.ornB * nodeB.orientation;
+
+            collision_result child_result;
+
+            with_rotated_mesh(sh, child_ctx.ornB, query_mesh_slot::world, [&](auto &&sh_rotated) {
+                collide_query(shA, sh_rotated, child_ctx, child_result);
+            });
+
+            // Transform pivots from the child node's space into B's space.
+            for (size_t i = 0; i < child_result.num_points; ++i) {
+                auto &child_point = child_result.point[i];
+                child_point.pivotB = to_world_space(child_point.pivotB, nodeB.position, nodeB.orientation);
+                result.maybe_add_point(child_point);
+            }
+        });
+    } else {
+        collide(shA, shB, ctx, result);
+    }
+}
+
+// Calls `func` for each entity whose AABB in the broadphase trees intersects
+// `aabb` and whose collision group matches `mask`, with its shape, position,
+// orientation and AABB.
+template<typename Func>
+static void visit_query_candidates(entt::registry &registry, const AABB &aabb,
+                                   uint64_t mask, Func func) {
+    auto index_view = registry.view<shape_index>();
+    auto tr_view = registry.view<position, orientation>();
+    auto origin_view = registry.view<origin>();
+    auto aabb_view = registry.view<AABB>();
+    auto filter_view = registry.view<collision_filter>();
+    auto tree_view_view = registry.view<tree_view>();
+    auto shape_views_tuple = get_tuple_of_shape_views(registry);
+
+    auto visit_entity = [&](entt::entity entity) {
+        if (filter_view.contains(entity) &&
+            (filter_view.get<collision_filter>(entity).group & mask) == 0) {
+            return;
+        }
+
+        auto sh_idx = index_view.get<shape_index>(entity);
+        auto pos = origin_view.contains(entity) ? static_cast<vector3>(origin_view.get<origin>(entity)) : tr_view.get<position>(entity);
+        auto orn = tr_view.get<orientation>(entity);
+        auto &entity_aabb = aabb_view.get<AABB>(entity);
+
+        visit_shape(sh_idx, entity, shape_views_tuple, [&](auto &&shape) {
+            func(entity, shape, pos, orn, entity_aabb);
+        });
+    };
+
+    // This function works both in the coordinator and in an island worker.
+    // Pick the available broadphase and query their AABB trees.
+    if (registry.ctx().find<broadphase_main>() != nullptr) {
+        auto &bphase = registry.ctx().at<broadphase_main>();
+        bphase.query_islands(aabb, [&](entt::entity island_entity) {
+            auto &tree_view = tree_view_view.get<edyn::tree_view>(island_entity);
+            tree_view.query(aabb, [&](tree_node_id_t id) {
+                visit_entity(tree_view.get_node(id).entity);
+            });
+        });
+
+        bphase.query_non_procedural(aabb, visit_entity);
+    } else {
+        auto &bphase = registry.ctx().at<broadphase_worker>();
+        bphase.query(aabb, visit_entity);
+    }
+}
+
+// Finds the fraction of `displacement` where shape A first touches shape B,
+// up to `max_fraction`, by conservative advancement. Each step collides the
+// shapes with a threshold that covers the rest of the sweep and advances A
+// until the closest approaching contact point would be touching. The
+// distances returned by the collision functions never exceed the actual
+// distance along the normal, thus A never moves past B.
+template<typename ShapeAType, typename ShapeBType>
+static bool sweep_against(const ShapeAType &shA, const vector3 &posA, const quaternion &ornA,
+                          const AABB &aabbA, const vector3 &displacement,
+                          const ShapeBType &shB, const vector3 &posB, const quaternion &ornB,
+                          const AABB &aabbB, scalar max_fraction, shape_sweep_result &result) {
+    auto sweep_length = length(displacement);
+    auto fraction = scalar(0);
+
+    for (unsigned iter = 0;; ++iter) {
+        auto offset = displacement * fraction;
+        auto threshold = sweep_length * (max_fraction - fraction) + sweep_tolerance;
+
+        // Mesh collision functions only look for triangles inside of A's
+        // AABB, thus it must be inflated by the threshold.
+        auto ctx = collision_context{};
+        ctx.posA = posA + offset;
+        ctx.ornA = ornA;
+        ctx.aabbA = aabbA.inset(-vector3_one * threshold);
+        ctx.aabbA.min += offset;
+        ctx.aabbA.max += offset;
+        ctx.posB = posB;
+        ctx.ornB = ornB;
+        ctx.aabbB = aabbB;
+        ctx.threshold = threshold;
+
+        collision_result collision;
+        collide_query(shA, shB, ctx, collision);
+
+        auto step = EDYN_SCALAR_MAX;
+        const collision_result::collision_point *closest = nullptr;
+
+        for (size_t i = 0; i < collision.num_points; ++i) {
+            auto &cp = collision.point[i];
+            // Rate at which the distance decreases per unit of fraction.
+            auto approach_speed = -dot(displacement, cp.normal);
+
+            if (approach_speed <= EDYN_EPSILON) {
+                continue;
+            }
+
+            if (cp.distance <= sweep_tolerance) {
+                closest = &cp;
+                step = 0;
+                break;
+            }
+
+            if (cp.distance / approach_speed < step) {
+                step = cp.distance / approach_speed;
+                closest = &cp;
+            }
+        }
+
+        if (step == EDYN_SCALAR_MAX || fraction + step > max_fraction) {
+            return false;
+        }
+
+        // Report the contact point which is touching or, if the sweep did
+        // not converge, which means the shapes are very close to touching,
+        // the one that limits the advancement at the current position.
+        if (step == 0 || iter + 1 == max_sweep_iterations) {
+            result.fraction = fraction;
+            result.normal = closest->normal;
+            result.point = to_world_space(closest->pivotB, posB, ornB);
+            return true;
+        }
+
+        fraction += step;
+    }
+}
+
+shape_sweep_result shape_sweep(entt::registry &registry, const query_shape_variant_t &shape,
+                               const vector3 &pos, const quaternion &orn,
+                               const vector3 &displacement, uint64_t mask) {
+    auto result = shape_sweep_result{};
+
+    if (length_sqr(displacement) <= EDYN_EPSILON) {
+        return result;
+    }
+
+    std::visit([&](auto &&query_shape) {
+        with_rotated_mesh(query_shape, orn, query_mesh_slot::query, [&](auto &&shA) {
+            auto aabbA = shape_aabb(shA, pos, orn);
+            auto aabb_end = AABB{aabbA.min + displacement, aabbA.max + displacement};
+            auto swept_aabb = enclosing_aabb(aabbA, aabb_end);
+
+            visit_query_candidates(registry, swept_aabb, mask,
+                                   [&](entt::entity entity, auto &&shB, const vector3 &posB,
+                                       const quaternion &ornB, const AABB &aabbB) {
+                // Only hits closer than the current one matter.
+                auto max_fraction = std::min(result.fraction, scalar(1));
+                auto candidate = shape_sweep_result{};
+
+                // The orientation of B does not change during the sweep,
+                // thus its mesh is rotated once.
+                with_rotated_mesh(shB, ornB, query_mesh_slot::world, [&](auto &&shB_rotated) {
+                    if (sweep_against(shA, pos, orn, aabbA, displacement,
+                                      shB_rotated, posB, ornB, aabbB, max_fraction, candidate) &&
+                        candidate.fraction < result.fraction) {
+                        result = candidate;
+                        result.entity = entity;
+                    }
+                });
+            });
+        });
+    }, shape);
+
+    return result;
+}
+
+void shape_overlap(entt::registry &registry, const query_shape_variant_t &shape,
+                   const vector3 &pos, const quaternion &orn,
+                   std::vector<entt::entity> &entities, uint64_t mask) {
+    entities.clear();
+
+    std::visit([&](auto &&query_shape) {
+        with_rotated_mesh(query_shape, orn, query_mesh_slot::query, [&](auto &&shA) {
+            auto aabbA = shape_aabb(shA, pos, orn);
+
+            visit_query_candidates(registry, aabbA, mask,
+                                   [&](entt::entity entity, auto &&shB, const vector3 &posB,
+                                       const quaternion &ornB, const AABB &aabbB) {
+                if (!intersect(aabbA, aabbB)) {
+                    return;
+                }
+
+                auto ctx = collision_context{pos, orn, aabbA, posB, ornB, aabbB, scalar(0)};
+                collision_result collision;
+
+                with_rotated_mesh(shB, ornB, query_mesh_slot::world, [&](auto &&shB_rotated) {
+                    collide_query(shA, shB_rotated, ctx, collision);
+                });
+
+                for (size_t i = 0; i < collision.num_points; ++i) {
+                    if (collision.point[i].distance <= 0) {
+                        entities.push_back(entity);
+                        break;
+                    }
+                }
+            });
+        });
+    }, shape);
+}
+
+}
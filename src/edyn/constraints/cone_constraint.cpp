@@ -9,8 +9,6 @@
 #include "edyn/comp/inertia.hpp"
 #include "edyn/comp/linvel.hpp"
 #include "edyn/comp/angvel.hpp"
-#include "edyn/comp/delta_linvel.hpp"
-#include "edyn/comp/delta_angvel.hpp"
 #include "edyn/comp/origin.hpp"
 #include "edyn/comp/tag.hpp"
 #include "edyn/dynamics/row_cache.hpp"
@@ -26,14 +24,15 @@ template<>
 void prepare_constraints<cone_constraint>(entt::registry &registry, row_cache &cache, scalar dt) {
     auto body_view = registry.view<position, orientation,
                                    linvel, angvel,
-                                   mass_inv, inertia_world_inv,
-                                   delta_linvel, delta_angvel>();
+                                   mass_inv, inertia_world_inv>();
     auto con_view = registry.view<cone_constraint>(entt::exclude_t<disabled_tag>{});
     auto origin_view = registry.view<origin>();
 
     con_view.each([&](cone_constraint &con) {
-        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA, dvA, dwA] = body_view.get(con.body[0]);
-        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB, dvB, dwB] = body_view.get(con.body[1]);
+        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA] = body_view.get(con.body[0]);
+        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB] = body_view.get(con.body[1]);
+        auto bodyA = cache.body_index(con.body[0]);
+        auto bodyB = cache.body_index(con.body[1]);
 
         auto originA = origin_view.contains(con.body[0]) ? origin_view.get<origin>(con.body[0]) : static_cast<vector3>(posA);
         auto originB = origin_view.contains(con.body[1]) ? origin_view.get<origin>(con.body[1]) : static_cast<vector3>(posB);
@@ -93,10 +92,7 @@ void prepare_constraints<cone_constraint>(entt::registry &registry, row_cache &c
 
         auto &row = cache.rows.emplace_back();
         row.J = J;
-        row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-        row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-        row.dvA = &dvA; row.dwA = &dwA;
-        row.dvB = &dvB; row.dwB = &dwB;
+        row.bodyA = bodyA; row.bodyB = bodyB;
         row.lower_limit = 0;
         row.upper_limit = large_scalar;
         row.impulse = con.impulse[row_idx++];
@@ -105,16 +101,13 @@ void prepare_constraints<cone_constraint>(entt::registry &registry, row_cache &c
         options.error = -error / dt;
         options.restitution = con.restitution;
 
-        prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-        warm_start(row);
+        prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+        warm_start(row, cache.bodies);
 
         if (con.bump_stop_stiffness > 0 && con.bump_stop_length > 0) {
             auto &row = cache.rows.emplace_back();
             row.J = J;
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
             auto bump_stop_deflection = con.bump_stop_length + error;
@@ -126,8 +119,8 @@ void prepare_constraints<cone_constraint>(entt::registry &registry, row_cache &c
             auto options = constraint_row_options{};
             options.error = -bump_stop_deflection / dt;
 
-            prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         cache.con_num_rows.push_back(row_idx);
@@ -4,8 +4,6 @@
 #include "edyn/comp/orientation.hpp"
 #include "edyn/comp/linvel.hpp"
 #include "edyn/comp/angvel.hpp"
-#include "edyn/comp/delta_linvel.hpp"
-#include "edyn/comp/delta_angvel.hpp"
 #include "edyn/comp/mass.hpp"
 #include "edyn/comp/inertia.hpp"
 #include "edyn/comp/origin.hpp"
@@ -24,16 +22,19 @@
 namespace edyn {
 
 namespace internal {
-    void solve_friction_row_pair(contact_friction_row_pair &friction_row_pair, constraint_row &normal_row) {
+    void solve_friction_row_pair(contact_friction_row_pair &friction_row_pair, constraint_row &normal_row,
+                                 std::vector<solver_body> &bodies) {
         vector2 delta_impulse;
         vector2 impulse;
         auto &friction_rows = friction_row_pair.row;
+        auto &bodyA = bodies[normal_row.bodyA];
+        auto &bodyB = bodies[normal_row.bodyB];
 
         for (auto i = 0; i < 2; ++i) {
             auto &friction_row = friction_rows[i];
             auto delta_relspd = get_relative_speed(friction_row.J,
-                                                   *normal_row.dvA, *normal_row.dwA,
-                                                   *normal_row.dvB, *normal_row.dwB);
+                                                   bodyA.dv, bodyA.dw,
+                                                   bodyB.dv, bodyB.dw);
             delta_impulse[i] = (friction_row.rhs - delta_relspd) * friction_row.eff_mass;
             impulse[i] = friction_row.impulse + delta_impulse[i];
         }
@@ -61,10 +62,10 @@ namespace internal {
             auto &friction_row = friction_rows[i];
             friction_row.impulse = impulse[i];
 
-            *normal_row.dvA += normal_row.inv_mA * friction_row.J[0] * delta_impulse[i];
-            *normal_row.dwA += normal_row.inv_IA * friction_row.J[1] * delta_impulse[i];
-            *normal_row.dvB += normal_row.inv_mB * friction_row.J[2] * delta_impulse[i];
-            *normal_row.dwB += normal_row.inv_IB * friction_row.J[3] * delta_impulse[i];
+            bodyA.dv += bodyA.inv_m * friction_row.J[0] * delta_impulse[i];
+            bodyA.dw += bodyA.inv_I * friction_row.J[1] * delta_impulse[i];
+            bodyB.dv += bodyB.inv_m * friction_row.J[2] * delta_impulse[i];
+            bodyB.dw += bodyB.inv_I * friction_row.J[3] * delta_impulse[i];
         }
     }
 }
@@ -72,8 +73,7 @@ namespace internal {
 template<>
 void prepare_constraints<contact_constraint>(entt::registry &registry, row_cache &cache, scalar dt) {
     auto body_view = registry.view<position, orientation, linvel, angvel,
-                                   mass_inv, inertia_world_inv,
-                                   delta_linvel, delta_angvel>();
+                                   mass_inv, inertia_world_inv>();
     auto con_view = registry.view<contact_constraint, contact_manifold>();
     auto origin_view = registry.view<origin>();
     auto roll_dir_view = registry.view<roll_direction>();
@@ -91,8 +91,14 @@ void prepare_constraints<contact_constraint>(entt::registry &registry, row_cache
     for (auto [entity, con, manifold] : con_view.each()) {
         auto body = manifold.body;
 
-        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA, dvA, dwA] = body_view.get(body[0]);
-        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB, dvB, dwB] = body_view.get(body[1]);
+        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA] = body_view.get(body[0]);
+        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB] = body_view.get(body[1]);
+        auto bodyA = cache.body_index(body[0]);
+        auto bodyB = cache.body_index(body[1]);
+        auto &dvA = cache.bodies[bodyA].dv;
+        auto &dwA = cache.bodies[bodyA].dw;
+        auto &dvB = cache.bodies[bodyB].dv;
+        auto &dwB = cache.bodies[bodyB].dw;
 
         auto originA = origin_view.contains(body[0]) ? origin_view.get<origin>(body[0]) : static_cast<vector3>(posA);
         auto originB = origin_view.contains(body[1]) ? origin_view.get<origin>(body[1]) : static_cast<vector3>(posB);
@@ -115,10 +121,7 @@ void prepare_constraints<contact_constraint>(entt::registry &registry, row_cache
             // Create normal row, i.e. non-penetration constraint.
             auto &normal_row = cache.rows.emplace_back();
             normal_row.J = {normal, cross(rA, normal), -normal, -cross(rB, normal)};
-            normal_row.inv_mA = inv_mA; normal_row.inv_IA = inv_IA;
-            normal_row.inv_mB = inv_mB; normal_row.inv_IB = inv_IB;
-            normal_row.dvA = &dvA; normal_row.dwA = &dwA;
-            normal_row.dvB = &dvB; normal_row.dwB = &dwB;
+            normal_row.bodyA = bodyA; normal_row.bodyB = bodyB;
             normal_row.impulse = cp.normal_impulse;
             normal_row.lower_limit = 0;
 
@@ -150,10 +153,24 @@ void prepare_constraints<contact_constraint>(entt::registry &registry, row_cache
                 // penetration after the following physics update.
                 normal_options.error = cp.distance / dt;
                 normal_row.upper_limit = large_scalar;
+
+                if (manifold.speculative) {
+                    // The entire gap is allowed to be closed in one step,
+                    // otherwise speculative contact points would slow down
+                    // bodies before they touch.
+                    normal_options.erp = 1;
+
+                    // Do not bounce if the gap will not be closed in this step.
+                    auto normal_relvel = get_relative_speed(normal_row.J, linvelA, angvelA, linvelB, angvelB);
+
+                    if (cp.distance + normal_relvel * dt > 0) {
+                        normal_options.restitution = 0;
+                    }
+                }
             }
 
-            prepare_row(normal_row, normal_options, linvelA, angvelA, linvelB, angvelB);
-            warm_start(normal_row);
+            prepare_row(normal_row, cache.bodies, normal_options, linvelA, angvelA, linvelB, angvelB);
+            warm_start(normal_row, cache.bodies);
 
             // Create special friction rows, always one pair per contact point.
             auto &friction_rows = ctx.friction_rows.emplace_back();
@@ -216,14 +233,11 @@ void prepare_constraints<contact_constraint>(entt::registry &registry, row_cache
             if (cp.spin_friction > 0) {
                 auto &spin_row = cache.rows.emplace_back();
                 spin_row.J = {vector3_zero, normal, vector3_zero, -normal};
-                spin_row.inv_mA = inv_mA; spin_row.inv_IA = inv_IA;
-                spin_row.inv_mB = inv_mB; spin_row.inv_IB = inv_IB;
-                spin_row.dvA = &dvA; spin_row.dwA = &dwA;
-                spin_row.dvB = &dvB; spin_row.dwB = &dwB;
+                spin_row.bodyA = bodyA; spin_row.bodyB = bodyB;
                 spin_row.impulse = cp.spin_friction_impulse;
 
-                prepare_row(spin_row, {}, linvelA, angvelA, linvelB, angvelB);
-                warm_start(spin_row);
+                prepare_row(spin_row, cache.bodies, {}, linvelA, angvelA, linvelB, angvelB);
+                warm_start(spin_row, cache.bodies);
             }
         }
 
@@ -258,11 +272,11 @@ void iterate_constraints<contact_constraint>(entt::registry &registry, row_cache
         manifold.each_point([&](contact_point &cp) {
             auto &normal_row = cache.rows[row_idx++];
             auto &friction_row_pair = ctx.friction_rows[cp_idx];
-            internal::solve_friction_row_pair(friction_row_pair, normal_row);
+            internal::solve_friction_row_pair(friction_row_pair, normal_row, cache.bodies);
 
             if (cp.roll_friction > 0) {
                 auto &roll_row_pair = ctx.roll_friction_rows[roll_idx++];
-                internal::solve_friction_row_pair(roll_row_pair, normal_row);
+                internal::solve_friction_row_pair(roll_row_pair, normal_row, cache.bodies);
             }
 
             if (cp.spin_friction > 0) {
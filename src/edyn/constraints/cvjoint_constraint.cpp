@@ -10,8 +10,6 @@
 #include "edyn/comp/inertia.hpp"
 #include "edyn/comp/linvel.hpp"
 #include "edyn/comp/angvel.hpp"
-#include "edyn/comp/delta_linvel.hpp"
-#include "edyn/comp/delta_angvel.hpp"
 #include "edyn/comp/origin.hpp"
 #include "edyn/comp/tag.hpp"
 #include "edyn/dynamics/row_cache.hpp"
@@ -59,14 +57,15 @@ template<>
 void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache &cache, scalar dt) {
     auto body_view = registry.view<position, orientation,
                                    linvel, angvel,
-                                   mass_inv, inertia_world_inv,
-                                   delta_linvel, delta_angvel>();
+                                   mass_inv, inertia_world_inv>();
     auto con_view = registry.view<cvjoint_constraint>(entt::exclude_t<disabled_tag>{});
     auto origin_view = registry.view<origin>();
 
     con_view.each([&](cvjoint_constraint &con) {
-        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA, dvA, dwA] = body_view.get(con.body[0]);
-        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB, dvB, dwB] = body_view.get(con.body[1]);
+        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA] = body_view.get(con.body[0]);
+        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB] = body_view.get(con.body[1]);
+        auto bodyA = cache.body_index(con.body[0]);
+        auto bodyB = cache.body_index(con.body[1]);
 
         auto originA = origin_view.contains(con.body[0]) ? origin_view.get<origin>(con.body[0]) : static_cast<vector3>(posA);
         auto originB = origin_view.contains(con.body[1]) ? origin_view.get<origin>(con.body[1]) : static_cast<vector3>(posB);
@@ -89,14 +88,11 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
             row.lower_limit = -large_scalar;
             row.upper_limit = large_scalar;
 
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
-            prepare_row(row, {}, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, {}, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         auto twist_axisA = rotate(ornA, con.frame[0].column(0));
@@ -108,10 +104,7 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
         {
             auto &row = cache.rows.emplace_back();
             row.J = {vector3_zero, twist_axisA, vector3_zero, -twist_axisB};
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
             auto angle = con.relative_angle(ornA, ornB, twist_axisA, twist_axisB);
@@ -147,8 +140,8 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
                 row.upper_limit = large_scalar;
             }
 
-            prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         // Twist bump stops.
@@ -165,10 +158,7 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
 
             auto &row = cache.rows.emplace_back();
             row.J = {vector3_zero, twist_axisA, vector3_zero, -twist_axisB};
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
             auto spring_force = con.twist_bump_stop_stiffness * bump_stop_deflection;
@@ -179,18 +169,15 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
             auto options = constraint_row_options{};
             options.error = -bump_stop_deflection / dt;
 
-            prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         // Twist stiffness.
         if (has_limit && con.twist_stiffness > 0) {
             auto &row = cache.rows.emplace_back();
             row.J = {vector3_zero, twist_axisA, vector3_zero, -twist_axisB};
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
             auto deflection = con.twist_angle - con.twist_rest_angle;
@@ -202,8 +189,8 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
             auto options = constraint_row_options{};
             options.error = -deflection / dt;
 
-            prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         // Twisting friction and damping.
@@ -212,10 +199,7 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
             // is employed for both damping and constant friction.
             auto &row = cache.rows.emplace_back();
             row.J = {vector3_zero, twist_axisA, vector3_zero, -twist_axisB};
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
             auto friction_impulse = con.twist_friction_torque * dt;
@@ -228,8 +212,8 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
             row.lower_limit = -friction_impulse;
             row.upper_limit = friction_impulse;
 
-            prepare_row(row, {}, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, {}, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         // Bending friction and damping.
@@ -251,10 +235,7 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
 
             auto &row = cache.rows.emplace_back();
             row.J = {vector3_zero, angvel_axis, vector3_zero, -angvel_axis};
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
             auto friction_impulse = con.bend_friction_torque * dt;
@@ -266,8 +247,8 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
             row.lower_limit = -friction_impulse;
             row.upper_limit = friction_impulse;
 
-            prepare_row(row, {}, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, {}, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         // Bending spring.
@@ -284,10 +265,7 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
 
             auto &row = cache.rows.emplace_back();
             row.J = {vector3_zero, bend_axis, vector3_zero, -bend_axis};
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
             auto spring_force = con.bend_stiffness * angle;
@@ -298,8 +276,8 @@ void prepare_constraints<cvjoint_constraint>(entt::registry &registry, row_cache
             auto options = constraint_row_options{};
             options.error = -angle / dt;
 
-            prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         cache.con_num_rows.push_back(row_idx);
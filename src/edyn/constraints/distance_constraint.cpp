@@ -6,8 +6,6 @@
 #include "edyn/comp/inertia.hpp"
 #include "edyn/comp/linvel.hpp"
 #include "edyn/comp/angvel.hpp"
-#include "edyn/comp/delta_linvel.hpp"
-#include "edyn/comp/delta_angvel.hpp"
 #include "edyn/comp/origin.hpp"
 #include "edyn/comp/tag.hpp"
 #include "edyn/dynamics/row_cache.hpp"
@@ -21,14 +19,15 @@ template<>
 void prepare_constraints<distance_constraint>(entt::registry &registry, row_cache &cache, scalar dt) {
     auto body_view = registry.view<position, orientation,
                                    linvel, angvel,
-                                   mass_inv, inertia_world_inv,
-                                   delta_linvel, delta_angvel>();
+                                   mass_inv, inertia_world_inv>();
     auto con_view = registry.view<distance_constraint>(entt::exclude_t<disabled_tag>{});
     auto origin_view = registry.view<origin>();
 
     con_view.each([&](entt::entity entity, distance_constraint &con) {
-        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA, dvA, dwA] = body_view.get(con.body[0]);
-        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB, dvB, dwB] = body_view.get(con.body[1]);
+        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA] = body_view.get(con.body[0]);
+        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB] = body_view.get(con.body[1]);
+        auto bodyA = cache.body_index(con.body[0]);
+        auto bodyB = cache.body_index(con.body[1]);
 
         auto originA = origin_view.contains(con.body[0]) ? origin_view.get<origin>(con.body[0]) : static_cast<vector3>(posA);
         auto originB = origin_view.contains(con.body[1]) ? origin_view.get<origin>(con.body[1]) : static_cast<vector3>(posB);
@@ -53,14 +52,11 @@ void prepare_constraints<distance_constraint>(entt::registry &registry, row_cach
         auto options = constraint_row_options{};
         options.error = scalar(0.5) * (dist_sqr - con.distance * con.distance) / dt;
 
-        row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-        row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-        row.dvA = &dvA; row.dwA = &dwA;
-        row.dvB = &dvB; row.dwB = &dwB;
+        row.bodyA = bodyA; row.bodyB = bodyB;
         row.impulse = con.impulse;
 
-        prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-        warm_start(row);
+        prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+        warm_start(row, cache.bodies);
 
         cache.con_num_rows.push_back(1);
     });
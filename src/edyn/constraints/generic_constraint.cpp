@@ -7,8 +7,6 @@
 #include "edyn/comp/inertia.hpp"
 #include "edyn/comp/linvel.hpp"
 #include "edyn/comp/angvel.hpp"
-#include "edyn/comp/delta_linvel.hpp"
-#include "edyn/comp/delta_angvel.hpp"
 #include "edyn/comp/origin.hpp"
 #include "edyn/comp/tag.hpp"
 #include "edyn/dynamics/row_cache.hpp"
@@ -25,14 +23,15 @@ template<>
 void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache &cache, scalar dt) {
     auto body_view = registry.view<position, orientation,
                                    linvel, angvel,
-                                   mass_inv, inertia_world_inv,
-                                   delta_linvel, delta_angvel>();
+                                   mass_inv, inertia_world_inv>();
     auto con_view = registry.view<generic_constraint>(entt::exclude_t<disabled_tag>{});
     auto origin_view = registry.view<origin>();
 
     con_view.each([&](generic_constraint &con) {
-        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA, dvA, dwA] = body_view.get(con.body[0]);
-        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB, dvB, dwB] = body_view.get(con.body[1]);
+        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA] = body_view.get(con.body[0]);
+        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB] = body_view.get(con.body[1]);
+        auto bodyA = cache.body_index(con.body[0]);
+        auto bodyB = cache.body_index(con.body[1]);
 
         auto originA = origin_view.contains(con.body[0]) ? origin_view.get<origin>(con.body[0]) : static_cast<vector3>(posA);
         auto originB = origin_view.contains(con.body[1]) ? origin_view.get<origin>(con.body[1]) : static_cast<vector3>(posB);
@@ -60,10 +59,7 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
 
                 auto &row = cache.rows.emplace_back();
                 row.J = J;
-                row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-                row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-                row.dvA = &dvA; row.dwA = &dwA;
-                row.dvB = &dvB; row.dwB = &dwB;
+                row.bodyA = bodyA; row.bodyB = bodyB;
                 row.impulse = con.impulse[row_idx++];
                 auto options = constraint_row_options{};
 
@@ -94,8 +90,8 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
                     row.upper_limit = large_scalar;
                 }
 
-                prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-                warm_start(row);
+                prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+                warm_start(row, cache.bodies);
             }
 
             // Linear bump stops.
@@ -112,10 +108,7 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
 
                 auto &row = cache.rows.emplace_back();
                 row.J = J;
-                row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-                row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-                row.dvA = &dvA; row.dwA = &dwA;
-                row.dvB = &dvB; row.dwB = &dwB;
+                row.bodyA = bodyA; row.bodyB = bodyB;
                 row.impulse = con.impulse[row_idx++];
 
                 auto spring_force = dof.bump_stop_stiffness * bump_stop_deflection;
@@ -126,18 +119,15 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
                 auto options = constraint_row_options{};
                 options.error = -bump_stop_deflection / dt;
 
-                prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-                warm_start(row);
+                prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+                warm_start(row, cache.bodies);
             }
 
             // Linear spring.
             if (dof.spring_stiffness > 0) {
                 auto &row = cache.rows.emplace_back();
                 row.J = J;
-                row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-                row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-                row.dvA = &dvA; row.dwA = &dwA;
-                row.dvB = &dvB; row.dwB = &dwB;
+                row.bodyA = bodyA; row.bodyB = bodyB;
                 row.impulse = con.impulse[row_idx++];
 
                 auto spring_deflection = offset_proj - dof.rest_offset;
@@ -149,18 +139,15 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
                 auto options = constraint_row_options{};
                 options.error = -spring_deflection / dt;
 
-                prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-                warm_start(row);
+                prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+                warm_start(row, cache.bodies);
             }
 
             // Linear damping and friction.
             if (dof.friction_force > 0 || dof.damping > 0) {
                 auto &row = cache.rows.emplace_back();
                 row.J = J;
-                row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-                row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-                row.dvA = &dvA; row.dwA = &dwA;
-                row.dvB = &dvB; row.dwB = &dwB;
+                row.bodyA = bodyA; row.bodyB = bodyB;
                 row.impulse = con.impulse[row_idx++];
 
                 auto friction_impulse = dof.friction_force * dt;
@@ -173,8 +160,8 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
                 row.lower_limit = -friction_impulse;
                 row.upper_limit = friction_impulse;
 
-                prepare_row(row, {}, linvelA, angvelA, linvelB, angvelB);
-                warm_start(row);
+                prepare_row(row, cache.bodies, {}, linvelA, angvelA, linvelB, angvelB);
+                warm_start(row, cache.bodies);
             }
         }
 
@@ -219,10 +206,7 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
 
                 auto &row = cache.rows.emplace_back();
                 row.J = J;
-                row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-                row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-                row.dvA = &dvA; row.dwA = &dwA;
-                row.dvB = &dvB; row.dwB = &dwB;
+                row.bodyA = bodyA; row.bodyB = bodyB;
                 row.impulse = con.impulse[row_idx++];
                 auto options = constraint_row_options{};
 
@@ -248,8 +232,8 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
                     row.upper_limit = large_scalar;
                 }
 
-                prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-                warm_start(row);
+                prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+                warm_start(row, cache.bodies);
             }
 
             // Angular bump stops.
@@ -266,10 +250,7 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
 
                 auto &row = cache.rows.emplace_back();
                 row.J = J;
-                row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-                row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-                row.dvA = &dvA; row.dwA = &dwA;
-                row.dvB = &dvB; row.dwB = &dwB;
+                row.bodyA = bodyA; row.bodyB = bodyB;
                 row.impulse = con.impulse[row_idx++];
 
                 auto spring_force = dof.bump_stop_stiffness * bump_stop_deflection;
@@ -280,18 +261,15 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
                 auto options = constraint_row_options{};
                 options.error = -bump_stop_deflection / dt;
 
-                prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-                warm_start(row);
+                prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+                warm_start(row, cache.bodies);
             }
 
             // Angular spring.
             if (dof.spring_stiffness > 0) {
                 auto &row = cache.rows.emplace_back();
                 row.J = J;
-                row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-                row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-                row.dvA = &dvA; row.dwA = &dwA;
-                row.dvB = &dvB; row.dwB = &dwB;
+                row.bodyA = bodyA; row.bodyB = bodyB;
                 row.impulse = con.impulse[row_idx++];
 
                 auto deflection = dof.current_angle - dof.rest_angle;
@@ -303,17 +281,14 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
                 auto options = constraint_row_options{};
                 options.error = -deflection / dt;
 
-                prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-                warm_start(row);
+                prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+                warm_start(row, cache.bodies);
             }
 
             if (dof.friction_torque > 0 || dof.damping > 0) {
                 auto &row = cache.rows.emplace_back();
                 row.J = J;
-                row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-                row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-                row.dvA = &dvA; row.dwA = &dwA;
-                row.dvB = &dvB; row.dwB = &dwB;
+                row.bodyA = bodyA; row.bodyB = bodyB;
                 row.impulse = con.impulse[row_idx++];
 
                 auto friction_impulse = dof.friction_torque * dt;
@@ -326,8 +301,8 @@ void prepare_constraints<generic_constraint>(entt::registry &registry, row_cache
                 row.lower_limit = -friction_impulse;
                 row.upper_limit = friction_impulse;
 
-                prepare_row(row, {}, linvelA, angvelA, linvelB, angvelB);
-                warm_start(row);
+                prepare_row(row, cache.bodies, {}, linvelA, angvelA, linvelB, angvelB);
+                warm_start(row, cache.bodies);
             }
         }
 
@@ -9,8 +9,6 @@
 #include "edyn/comp/inertia.hpp"
 #include "edyn/comp/linvel.hpp"
 #include "edyn/comp/angvel.hpp"
-#include "edyn/comp/delta_linvel.hpp"
-#include "edyn/comp/delta_angvel.hpp"
 #include "edyn/comp/origin.hpp"
 #include "edyn/comp/tag.hpp"
 #include "edyn/dynamics/row_cache.hpp"
@@ -39,14 +37,15 @@ template<>
 void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &cache, scalar dt) {
     auto body_view = registry.view<position, orientation,
                                    linvel, angvel,
-                                   mass_inv, inertia_world_inv,
-                                   delta_linvel, delta_angvel>();
+                                   mass_inv, inertia_world_inv>();
     auto con_view = registry.view<hinge_constraint>(entt::exclude_t<disabled_tag>{});
     auto origin_view = registry.view<origin>();
 
     con_view.each([&](hinge_constraint &con) {
-        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA, dvA, dwA] = body_view.get(con.body[0]);
-        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB, dvB, dwB] = body_view.get(con.body[1]);
+        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA] = body_view.get(con.body[0]);
+        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB] = body_view.get(con.body[1]);
+        auto bodyA = cache.body_index(con.body[0]);
+        auto bodyB = cache.body_index(con.body[1]);
 
         auto originA = origin_view.contains(con.body[0]) ? origin_view.get<origin>(con.body[0]) : static_cast<vector3>(posA);
         auto originB = origin_view.contains(con.body[1]) ? origin_view.get<origin>(con.body[1]) : static_cast<vector3>(posB);
@@ -69,14 +68,11 @@ void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &
             row.lower_limit = -EDYN_SCALAR_MAX;
             row.upper_limit = EDYN_SCALAR_MAX;
 
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
-            prepare_row(row, {}, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, {}, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         // Make relative angular velocity go to zero along directions orthogonal
@@ -90,14 +86,11 @@ void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &
             row.lower_limit = -EDYN_SCALAR_MAX;
             row.upper_limit = EDYN_SCALAR_MAX;
 
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
-            prepare_row(row, {}, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, {}, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         {
@@ -106,14 +99,11 @@ void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &
             row.lower_limit = -EDYN_SCALAR_MAX;
             row.upper_limit = EDYN_SCALAR_MAX;
 
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
-            prepare_row(row, {}, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, {}, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         // Handle angular limits and friction.
@@ -141,10 +131,7 @@ void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &
             // One row for angular limits.
             auto &row = cache.rows.emplace_back();
             row.J = {vector3_zero, hinge_axis, vector3_zero, -hinge_axis};
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
             auto limit_error = scalar{0};
@@ -165,8 +152,8 @@ void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &
             options.error = limit_error / dt;
             options.restitution = con.limit_restitution;
 
-            prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
 
             // Another row for bump stop spring.
             if (con.bump_stop_stiffness > 0 && con.bump_stop_angle > 0) {
@@ -183,10 +170,7 @@ void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &
                 if (bump_stop_deflection != 0) {
                     auto &row = cache.rows.emplace_back();
                     row.J = {vector3_zero, hinge_axis, vector3_zero, -hinge_axis};
-                    row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-                    row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-                    row.dvA = &dvA; row.dwA = &dwA;
-                    row.dvB = &dvB; row.dwB = &dwB;
+                    row.bodyA = bodyA; row.bodyB = bodyB;
                     row.impulse = con.impulse[row_idx++];
 
                     auto spring_force = con.bump_stop_stiffness * bump_stop_deflection;
@@ -197,8 +181,8 @@ void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &
                     auto options = constraint_row_options{};
                     options.error = -bump_stop_deflection / dt;
 
-                    prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-                    warm_start(row);
+                    prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+                    warm_start(row, cache.bodies);
                 }
             }
         }
@@ -206,10 +190,7 @@ void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &
         if (has_spring) {
             auto &row = cache.rows.emplace_back();
             row.J = {vector3_zero, hinge_axis, vector3_zero, -hinge_axis};
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
             auto deflection = con.angle - con.rest_angle;
@@ -221,8 +202,8 @@ void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &
             auto options = constraint_row_options{};
             options.error = -deflection / dt;
 
-            prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         if (has_friction) {
@@ -230,10 +211,7 @@ void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &
             // is employed for both damping and constant friction.
             auto &row = cache.rows.emplace_back();
             row.J = {vector3_zero, hinge_axis, vector3_zero, -hinge_axis};
-            row.inv_mA = inv_mA; row.inv_IA = inv_IA;
-            row.inv_mB = inv_mB; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dwA = &dwA;
-            row.dvB = &dvB; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[row_idx++];
 
             auto friction_impulse = con.friction_torque * dt;
@@ -246,8 +224,8 @@ void prepare_constraints<hinge_constraint>(entt::registry &registry, row_cache &
             row.lower_limit = -friction_impulse;
             row.upper_limit = friction_impulse;
 
-            prepare_row(row, {}, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, {}, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         cache.con_num_rows.push_back(row_idx);
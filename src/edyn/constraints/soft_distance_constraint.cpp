@@ -5,8 +5,6 @@
 #include "edyn/comp/inertia.hpp"
 #include "edyn/comp/linvel.hpp"
 #include "edyn/comp/angvel.hpp"
-#include "edyn/comp/delta_linvel.hpp"
-#include "edyn/comp/delta_angvel.hpp"
 #include "edyn/comp/origin.hpp"
 #include "edyn/comp/tag.hpp"
 #include "edyn/dynamics/row_cache.hpp"
@@ -25,8 +23,7 @@ void prepare_constraints<soft_distance_constraint>(entt::registry &registry,
                                                    row_cache &cache, scalar dt) {
     auto body_view = registry.view<position, orientation,
                                    linvel, angvel,
-                                   mass_inv, inertia_world_inv,
-                                   delta_linvel, delta_angvel>();
+                                   mass_inv, inertia_world_inv>();
     auto con_view = registry.view<soft_distance_constraint>(entt::exclude_t<disabled_tag>{});
     auto origin_view = registry.view<origin>();
 
@@ -34,8 +31,10 @@ void prepare_constraints<soft_distance_constraint>(entt::registry &registry,
     registry.ctx().emplace<row_start_index_soft_distance_constraint>().value = start_idx;
 
     con_view.each([&](soft_distance_constraint &con) {
-        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA, dvA, dwA] = body_view.get(con.body[0]);
-        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB, dvB, dwB] = body_view.get(con.body[1]);
+        auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA] = body_view.get(con.body[0]);
+        auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB] = body_view.get(con.body[1]);
+        auto bodyA = cache.body_index(con.body[0]);
+        auto bodyB = cache.body_index(con.body[1]);
 
         auto originA = origin_view.contains(con.body[0]) ? origin_view.get<origin>(con.body[0]) : static_cast<vector3>(posA);
         auto originB = origin_view.contains(con.body[1]) ? origin_view.get<origin>(con.body[1]) : static_cast<vector3>(posB);
@@ -70,17 +69,14 @@ void prepare_constraints<soft_distance_constraint>(entt::registry &registry,
             row.lower_limit = std::min(spring_impulse, scalar(0));
             row.upper_limit = std::max(scalar(0), spring_impulse);
 
-            row.inv_mA = inv_mA; row.inv_mB = inv_mB;
-            row.inv_IA = inv_IA; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dvB = &dvB;
-            row.dwA = &dwA; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[0];
 
             auto options = constraint_row_options{};
             options.error = spring_impulse > 0 ? -large_scalar : large_scalar;
 
-            prepare_row(row, options, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, options, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         {
@@ -100,14 +96,11 @@ void prepare_constraints<soft_distance_constraint>(entt::registry &registry,
             row.lower_limit = -impulse;
             row.upper_limit =  impulse;
 
-            row.inv_mA = inv_mA; row.inv_mB = inv_mB;
-            row.inv_IA = inv_IA; row.inv_IB = inv_IB;
-            row.dvA = &dvA; row.dvB = &dvB;
-            row.dwA = &dwA; row.dwB = &dwB;
+            row.bodyA = bodyA; row.bodyB = bodyB;
             row.impulse = con.impulse[1];
 
-            prepare_row(row, {}, linvelA, angvelA, linvelB, angvelB);
-            warm_start(row);
+            prepare_row(row, cache.bodies, {}, linvelA, angvelA, linvelB, angvelB);
+            warm_start(row, cache.bodies);
         }
 
         size_t num_rows = 2;
@@ -123,10 +116,12 @@ void iterate_constraints<soft_distance_constraint>(entt::registry &registry, row
     con_view.each([&](soft_distance_constraint &con) {
         // Adjust damping row limits to account for velocity changes during iterations.
         auto &damping_row = cache.rows[row_idx + 1];
-        auto delta_relspd = dot(damping_row.J[0], *damping_row.dvA) +
-                            dot(damping_row.J[1], *damping_row.dwA) +
-                            dot(damping_row.J[2], *damping_row.dvB) +
-                            dot(damping_row.J[3], *damping_row.dwB);
+        auto &bodyA = cache.bodies[damping_row.bodyA];
+        auto &bodyB = cache.bodies[damping_row.bodyB];
+        auto delta_relspd = dot(damping_row.J[0], bodyA.dv) +
+                            dot(damping_row.J[1], bodyA.dw) +
+                            dot(damping_row.J[2], bodyB.dv) +
+                            dot(damping_row.J[3], bodyB.dw);
 
         auto relspd = con.relspd + delta_relspd;
 
@@ -0,0 +1,262 @@
+#include "edyn/dynamics/parallel_row_solver.hpp"
+#include "edyn/dynamics/solver.hpp"
+#include "edyn/constraints/constraint_row.hpp"
+#include "edyn/util/constraint_util.hpp"
+#include "edyn/parallel/job.hpp"
+#include "edyn/parallel/job_dispatcher.hpp"
+#include "edyn/serialization/memory_archive.hpp"
+#include "edyn/config/config.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace edyn {
+
+// Minimum number of rows of the same color that are worth splitting among
+// workers. Smaller colors are solved in the calling thread.
+static constexpr size_t min_parallel_color_size = 128;
+
+// Number of rows each worker grabs at a time.
+static constexpr size_t parallel_row_chunk_size = 32;
+
+static bool is_dynamic(const solver_body &body) {
+    return body.inv_m > 0 || body.inv_I != matrix3x3_zero;
+}
+
+namespace detail {
+    struct parallel_color_context {
+        // Rows of the current color. Assigned before the color is published
+        // in `cursor` and not changed until all of its rows are solved.
+        constraint_row **rows;
+        std::vector<solver_body> *bodies;
+        std::atomic<size_t> count {0};
+
+        // Generation of the current color in the upper 32 bits and index of
+        // the next row to be solved in the lower 32 bits. While the context
+        // is being set up for a new color, the index is `retired_index`.
+        std::atomic<uint64_t> cursor {0};
+        std::atomic<size_t> completed {0};
+        std::atomic<scalar> residual {0};
+        std::atomic<int> ref_count {1};
+    };
+
+    static scalar solve_rows(constraint_row **rows, std::vector<solver_body> &bodies,
+                             size_t begin, size_t end) {
+        auto residual = scalar(0);
+
+        for (auto i = begin; i < end; ++i) {
+            auto &row = *rows[i];
+            auto delta_impulse = solve(row, bodies);
+            residual = std::max(get_row_residual(delta_impulse, row.eff_mass), residual);
+
+            // Static and kinematic bodies are shared among rows of the same
+            // color thus they must not be written to, even though the impulse
+            // would not change their velocity.
+            auto &bodyA = bodies[row.bodyA];
+            auto &bodyB = bodies[row.bodyB];
+
+            if (is_dynamic(bodyA)) {
+                bodyA.dv += bodyA.inv_m * row.J[0] * delta_impulse;
+                bodyA.dw += bodyA.inv_I * row.J[1] * delta_impulse;
+            }
+
+            if (is_dynamic(bodyB)) {
+                bodyB.dv += bodyB.inv_m * row.J[2] * delta_impulse;
+                bodyB.dw += bodyB.inv_I * row.J[3] * delta_impulse;
+            }
+        }
+
+        return residual;
+    }
+
+    static constexpr uint64_t retired_index = UINT32_MAX;
+
+    // Takes the next chunk of rows of the given generation. Fails if the
+    // context has moved on to another color or if all rows have been taken.
+    static bool claim_chunk(parallel_color_context &ctx, uint32_t generation,
+                            size_t &begin, size_t &end) {
+        auto cursor = ctx.cursor.load();
+
+        while (true) {
+            if (static_cast<uint32_t>(cursor >> 32) != generation) {
+                return false;
+            }
+
+            // The count might belong to a newer color if this one is done.
+            // The cursor is retired before the count is changed, thus if the
+            // new count was read, the exchange below fails. These operations
+            // must be sequentially consistent for that to hold.
+            auto count = ctx.count.load();
+            auto next = static_cast<size_t>(cursor & UINT32_MAX);
+
+            if (next >= count) {
+                return false;
+            }
+
+            if (ctx.cursor.compare_exchange_weak(cursor, cursor + parallel_row_chunk_size)) {
+                begin = next;
+                end = std::min(next + parallel_row_chunk_size, count);
+                return true;
+            }
+        }
+    }
+
+    static void run_parallel_color(parallel_color_context &ctx, uint32_t generation) {
+        size_t begin, end;
+
+        while (claim_chunk(ctx, generation, begin, end)) {
+            auto residual = solve_rows(ctx.rows, *ctx.bodies, begin, end);
+            auto max_residual = ctx.residual.load(std::memory_order_relaxed);
+
+            while (residual > max_residual &&
+                   !ctx.residual.compare_exchange_weak(max_residual, residual, std::memory_order_relaxed));
+
+            ctx.completed.fetch_add(end - begin, std::memory_order_release);
+        }
+    }
+
+    static void release_parallel_color(parallel_color_context *ctx) {
+        if (ctx->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete ctx;
+        }
+    }
+
+    static void parallel_color_job_func(job::data_type &data) {
+        auto archive = memory_input_archive(data.data(), data.size());
+        intptr_t ctx_ptr;
+        uint32_t generation;
+        archive(ctx_ptr, generation);
+        auto *ctx = reinterpret_cast<parallel_color_context *>(ctx_ptr);
+
+        run_parallel_color(*ctx, generation);
+        release_parallel_color(ctx);
+    }
+}
+
+parallel_row_solver::~parallel_row_solver() {
+    if (m_context) {
+        detail::release_parallel_color(m_context);
+    }
+}
+
+void parallel_row_solver::clear() {
+    m_rows.clear();
+    m_color_offsets.clear();
+    m_body_colors.clear();
+    m_row_colors.clear();
+}
+
+void parallel_row_solver::build(std::vector<constraint_row> &rows, const std::vector<solver_body> &bodies) {
+    clear();
+    m_body_colors.resize(bodies.size(), 0);
+
+    // Greedy coloring: assign to each row the lowest color not yet taken by
+    // any of its dynamic bodies. Static and kinematic bodies do not create
+    // conflicts since their velocities are never changed by the solver.
+    auto num_rows_per_color = std::vector<size_t>(max_colors + 1, 0);
+    m_row_colors.reserve(rows.size());
+
+    for (auto &row : rows) {
+        auto *colorsA = is_dynamic(bodies[row.bodyA]) ? &m_body_colors[row.bodyA] : nullptr;
+        auto *colorsB = is_dynamic(bodies[row.bodyB]) ? &m_body_colors[row.bodyB] : nullptr;
+        auto taken = (colorsA ? *colorsA : 0) | (colorsB ? *colorsB : 0);
+        auto color = max_colors;
+
+        for (size_t i = 0; i < max_colors; ++i) {
+            if ((taken & (uint64_t(1) << i)) == 0) {
+                color = i;
+                break;
+            }
+        }
+
+        if (color < max_colors) {
+            auto bit = uint64_t(1) << color;
+            if (colorsA) *colorsA |= bit;
+            if (colorsB) *colorsB |= bit;
+        }
+
+        m_row_colors.push_back(static_cast<uint8_t>(color));
+        ++num_rows_per_color[color];
+    }
+
+    // Sort rows by color while keeping the original order within each color.
+    m_color_offsets.resize(max_colors + 2);
+    m_color_offsets[0] = 0;
+
+    for (size_t i = 0; i < max_colors + 1; ++i) {
+        m_color_offsets[i + 1] = m_color_offsets[i] + num_rows_per_color[i];
+    }
+
+    auto insert_idx = m_color_offsets;
+    m_rows.resize(rows.size());
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        m_rows[insert_idx[m_row_colors[i]]++] = &rows[i];
+    }
+}
+
+scalar parallel_row_solver::solve(job_dispatcher &dispatcher, std::vector<solver_body> &bodies) {
+    auto num_workers = dispatcher.num_workers();
+    auto residual = scalar(0);
+
+    for (size_t color = 0; color < num_colors(); ++color) {
+        auto begin = m_color_offsets[color];
+        auto end = m_color_offsets[color + 1];
+        auto count = end - begin;
+        auto is_uncolored = color == max_colors;
+
+        if (count < min_parallel_color_size || is_uncolored || num_workers == 0) {
+            residual = std::max(detail::solve_rows(m_rows.data(), bodies, begin, end), residual);
+            continue;
+        }
+
+        // The context is shared with the jobs. Jobs that start after all rows
+        // of their color have been solved return immediately. This thread
+        // only waits for rows that are being solved, never for jobs that
+        // haven't started, which could otherwise lead to a deadlock if all
+        // workers were waiting on each other.
+        if (m_context == nullptr) {
+            m_context = new detail::parallel_color_context;
+        }
+
+        auto &ctx = *m_context;
+        auto generation = ++m_generation;
+
+        // Jobs of the previous color might still be trying to claim rows.
+        // Retire its cursor before anything else is changed so they can't
+        // take rows of this color before it is published.
+        ctx.cursor.store(static_cast<uint64_t>(generation) << 32 | detail::retired_index);
+        ctx.rows = m_rows.data() + begin;
+        ctx.bodies = &bodies;
+        ctx.count.store(count);
+        ctx.completed.store(0, std::memory_order_relaxed);
+        ctx.residual.store(0, std::memory_order_relaxed);
+        ctx.cursor.store(static_cast<uint64_t>(generation) << 32);
+
+        auto num_jobs = std::min(num_workers, count / parallel_row_chunk_size);
+        auto child_job = job();
+        child_job.func = &detail::parallel_color_job_func;
+        auto archive = fixed_memory_output_archive(child_job.data.data(), child_job.data.size());
+        auto ctx_ptr = reinterpret_cast<intptr_t>(m_context);
+        archive(ctx_ptr, generation);
+
+        for (size_t i = 0; i < num_jobs; ++i) {
+            ctx.ref_count.fetch_add(1, std::memory_order_relaxed);
+            dispatcher.async(child_job);
+        }
+
+        detail::run_parallel_color(ctx, generation);
+
+        // Barrier. Rows of the next color might depend on the results of
+        // the rows in this color.
+        while (ctx.completed.load(std::memory_order_acquire) < count) {
+            std::this_thread::yield();
+        }
+
+        residual = std::max(ctx.residual.load(std::memory_order_relaxed), residual);
+    }
+
+    return residual;
+}
+
+}
@@ -8,8 +8,6 @@
 #include "edyn/comp/orientation.hpp"
 #include "edyn/comp/linvel.hpp"
 #include "edyn/comp/angvel.hpp"
-#include "edyn/comp/delta_linvel.hpp"
-#include "edyn/comp/delta_angvel.hpp"
 #include "edyn/comp/origin.hpp"
 #include "edyn/comp/mass.hpp"
 #include "edyn/comp/inertia.hpp"
@@ -20,12 +18,21 @@
 #include "edyn/comp/graph_node.hpp"
 #include "edyn/context/settings.hpp"
 #include <entt/entity/registry.hpp>
+#include <algorithm>
 
 namespace edyn {
 
+// Whether a contact point is touching or will touch in the next step.
+// Speculative contact points which will not, must not bounce. Points in
+// manifolds without speculative contacts are always treated as touching.
+static bool will_touch(const contact_manifold &manifold, const contact_point &cp,
+                       scalar normal_relvel, scalar dt) {
+    return !manifold.speculative || cp.distance <= 0 || cp.distance + normal_relvel * dt <= 0;
+}
+
 template<typename BodyView, typename OriginView>
 scalar get_manifold_min_relvel(const contact_manifold &manifold, const BodyView &body_view,
-                               const OriginView &origin_view) {
+                               const OriginView &origin_view, scalar dt) {
     if (manifold.num_points == 0) {
         return EDYN_SCALAR_MAX;
     }
@@ -51,7 +58,10 @@ scalar get_manifold_min_relvel(const contact_manifold &manifold, const BodyView
         auto vB = linvelB + cross(angvelB, rB);
         auto relvel = vA - vB;
         auto normal_relvel = dot(relvel, normal);
-        min_relvel = std::min(normal_relvel, min_relvel);
+
+        if (will_touch(manifold, cp, normal_relvel, dt)) {
+            min_relvel = std::min(normal_relvel, min_relvel);
+        }
     }
 
     return min_relvel;
@@ -59,8 +69,7 @@ scalar get_manifold_min_relvel(const contact_manifold &manifold, const BodyView
 
 bool solve_restitution_iteration(entt::registry &registry, scalar dt, unsigned individual_iterations) {
     auto body_view = registry.view<position, orientation, linvel, angvel,
-                                   mass_inv, inertia_world_inv,
-                                   delta_linvel, delta_angvel>();
+                                   mass_inv, inertia_world_inv>();
     auto origin_view = registry.view<origin>();
     auto restitution_view = registry.view<contact_manifold_with_restitution>();
     auto manifold_view = registry.view<contact_manifold>();
@@ -80,7 +89,7 @@ bool solve_restitution_iteration(entt::registry &registry, scalar dt, unsigned i
 
     for (auto entity : restitution_view) {
         auto &manifold = manifold_view.get<contact_manifold>(entity);
-        auto local_min_relvel = get_manifold_min_relvel(manifold, body_view, origin_view);
+        auto local_min_relvel = get_manifold_min_relvel(manifold, body_view, origin_view, dt);
 
         if (local_min_relvel < min_relvel) {
             min_relvel = local_min_relvel;
@@ -107,19 +116,41 @@ bool solve_restitution_iteration(entt::registry &registry, scalar dt, unsigned i
     // Reuse collections of rows to prevent a high number of allocations.
     auto normal_rows = std::vector<constraint_row>{};
     auto friction_row_pairs = std::vector<internal::contact_friction_row_pair>{};
+    auto bodies = std::vector<solver_body>{};
+    auto body_entities = std::vector<entt::entity>{};
 
     normal_rows.reserve(10);
     friction_row_pairs.reserve(10);
+    bodies.reserve(10);
+    body_entities.reserve(10);
+
+    // Groups are small thus a linear search is good enough to find the solver
+    // body of a rigid body.
+    auto get_body_index = [&](entt::entity entity, scalar inv_m, const matrix3x3 &inv_I) {
+        auto it = std::find(body_entities.begin(), body_entities.end(), entity);
+
+        if (it != body_entities.end()) {
+            return static_cast<uint32_t>(std::distance(body_entities.begin(), it));
+        }
+
+        body_entities.push_back(entity);
+        bodies.push_back({vector3_zero, vector3_zero, inv_m, inv_I});
+        return static_cast<uint32_t>(bodies.size() - 1);
+    };
 
     auto solveManifolds = [&](const std::vector<entt::entity> &manifold_entities) {
         normal_rows.clear();
         friction_row_pairs.clear();
+        bodies.clear();
+        body_entities.clear();
 
         for (auto manifold_entity : manifold_entities) {
             auto &manifold = manifold_view.get<contact_manifold>(manifold_entity);
 
-            auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA, dvA, dwA] = body_view.get(manifold.body[0]);
-            auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB, dvB, dwB] = body_view.get(manifold.body[1]);
+            auto [posA, ornA, linvelA, angvelA, inv_mA, inv_IA] = body_view.get(manifold.body[0]);
+            auto [posB, ornB, linvelB, angvelB, inv_mB, inv_IB] = body_view.get(manifold.body[1]);
+            auto bodyA = get_body_index(manifold.body[0], inv_mA, inv_IA);
+            auto bodyB = get_body_index(manifold.body[1], inv_mB, inv_IB);
 
             auto originA = origin_view.contains(manifold.body[0]) ? origin_view.get<origin>(manifold.body[0]) : static_cast<vector3>(posA);
             auto originB = origin_view.contains(manifold.body[1]) ? origin_view.get<origin>(manifold.body[1]) : static_cast<vector3>(posB);
@@ -137,17 +168,22 @@ bool solve_restitution_iteration(entt::registry &registry, scalar dt, unsigned i
 
                 auto &normal_row = normal_rows.emplace_back();
                 normal_row.J = {normal, cross(rA, normal), -normal, -cross(rB, normal)};
-                normal_row.inv_mA = inv_mA; normal_row.inv_IA = inv_IA;
-                normal_row.inv_mB = inv_mB; normal_row.inv_IB = inv_IB;
-                normal_row.dvA = &dvA; normal_row.dwA = &dwA;
-                normal_row.dvB = &dvB; normal_row.dwB = &dwB;
+                normal_row.bodyA = bodyA; normal_row.bodyB = bodyB;
                 normal_row.lower_limit = 0;
                 normal_row.upper_limit = large_scalar;
 
                 auto normal_options = constraint_row_options{};
-                normal_options.restitution = cp.restitution;
+                auto normal_relvel = get_relative_speed(normal_row.J, linvelA, angvelA, linvelB, angvelB);
+
+                if (will_touch(manifold, cp, normal_relvel, dt)) {
+                    normal_options.restitution = cp.restitution;
+                } else {
+                    // Only prevent penetration in the next step.
+                    normal_options.error = cp.distance / dt;
+                    normal_options.erp = 1;
+                }
 
-                prepare_row(normal_row, normal_options, linvelA, angvelA, linvelB, angvelB);
+                prepare_row(normal_row, bodies, normal_options, linvelA, angvelA, linvelB, angvelB);
 
                 auto &friction_row_pair = friction_row_pairs.emplace_back();
                 friction_row_pair.friction_coefficient = cp.friction;
@@ -168,11 +204,11 @@ bool solve_restitution_iteration(entt::registry &registry, scalar dt, unsigned i
         for (unsigned iter = 0; iter < individual_iterations; ++iter) {
             for (size_t row_idx = 0; row_idx < normal_rows.size(); ++row_idx) {
                 auto &normal_row = normal_rows[row_idx];
-                auto delta_impulse = solve(normal_row);
-                apply_impulse(delta_impulse, normal_row);
+                auto delta_impulse = solve(normal_row, bodies);
+                apply_impulse(delta_impulse, normal_row, bodies);
 
                 auto &friction_row_pair = friction_row_pairs[row_idx];
-                internal::solve_friction_row_pair(friction_row_pair, normal_row);
+                internal::solve_friction_row_pair(friction_row_pair, normal_row, bodies);
             }
         }
 
@@ -201,19 +237,10 @@ bool solve_restitution_iteration(entt::registry &registry, scalar dt, unsigned i
         }
 
         // Apply delta velocities.
-        for (auto manifold_entity : manifold_entities) {
-            auto &manifold = manifold_view.get<contact_manifold>(manifold_entity);
-
-            for (auto body_entity : manifold.body) {
-                // There are duplicates among all manifold bodies but this
-                // operation is idempotent since the delta velocity is set
-                // to zero.
-                auto [lv, av, dv, dw] = body_view.get<linvel, angvel, delta_linvel, delta_angvel>(body_entity);
-                lv += dv;
-                dv = vector3_zero;
-                av += dw;
-                dw = vector3_zero;
-            }
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            auto [lv, av] = body_view.get<linvel, angvel>(body_entities[i]);
+            lv += bodies[i].dv;
+            av += bodies[i].dw;
         }
     };
 
@@ -258,7 +285,7 @@ bool solve_restitution_iteration(entt::registry &registry, scalar dt, unsigned i
             auto &manifold = manifold_view.get<contact_manifold>(edge_entity);
 
             // Ignore manifolds which are not penetrating fast enough.
-            auto local_min_relvel = get_manifold_min_relvel(manifold, body_view, origin_view);
+            auto local_min_relvel = get_manifold_min_relvel(manifold, body_view, origin_view, dt);
 
             if (local_min_relvel < relvel_threshold) {
                 manifold_entities.push_back(edge_entity);
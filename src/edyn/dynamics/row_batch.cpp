@@ -0,0 +1,239 @@
+#include "edyn/dynamics/row_batch.hpp"
+#include "edyn/dynamics/solver.hpp"
+#include "edyn/constraints/constraint_row.hpp"
+#include "edyn/math/matrix3x3.hpp"
+#include "edyn/config/config.h"
+#include <algorithm>
+#include <limits>
+
+namespace edyn {
+
+// Maximum number of partially filled batches which are considered when
+// inserting a new row. Older batches are closed and padded once this limit
+// is reached, which keeps construction linear in the number of rows.
+static constexpr size_t max_open_row_batches = 16;
+
+static constexpr auto null_body_key = std::numeric_limits<uint32_t>::max();
+
+static uint32_t dynamic_body_key(const std::vector<solver_body> &bodies, uint32_t index) {
+    // Static and kinematic bodies never have their delta velocities changed by
+    // an impulse thus they can be shared among rows in the same batch.
+    auto &body = bodies[index];
+
+    if (body.inv_m > 0 || body.inv_I != matrix3x3_zero) {
+        return index;
+    }
+
+    return null_body_key;
+}
+
+static void insert_row(constraint_row_batch &batch, constraint_row &row,
+                       const std::vector<solver_body> &bodies) {
+    auto l = batch.num_rows++;
+    EDYN_ASSERT(l < row_batch_width);
+
+    auto &bodyA = bodies[row.bodyA];
+    auto &bodyB = bodies[row.bodyB];
+    const std::array<vector3, 4> MJ = {
+        bodyA.inv_m * row.J[0],
+        bodyA.inv_I * row.J[1],
+        bodyB.inv_m * row.J[2],
+        bodyB.inv_I * row.J[3]
+    };
+
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t c = 0; c < 3; ++c) {
+            batch.J[i][c][l] = row.J[i][c];
+            batch.MJ[i][c][l] = MJ[i][c];
+        }
+    }
+
+    batch.eff_mass[l] = row.eff_mass;
+    batch.rhs[l] = row.rhs;
+    batch.lower_limit[l] = row.lower_limit;
+    batch.upper_limit[l] = row.upper_limit;
+    batch.impulse[l] = row.impulse;
+    batch.rows[l] = &row;
+    batch.bodyA[l] = row.bodyA;
+    batch.bodyB[l] = row.bodyB;
+}
+
+static void pad_batch(constraint_row_batch &batch) {
+    for (auto l = batch.num_rows; l < row_batch_width; ++l) {
+        for (size_t i = 0; i < 4; ++i) {
+            for (size_t c = 0; c < 3; ++c) {
+                batch.J[i][c][l] = 0;
+                batch.MJ[i][c][l] = 0;
+            }
+        }
+
+        batch.eff_mass[l] = 0;
+        batch.rhs[l] = 0;
+        batch.lower_limit[l] = 0;
+        batch.upper_limit[l] = 0;
+        batch.impulse[l] = 0;
+        batch.rows[l] = nullptr;
+        batch.bodyA[l] = batch.bodyB[l] = null_body_key;
+    }
+}
+
+void row_batch_cache::clear() {
+    m_batches.clear();
+    m_batch_bodies.clear();
+}
+
+void row_batch_cache::build(std::vector<constraint_row> &rows, const std::vector<solver_body> &bodies) {
+    clear();
+    m_batches.reserve(rows.size() / row_batch_width + 1);
+
+    // Indices of batches that still have free lanes, oldest first.
+    std::vector<size_t> open_batches;
+
+    for (auto &row : rows) {
+        auto keyA = dynamic_body_key(bodies, row.bodyA);
+        auto keyB = dynamic_body_key(bodies, row.bodyB);
+        auto inserted = false;
+
+        for (auto it = open_batches.begin(); it != open_batches.end(); ++it) {
+            auto batch_idx = *it;
+            auto &batch = m_batches[batch_idx];
+            auto &batch_bodies = m_batch_bodies[batch_idx];
+            auto bodies_end = batch_bodies.begin() + batch.num_rows * 2;
+
+            auto conflicts = std::any_of(batch_bodies.begin(), bodies_end, [&](uint32_t key) {
+                return key != null_body_key && (key == keyA || key == keyB);
+            });
+
+            if (conflicts) {
+                continue;
+            }
+
+            batch_bodies[batch.num_rows * 2] = keyA;
+            batch_bodies[batch.num_rows * 2 + 1] = keyB;
+            insert_row(batch, row, bodies);
+
+            if (batch.num_rows == row_batch_width) {
+                open_batches.erase(it);
+            }
+
+            inserted = true;
+            break;
+        }
+
+        if (inserted) {
+            continue;
+        }
+
+        if (open_batches.size() == max_open_row_batches) {
+            open_batches.erase(open_batches.begin());
+        }
+
+        auto &batch = m_batches.emplace_back();
+        batch.num_rows = 0;
+        auto &batch_bodies = m_batch_bodies.emplace_back();
+        batch_bodies[0] = keyA;
+        batch_bodies[1] = keyB;
+        insert_row(batch, row, bodies);
+        open_batches.push_back(m_batches.size() - 1);
+    }
+
+    for (auto &batch : m_batches) {
+        pad_batch(batch);
+    }
+}
+
+static scalar solve_batch(constraint_row_batch &batch, std::vector<solver_body> &bodies) {
+    using lane_array = constraint_row_batch::lane_array;
+    constexpr auto W = row_batch_width;
+
+    // Gather delta velocities into SoA form. Padding lanes remain zero.
+    std::array<constraint_row_batch::vector_lanes, 4> dv {};
+
+    for (size_t l = 0; l < batch.num_rows; ++l) {
+        auto &bodyA = bodies[batch.bodyA[l]];
+        auto &bodyB = bodies[batch.bodyB[l]];
+
+        for (size_t c = 0; c < 3; ++c) {
+            dv[0][c][l] = bodyA.dv[c];
+            dv[1][c][l] = bodyA.dw[c];
+            dv[2][c][l] = bodyB.dv[c];
+            dv[3][c][l] = bodyB.dw[c];
+        }
+    }
+
+    // The loops below are over lanes of contiguous arrays with no
+    // dependencies between lanes so they map directly to SIMD instructions.
+    lane_array delta_relvel {};
+
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t c = 0; c < 3; ++c) {
+            for (size_t l = 0; l < W; ++l) {
+                delta_relvel[l] += batch.J[i][c][l] * dv[i][c][l];
+            }
+        }
+    }
+
+    lane_array delta_impulse;
+
+    for (size_t l = 0; l < W; ++l) {
+        auto impulse = batch.impulse[l] + (batch.rhs[l] - delta_relvel[l]) * batch.eff_mass[l];
+        impulse = std::min(std::max(impulse, batch.lower_limit[l]), batch.upper_limit[l]);
+        delta_impulse[l] = impulse - batch.impulse[l];
+        batch.impulse[l] = impulse;
+    }
+
+    auto residual = scalar(0);
+
+    for (size_t l = 0; l < batch.num_rows; ++l) {
+        residual = std::max(get_row_residual(delta_impulse[l], batch.eff_mass[l]), residual);
+    }
+
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t c = 0; c < 3; ++c) {
+            for (size_t l = 0; l < W; ++l) {
+                dv[i][c][l] += batch.MJ[i][c][l] * delta_impulse[l];
+            }
+        }
+    }
+
+    // Scatter delta velocities back. Lanes never share a dynamic body thus
+    // the order of the writes doesn't matter.
+    for (size_t l = 0; l < batch.num_rows; ++l) {
+        auto &bodyA = bodies[batch.bodyA[l]];
+        auto &bodyB = bodies[batch.bodyB[l]];
+
+        for (size_t c = 0; c < 3; ++c) {
+            bodyA.dv[c] = dv[0][c][l];
+            bodyA.dw[c] = dv[1][c][l];
+            bodyB.dv[c] = dv[2][c][l];
+            bodyB.dw[c] = dv[3][c][l];
+        }
+    }
+
+    return residual;
+}
+
+scalar row_batch_cache::solve(std::vector<solver_body> &bodies) {
+    auto residual = scalar(0);
+
+    for (auto &batch : m_batches) {
+        // Limits might have been updated in `iterate_constraints`, e.g.
+        // spinning friction depends on the current normal impulse. The
+        // right hand side changes between substeps.
+        for (size_t l = 0; l < batch.num_rows; ++l) {
+            batch.rhs[l] = batch.rows[l]->rhs;
+            batch.lower_limit[l] = batch.rows[l]->lower_limit;
+            batch.upper_limit[l] = batch.rows[l]->upper_limit;
+        }
+
+        residual = std::max(solve_batch(batch, bodies), residual);
+
+        for (size_t l = 0; l < batch.num_rows; ++l) {
+            batch.rows[l]->impulse = batch.impulse[l];
+        }
+    }
+
+    return residual;
+}
+
+}
@@ -8,26 +8,35 @@
 #include "edyn/sys/update_inertias.hpp"
 #include "edyn/sys/update_origins.hpp"
 #include "edyn/constraints/constraint_row.hpp"
+#include "edyn/comp/position.hpp"
+#include "edyn/comp/orientation.hpp"
 #include "edyn/comp/linvel.hpp"
 #include "edyn/comp/angvel.hpp"
 #include "edyn/comp/delta_linvel.hpp"
 #include "edyn/comp/delta_angvel.hpp"
+#include "edyn/comp/mass.hpp"
+#include "edyn/comp/inertia.hpp"
+#include "edyn/comp/tag.hpp"
 #include "edyn/collision/contact_point.hpp"
 #include "edyn/collision/contact_manifold.hpp"
 #include "edyn/constraints/constraint.hpp"
 #include "edyn/util/constraint_util.hpp"
 #include "edyn/dynamics/restitution_solver.hpp"
 #include "edyn/context/settings.hpp"
+#include "edyn/parallel/job_dispatcher.hpp"
 #include <entt/entity/registry.hpp>
+#include <algorithm>
 #include <type_traits>
 
 namespace edyn {
 
-scalar solve(constraint_row &row) {
-    auto delta_relvel = dot(row.J[0], *row.dvA) +
-                        dot(row.J[1], *row.dwA) +
-                        dot(row.J[2], *row.dvB) +
-                        dot(row.J[3], *row.dwB);
+scalar solve(constraint_row &row, const std::vector<solver_body> &bodies) {
+    auto &bodyA = bodies[row.bodyA];
+    auto &bodyB = bodies[row.bodyB];
+    auto delta_relvel = dot(row.J[0], bodyA.dv) +
+                        dot(row.J[1], bodyA.dw) +
+                        dot(row.J[2], bodyB.dv) +
+                        dot(row.J[3], bodyB.dw);
     auto delta_impulse = (row.rhs - delta_relvel) * row.eff_mass;
     auto impulse = row.impulse + delta_impulse;
 
@@ -44,6 +53,25 @@ scalar solve(constraint_row &row) {
     return delta_impulse;
 }
 
+static void gather_solver_bodies(entt::registry &registry, row_cache &cache) {
+    auto body_view = registry.view<mass_inv, inertia_world_inv, delta_linvel, delta_angvel>();
+    cache.bodies.reserve(body_view.size_hint());
+
+    for (auto [entity, inv_m, inv_I, dv, dw] : body_view.each()) {
+        cache.insert_body(entity, {dv, dw, inv_m, inv_I});
+    }
+}
+
+static void scatter_solver_bodies(entt::registry &registry, const row_cache &cache) {
+    auto body_view = registry.view<delta_linvel, delta_angvel, dynamic_tag>();
+
+    for (auto [entity, dv, dw] : body_view.each()) {
+        auto &body = cache.bodies[cache.body_index(entity)];
+        dv = body.dv;
+        dw = body.dw;
+    }
+}
+
 template<typename C>
 void update_impulse(entt::registry &registry, row_cache &cache, size_t &con_idx, size_t &row_idx) {
     auto con_view = registry.view<C>(entt::exclude_t<disabled_tag>{});
@@ -131,6 +159,107 @@ void update_impulses(entt::registry &registry, row_cache &cache) {
     }, constraints_tuple);
 }
 
+scalar solver::solve_iteration(bool solve_parallel) {
+    auto &settings = m_registry->ctx().at<edyn::settings>();
+
+    if (solve_parallel) {
+        return m_parallel_rows.solve(job_dispatcher::global(), m_row_cache.bodies);
+    } else if (settings.solver_row_batching) {
+        return m_row_batches.solve(m_row_cache.bodies);
+    }
+
+    auto residual = scalar(0);
+
+    for (auto &row : m_row_cache.rows) {
+        auto delta_impulse = solve(row, m_row_cache.bodies);
+        apply_impulse(delta_impulse, row, m_row_cache.bodies);
+        residual = std::max(get_row_residual(delta_impulse, row.eff_mass), residual);
+    }
+
+    return residual;
+}
+
+void solver::solve_substeps(unsigned num_substeps, bool solve_parallel, scalar dt) {
+    auto &registry = *m_registry;
+    auto &settings = registry.ctx().at<edyn::settings>();
+    auto &rows = m_row_cache.rows;
+    auto &bodies = m_row_cache.bodies;
+    auto h = dt / num_substeps;
+    auto num_iterations = std::max(1u, (settings.num_solver_velocity_iterations + num_substeps - 1) / num_substeps);
+
+    m_substep_bodies.assign(bodies.size(), {vector3_zero, vector3_zero, vector3_zero, vector3_zero});
+
+    // Kinematic bodies also move during the substeps, which affects the
+    // position error of the rows they're part of. Include all solver bodies,
+    // as in `gather_solver_bodies`.
+    auto vel_view = registry.view<linvel, angvel, mass_inv, inertia_world_inv, delta_linvel, delta_angvel>();
+
+    for (auto [entity, v, w, inv_m, inv_I, dv, dw] : vel_view.each()) {
+        auto &body = m_substep_bodies[m_row_cache.body_index(entity)];
+        body.linvel = v;
+        body.angvel = w;
+    }
+
+    m_substep_rhs.resize(rows.size());
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        m_substep_rhs[i] = rows[i].rhs + rows[i].error * rows[i].erp;
+    }
+
+    // Rows are not linearized again. The position error is extrapolated from
+    // the displacement of the bodies along the Jacobian.
+    auto update_rhs = [&](bool relax) {
+        for (size_t i = 0; i < rows.size(); ++i) {
+            auto &row = rows[i];
+
+            if (row.erp == 0) {
+                continue;
+            }
+
+            auto &bodyA = m_substep_bodies[row.bodyA];
+            auto &bodyB = m_substep_bodies[row.bodyB];
+            auto error = row.error * dt +
+                         dot(row.J[0], bodyA.linear_displacement) +
+                         dot(row.J[1], bodyA.angular_displacement) +
+                         dot(row.J[2], bodyB.linear_displacement) +
+                         dot(row.J[3], bodyB.angular_displacement);
+
+            // Relaxation removes the velocity added to correct position errors,
+            // except for unilateral rows which are not violated, such as
+            // speculative contacts, whose bias limits how fast the gap closes.
+            if (relax && (error < 0 || row.lower_limit < 0)) {
+                row.rhs = m_substep_rhs[i];
+            } else {
+                row.rhs = m_substep_rhs[i] - error / h * row.erp;
+            }
+        }
+    };
+
+    m_stats.num_iterations = 0;
+    m_stats.iteration_budget = num_substeps * (num_iterations + 1);
+
+    for (unsigned k = 0; k < num_substeps; ++k) {
+        update_rhs(false);
+
+        for (unsigned i = 0; i < num_iterations; ++i) {
+            iterate_constraints(registry, m_row_cache, dt);
+            m_stats.residual = solve_iteration(solve_parallel);
+            ++m_stats.num_iterations;
+        }
+
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            auto &body = m_substep_bodies[i];
+            body.linear_displacement += (body.linvel + bodies[i].dv) * h;
+            body.angular_displacement += (body.angvel + bodies[i].dw) * h;
+        }
+
+        update_rhs(true);
+        iterate_constraints(registry, m_row_cache, dt);
+        m_stats.residual = solve_iteration(solve_parallel);
+        ++m_stats.num_iterations;
+    }
+}
+
 solver::solver(entt::registry &registry)
     : m_registry(&registry)
 {
@@ -154,21 +283,81 @@ void solver::update(scalar dt) {
 
     apply_gravity(registry, dt);
 
+    // Copy the state of all bodies into a contiguous array which is accessed
+    // by index in the solver iterations.
+    gather_solver_bodies(registry, m_row_cache);
+
     // Setup constraints.
     prepare_constraints(registry, m_row_cache, dt);
 
+    // Split the rows among workers in large islands.
+    auto &dispatcher = job_dispatcher::global();
+    auto solve_parallel = settings.parallel_solver_row_threshold > 0 &&
+                          m_row_cache.rows.size() >= settings.parallel_solver_row_threshold &&
+                          dispatcher.num_workers() > 1;
+
+    if (solve_parallel) {
+        m_parallel_rows.build(m_row_cache.rows, m_row_cache.bodies);
+    } else if (settings.solver_row_batching) {
+        m_row_batches.build(m_row_cache.rows, m_row_cache.bodies);
+    }
+
+    auto num_substeps = settings.num_solver_substeps > 1 &&
+                        m_row_cache.rows.size() >= settings.solver_substep_row_threshold ?
+                        settings.num_solver_substeps : 1u;
+
+    m_stats.num_rows = static_cast<unsigned>(m_row_cache.rows.size());
+
     // Solve constraints.
-    for (unsigned i = 0; i < settings.num_solver_velocity_iterations; ++i) {
-        // Prepare constraints for iteration.
-        iterate_constraints(registry, m_row_cache, dt);
+    if (num_substeps > 1) {
+        solve_substeps(num_substeps, solve_parallel, dt);
+    } else {
+        auto adaptive = settings.adaptive_solver_iterations;
+        auto min_iterations = std::min(settings.min_solver_velocity_iterations,
+                                       settings.num_solver_velocity_iterations);
+        auto max_iterations = std::max(settings.max_solver_velocity_iterations,
+                                       settings.num_solver_velocity_iterations);
+
+        if (adaptive) {
+            m_iteration_budget = std::clamp(m_iteration_budget, settings.num_solver_velocity_iterations, max_iterations);
+        } else {
+            m_iteration_budget = settings.num_solver_velocity_iterations;
+        }
+
+        auto converged = false;
+        m_stats.iteration_budget = m_iteration_budget;
+        m_stats.num_iterations = 0;
+        m_stats.residual = 0;
+
+        for (unsigned i = 0; i < m_iteration_budget; ++i) {
+            // Prepare constraints for iteration.
+            iterate_constraints(registry, m_row_cache, dt);
+            m_stats.residual = solve_iteration(solve_parallel);
+            ++m_stats.num_iterations;
+
+            if (adaptive && m_stats.num_iterations >= min_iterations &&
+                m_stats.residual < settings.solver_convergence_tolerance) {
+                converged = true;
+                break;
+            }
+        }
 
-        // Solve rows.
-        for (auto &row : m_row_cache.rows) {
-            auto delta_impulse = solve(row);
-            apply_impulse(delta_impulse, row);
+        // Grow the budget quickly if the solver did not converge and shrink
+        // it slowly otherwise, to avoid oscillating between the two.
+        if (adaptive) {
+            if (!converged) {
+                m_iteration_budget = std::min(m_iteration_budget * 2, max_iterations);
+            } else if (m_iteration_budget > settings.num_solver_velocity_iterations) {
+                --m_iteration_budget;
+            }
         }
     }
 
+    m_row_batches.clear();
+    m_parallel_rows.clear();
+
+    scatter_solver_bodies(registry, m_row_cache);
+
     // Apply constraint velocity correction.
     auto vel_view = registry.view<linvel, angvel, delta_linvel, delta_angvel, dynamic_tag>();
     vel_view.each([](linvel &v, angvel &w, delta_linvel &dv, delta_angvel &dw) {
@@ -181,9 +370,22 @@ void solver::update(scalar dt) {
     // Assign applied impulses.
     update_impulses(registry, m_row_cache);
 
-    // Integrate velocities to obtain new transforms.
-    integrate_linvel(registry, dt);
-    integrate_angvel(registry, dt);
+    // Integrate velocities to obtain new transforms. When sub-stepping, the
+    // bodies are moved by the displacement accumulated over the substeps
+    // instead, which is what the position errors of the rows were updated
+    // with.
+    if (num_substeps > 1) {
+        auto tr_view = registry.view<position, orientation, dynamic_tag>();
+
+        for (auto [entity, pos, orn] : tr_view.each()) {
+            auto &body = m_substep_bodies[m_row_cache.body_index(entity)];
+            pos += body.linear_displacement;
+            orn = integrate(orn, body.angular_displacement, scalar(1));
+        }
+    } else {
+        integrate_linvel(registry, dt);
+        integrate_angvel(registry, dt);
+    }
 
     // Now that rigid bodies have moved, perform positional correction.
     for (unsigned i = 0; i < settings.num_solver_position_iterations; ++i) {
@@ -247,6 +247,22 @@ void set_solver_position_iterations(entt::registry &registry, unsigned iteration
     registry.ctx().at<island_coordinator>().settings_changed();
 }
 
+bool get_solver_adaptive_iterations(const entt::registry &registry) {
+    return registry.ctx().at<settings>().adaptive_solver_iterations;
+}
+
+void set_solver_adaptive_iterations(entt::registry &registry, bool enabled, scalar tolerance,
+                                    unsigned min_iterations, unsigned max_iterations) {
+    EDYN_ASSERT(tolerance >= 0);
+    EDYN_ASSERT(min_iterations <= max_iterations);
+    auto &settings = registry.ctx().at<edyn::settings>();
+    settings.adaptive_solver_iterations = enabled;
+    settings.solver_convergence_tolerance = tolerance;
+    settings.min_solver_velocity_iterations = min_iterations;
+    settings.max_solver_velocity_iterations = max_iterations;
+    registry.ctx().at<island_coordinator>().settings_changed();
+}
+
 unsigned get_solver_restitution_iterations(const entt::registry &registry) {
     return registry.ctx().at<settings>().num_restitution_iterations;
 }
@@ -267,6 +283,59 @@ void set_solver_individual_restitution_iterations(entt::registry &registry, unsi
     registry.ctx().at<island_coordinator>().settings_changed();
 }
 
+bool get_solver_row_batching(const entt::registry &registry) {
+    return registry.ctx().at<settings>().solver_row_batching;
+}
+
+void set_solver_row_batching(entt::registry &registry, bool enabled) {
+    auto &settings = registry.ctx().at<edyn::settings>();
+    settings.solver_row_batching = enabled;
+    registry.ctx().at<island_coordinator>().settings_changed();
+}
+
+unsigned get_solver_parallel_row_threshold(const entt::registry &registry) {
+    return registry.ctx().at<settings>().parallel_solver_row_threshold;
+}
+
+void set_solver_parallel_row_threshold(entt::registry &registry, unsigned threshold) {
+    auto &settings = registry.ctx().at<edyn::settings>();
+    settings.parallel_solver_row_threshold = threshold;
+    registry.ctx().at<island_coordinator>().settings_changed();
+}
+
+unsigned get_solver_substeps(const entt::registry &registry) {
+    return registry.ctx().at<settings>().num_solver_substeps;
+}
+
+void set_solver_substeps(entt::registry &registry, unsigned substeps, unsigned row_threshold) {
+    EDYN_ASSERT(substeps > 0);
+    auto &settings = registry.ctx().at<edyn::settings>();
+    settings.num_solver_substeps = substeps;
+    settings.solver_substep_row_threshold = row_threshold;
+    registry.ctx().at<island_coordinator>().settings_changed();
+}
+
+bool get_incremental_island_sync(const entt::registry &registry) {
+    return registry.ctx().at<settings>().incremental_island_sync;
+}
+
+void set_incremental_island_sync(entt::registry &registry, bool enabled) {
+    auto &settings = registry.ctx().at<edyn::settings>();
+    settings.incremental_island_sync = enabled;
+    registry.ctx().at<island_coordinator>().settings_changed();
+}
+
+scalar get_island_sync_tolerance(const entt::registry &registry) {
+    return registry.ctx().at<settings>().island_sync_tolerance;
+}
+
+void set_island_sync_tolerance(entt::registry &registry, scalar tolerance) {
+    EDYN_ASSERT(tolerance >= 0);
+    auto &settings = registry.ctx().at<edyn::settings>();
+    settings.island_sync_tolerance = tolerance;
+    registry.ctx().at<island_coordinator>().settings_changed();
+}
+
 void insert_material_mixing(entt::registry &registry, material::id_type material_id0,
                             material::id_type material_id1, const material_base &material) {
     auto &material_table = registry.ctx().at<material_mix_table>();
@@ -7,6 +7,7 @@
 #include "edyn/comp/linvel.hpp"
 #include "edyn/comp/orientation.hpp"
 #include "edyn/comp/rotated_mesh_list.hpp"
+#include "edyn/comp/tag.hpp"
 #include "edyn/config/config.h"
 #include "edyn/constraints/contact_constraint.hpp"
 #include "edyn/context/settings.hpp"
@@ -63,12 +64,57 @@ extrapolation_job::extrapolation_job(extrapolation_input &&input,
     static_cast<void>(m_registry.storage<collision_filter>());
     static_cast<void>(m_registry.storage<collision_exclusion>());
 
+    m_registry.on_destroy<graph_node>().connect<&extrapolation_job::on_destroy_graph_node>(*this);
+    m_registry.on_destroy<graph_edge>().connect<&extrapolation_job::on_destroy_graph_edge>(*this);
+    m_registry.on_destroy<rotated_mesh_list>().connect<&extrapolation_job::on_destroy_rotated_mesh_list>(*this);
+
     m_this_job.func = &extrapolation_job_func;
     auto archive = fixed_memory_output_archive(m_this_job.data.data(), m_this_job.data.size());
     auto ctx_intptr = reinterpret_cast<intptr_t>(this);
     archive(ctx_intptr);
 }
 
+void extrapolation_job::restart(extrapolation_input &&input,
+                                const settings &settings,
+                                const material_mix_table &material_table) {
+    EDYN_ASSERT(is_finished());
+
+    m_input = std::move(input);
+    m_result = {};
+    m_state = state::init;
+    m_current_time = m_input.start_time;
+    m_step_count = 0;
+    m_registry.ctx().at<edyn::settings>() = settings;
+    m_registry.ctx().at<material_mix_table>() = material_table;
+    m_finished.store(false, std::memory_order_relaxed);
+}
+
+void extrapolation_job::release_previous_input() {
+    // Manifolds are not part of the input since they do not make sense in the
+    // server state.
+    auto manifold_view = m_registry.view<contact_manifold>();
+    m_registry.destroy(manifold_view.begin(), manifold_view.end());
+
+    // Keep static entities which are still part of the input. Everything else
+    // is imported again. Destroying a node destroys its edges as well.
+    auto static_view = m_registry.view<static_tag>();
+
+    m_entity_map.erase_if([&](entt::entity remote_entity, entt::entity local_entity) {
+        if (static_view.contains(local_entity) && m_input.entities.contains(remote_entity)) {
+            return false;
+        }
+
+        if (m_registry.valid(local_entity)) {
+            m_registry.destroy(local_entity);
+        }
+
+        return true;
+    });
+
+    // Changes made in the previous extrapolation must not be sent again.
+    m_registry.clear<dirty>();
+}
+
 void extrapolation_job::load_input() {
     // Import entities and components.
     m_input.ops.execute(m_registry, m_entity_map);
@@ -82,8 +128,9 @@ void extrapolation_job::load_input() {
         m_registry.emplace<graph_node>(entity, node_index);
     };
 
+    // Entities kept from a previous extrapolation already have a node.
     std::apply([&](auto ... t) {
-        (m_registry.view<decltype(t)>().each(insert_graph_node), ...);
+        (m_registry.view<decltype(t)>(entt::exclude_t<graph_node>{}).each(insert_graph_node), ...);
     }, std::tuple<rigidbody_tag, external_tag>{});
 
     // Create edges for constraints in entity graph.
@@ -123,21 +170,24 @@ void extrapolation_job::load_input() {
 void extrapolation_job::init() {
     m_start_time = performance_time();
 
-    m_registry.on_destroy<graph_node>().connect<&extrapolation_job::on_destroy_graph_node>(*this);
-    m_registry.on_destroy<graph_edge>().connect<&extrapolation_job::on_destroy_graph_edge>(*this);
-    m_registry.on_destroy<rotated_mesh_list>().connect<&extrapolation_job::on_destroy_rotated_mesh_list>(*this);
+    if (m_initialized) {
+        release_previous_input();
+    }
 
     // Import entities and components to be extrapolated.
     load_input();
 
     // Initialize external systems.
     auto &settings = m_registry.ctx().at<edyn::settings>();
-    if (settings.external_system_init) {
+    if (settings.external_system_init && !m_initialized) {
         (*settings.external_system_init)(m_registry);
     }
 
-    // Run broadphase to initialize the internal dynamic trees with the
-    // imported AABBs.
+    m_initialized = true;
+
+    // Run broadphase to insert the imported AABBs into the internal dynamic
+    // trees. Static entities kept from a previous extrapolation are
+    // already in there.
     auto &bphase = m_registry.ctx().at<broadphase_worker>();
     bphase.update();
 
@@ -249,8 +299,11 @@ void extrapolation_job::sync_and_finish() {
     m_result.timestamp = m_current_time;
 
     if (m_input.should_remap) {
+        // Swap back afterwards since the entity map is kept in case this job
+        // is restarted.
         m_entity_map.swap();
         m_result.remap(m_entity_map);
+        m_entity_map.swap();
     }
 
     m_finished.store(true, std::memory_order_release);
@@ -428,8 +481,9 @@ void extrapolation_job::reschedule() {
 
 void extrapolation_job::create_rotated_meshes() {
     auto orn_view = m_registry.view<orientation>();
-    auto polyhedron_view = m_registry.view<polyhedron_shape>();
-    auto compound_view = m_registry.view<compound_shape>();
+    // Entities kept from a previous extrapolation already have rotated meshes.
+    auto polyhedron_view = m_registry.view<polyhedron_shape>(entt::exclude_t<rotated_mesh_list>{});
+    auto compound_view = m_registry.view<compound_shape>(entt::exclude_t<rotated_mesh_list>{});
 
     for (auto [entity, polyhedron] : polyhedron_view.each()) {
         auto [orn] = orn_view.get(entity);
@@ -1,5 +1,8 @@
 #include "edyn/networking/sys/client_side.hpp"
 #include "edyn/collision/contact_manifold.hpp"
+#include "edyn/collision/broadphase_main.hpp"
+#include "edyn/comp/aabb.hpp"
+#include "edyn/comp/linvel.hpp"
 #include "edyn/comp/island.hpp"
 #include "edyn/config/config.h"
 #include "edyn/constraints/constraint.hpp"
@@ -277,14 +280,22 @@ static void apply_extrapolation_result(entt::registry &registry, extrapolation_r
 
 static void process_finished_extrapolation_jobs(entt::registry &registry) {
     auto &ctx = registry.ctx().at<client_network_context>();
+    auto &settings = registry.ctx().at<edyn::settings>();
+    auto &client_settings = std::get<client_network_settings>(settings.network_settings);
 
     // Check if extrapolation jobs are finished and merge their results into
-    // the main registry.
+    // the main registry. Keep finished jobs to be reused in the next
+    // extrapolations.
     auto remove_it = std::remove_if(ctx.extrapolation_jobs.begin(), ctx.extrapolation_jobs.end(),
                                     [&](extrapolation_job_context &extr_ctx) {
         if (extr_ctx.job->is_finished()) {
             auto &result = extr_ctx.job->get_result();
             apply_extrapolation_result(registry, result);
+
+            if (ctx.idle_extrapolation_jobs.size() < client_settings.max_concurrent_extrapolations) {
+                ctx.idle_extrapolation_jobs.push_back(std::move(extr_ctx.job));
+            }
+
             return true;
         }
         return false;
@@ -337,6 +348,10 @@ static void process_packet(entt::registry &registry, const packet::client_create
     ctx.client_entity = local_entity;
     ctx.entity_map.insert(remote_entity, local_entity);
 
+    // Snapshot sequence numbers start over in a new connection.
+    ctx.snapshot_baselines.clear();
+    ctx.latest_snapshot_sequence = 0;
+
     auto emap_packet = packet::update_entity_map{};
     emap_packet.timestamp = performance_time();
     emap_packet.pairs.emplace_back(remote_entity, local_entity);
@@ -539,7 +554,93 @@ static void snap_to_registry_snapshot(entt::registry &registry, packet::registry
     }
 }
 
+// Inserts the non-procedural entities that the procedural entities in the
+// set could collide with during an extrapolation of the given duration. The
+// snapshot state lags behind the client state by about the duration of the
+// extrapolation, thus the AABBs are swept both backwards and forwards in time,
+// using the current client velocity, to cover the server state as well.
+static void insert_swept_non_procedural_entities(entt::registry &registry,
+                                                 entt::sparse_set &entities,
+                                                 double duration) {
+    auto &bphase = registry.ctx().at<broadphase_main>();
+    auto body_view = registry.view<AABB, linvel, procedural_tag>();
+    auto margin = vector3_one * -contact_breaking_threshold;
+    auto np_entities = std::vector<entt::entity>{};
+
+    for (auto entity : entities) {
+        if (!body_view.contains(entity)) {
+            continue;
+        }
+
+        auto [aabb, vel] = body_view.get<AABB, linvel>(entity);
+        auto displacement = abs(vel * static_cast<scalar>(duration));
+        auto swept_aabb = AABB{aabb.min - displacement, aabb.max + displacement}.inset(margin);
+
+        bphase.query_non_procedural(swept_aabb, [&](entt::entity np_entity) {
+            np_entities.push_back(np_entity);
+        });
+    }
+
+    for (auto entity : np_entities) {
+        if (!entities.contains(entity)) {
+            entities.emplace(entity);
+        }
+    }
+}
+
+// Decodes packed pools of a compressed snapshot. Must be done before
+// converting the snapshot into local space since baselines refer to server
+// entities.
+static bool unpack_registry_snapshot(client_network_context &ctx, packet::registry_snapshot &snapshot) {
+    // A sequence number far behind the latest means the server started over,
+    // thus the baselines in the history belong to the previous sequence.
+    if (snapshot.sequence + snapshot_baseline_history::max_size <= ctx.latest_snapshot_sequence) {
+        ctx.snapshot_baselines.clear();
+        ctx.latest_snapshot_sequence = 0;
+    }
+
+    const snapshot_baseline *baseline = nullptr;
+
+    if (snapshot.baseline_sequence != 0) {
+        if (snapshot.sequence - snapshot.baseline_sequence >= snapshot_baseline_history::max_size) {
+            return false;
+        }
+
+        baseline = ctx.snapshot_baselines.find(snapshot.baseline_sequence);
+
+        // The baseline is not available, e.g. the snapshot was lost or it
+        // arrived out of order. Wait for a snapshot encoded against a baseline
+        // this client has.
+        if (baseline == nullptr) {
+            return false;
+        }
+    }
+
+    auto *current = ctx.snapshot_baselines.insert(snapshot.sequence);
+
+    if (current == nullptr) {
+        return false;
+    }
+
+    ctx.latest_snapshot_sequence = std::max(snapshot.sequence, ctx.latest_snapshot_sequence);
+
+    for (auto &pool : snapshot.pools) {
+        if (!pool.ptr->unpack(snapshot.entities, baseline, *current)) {
+            return false;
+        }
+    }
+
+    ctx.packet_signal.publish(packet::edyn_packet{packet::snapshot_ack{snapshot.sequence}});
+
+    return true;
+}
+
 static void process_packet(entt::registry &registry, packet::registry_snapshot &snapshot) {
+    if (snapshot.sequence != 0 &&
+        !unpack_registry_snapshot(registry.ctx().at<client_network_context>(), snapshot)) {
+        return;
+    }
+
     if (contains_unknown_entities(registry, snapshot.entities)) {
         // Do not perform extrapolation if it contains unknown entities as the
         // result would not make much sense if all parts are not involved. Wait
@@ -635,15 +736,9 @@ static void process_packet(entt::registry &registry, packet::registry_snapshot &
             }
         }, [](auto) { return true; }, []() {});
 
-    // TODO: only include the necessary static entities. Could extrapolate the
-    // position by twice their velocity and calculate a sweep AABB (union of
-    // initial and extrapolated AABB) and query the non-procedural broadphase
-    // tree to obtain the relevant static and kinematic entities.
-    for (auto entity : registry.view<static_tag>()) {
-        if (!entities.contains(entity)) {
-            entities.emplace(entity);
-        }
-    }
+    // Only include the static and kinematic entities which could be touched
+    // during extrapolation.
+    insert_swept_non_procedural_entities(registry, entities, time - snapshot_time);
 
     // Create input to send to extrapolation job.
     extrapolation_input input;
@@ -657,9 +752,34 @@ static void process_packet(entt::registry &registry, packet::registry_snapshot &
         }
     }
 
+    // Reuse a finished job if available. Static entities which are still
+    // present in its registry do not need to be imported again.
+    std::unique_ptr<extrapolation_job> job;
+
+    if (!ctx.idle_extrapolation_jobs.empty()) {
+        job = std::move(ctx.idle_extrapolation_jobs.back());
+        ctx.idle_extrapolation_jobs.pop_back();
+    }
+
     auto builder = (*settings.make_reg_op_builder)();
     builder->create(entities.begin(), entities.end());
-    builder->emplace_all(registry, entities);
+
+    if (job) {
+        auto static_view = registry.view<static_tag>();
+        auto new_entities = std::vector<entt::entity>{};
+        new_entities.reserve(entities.size());
+
+        for (auto entity : entities) {
+            if (!static_view.contains(entity) || !job->contains_entity(entity)) {
+                new_entities.push_back(entity);
+            }
+        }
+
+        builder->emplace_all(registry, new_entities);
+    } else {
+        builder->emplace_all(registry, entities);
+    }
+
     input.ops = builder->finish();
 
     input.entities = std::move(entities);
@@ -671,8 +791,13 @@ static void process_packet(entt::registry &registry, packet::registry_snapshot &
     // Assign latest value of action threshold before extrapolation.
     ctx.input_history->action_time_threshold = client_settings.action_time_threshold;
 
-    auto job = std::make_unique<extrapolation_job>(std::move(input), settings,
-                                                   material_table, ctx.input_history);
+    if (job) {
+        job->restart(std::move(input), settings, material_table);
+    } else {
+        job = std::make_unique<extrapolation_job>(std::move(input), settings,
+                                                  material_table, ctx.input_history);
+    }
+
     job->reschedule();
 
     ctx.extrapolation_jobs.push_back(extrapolation_job_context{std::move(job)});
@@ -709,6 +834,7 @@ static void process_packet(entt::registry &registry, const packet::server_settin
 }
 
 static void process_packet(entt::registry &, const packet::set_aabb_of_interest &) {}
+static void process_packet(entt::registry &, const packet::snapshot_ack &) {}
 
 void client_receive_packet(entt::registry &registry, packet::edyn_packet &packet) {
     std::visit([&](auto &&inner_packet) {
@@ -4,6 +4,7 @@
 #include "edyn/comp/island.hpp"
 #include "edyn/comp/position.hpp"
 #include "edyn/comp/orientation.hpp"
+#include "edyn/comp/linvel.hpp"
 #include "edyn/comp/tag.hpp"
 #include "edyn/networking/comp/action_history.hpp"
 #include "edyn/networking/comp/network_dirty.hpp"
@@ -20,6 +21,7 @@
 #include "edyn/networking/util/process_update_entity_map_packet.hpp"
 #include "edyn/parallel/island_coordinator.hpp"
 #include "edyn/parallel/message.hpp"
+#include "edyn/parallel/parallel_for.hpp"
 #include "edyn/time/time.hpp"
 #include "edyn/util/entity_map.hpp"
 #include "edyn/util/island_util.hpp"
@@ -27,6 +29,7 @@
 #include "edyn/util/aabb_util.hpp"
 #include <entt/entity/registry.hpp>
 #include <algorithm>
+#include <limits>
 #include <set>
 
 namespace edyn {
@@ -282,15 +285,69 @@ static void process_packet(entt::registry &registry, entt::entity client_entity,
     aabboi.aabb.max = aabb.max;
 }
 
+static void process_packet(entt::registry &registry, entt::entity client_entity, const packet::snapshot_ack &ack) {
+    auto &client = registry.get<remote_client>(client_entity);
+
+    // Acks might arrive out of order. Keep the latest.
+    if (ack.sequence > client.last_acked_snapshot && ack.sequence < client.next_snapshot_sequence) {
+        client.last_acked_snapshot = ack.sequence;
+    }
+
+    // The client has the state of the entities in this snapshot as of the
+    // time it was sent, thus changes before that are not pending anymore.
+    auto it = std::find_if(client.unacked_snapshots.begin(), client.unacked_snapshots.end(),
+                           [&](auto &&sent) { return sent.sequence == ack.sequence; });
+
+    if (it == client.unacked_snapshots.end()) {
+        return;
+    }
+
+    for (auto entity : it->entities) {
+        if (client.pending_dirty.contains(entity)) {
+            auto &pending = client.pending_dirty.at(entity);
+            pending.erase_until(it->time);
+
+            if (pending.empty()) {
+                client.pending_dirty.erase(entity);
+            }
+        }
+    }
+
+    client.unacked_snapshots.erase(it);
+}
+
 static void process_packet(entt::registry &, entt::entity, const packet::client_created &) {}
 static void process_packet(entt::registry &, entt::entity, const packet::set_playout_delay &) {}
 static void process_packet(entt::registry &, entt::entity, const packet::server_settings &) {}
 
+static void on_destroy_entity_of_interest(entt::registry &registry, entt::entity entity) {
+    auto &ctx = registry.ctx().at<server_network_context>();
+    ctx.interest.remove_body(entity);
+    ctx.interest_destroyed_entities.push_back(entity);
+}
+
+static void on_construct_graph_edge(entt::registry &registry, entt::entity entity) {
+    auto &ctx = registry.ctx().at<server_network_context>();
+    ctx.interest_created_edges.push_back(entity);
+}
+
+static void on_destroy_aabb_of_interest(entt::registry &registry, entt::entity entity) {
+    auto &ctx = registry.ctx().at<server_network_context>();
+    ctx.interest.remove_client(entity);
+    ctx.interest_destroyed_entities.push_back(entity);
+}
+
 void init_network_server(entt::registry &registry) {
     registry.ctx().emplace<server_network_context>();
     // Assign an entity owner to every island created.
     registry.on_construct<island>().connect<&entt::registry::emplace<entity_owner>>();
 
+    // Keep track of changes the interest grid cannot see.
+    registry.on_destroy<graph_node>().connect<&on_destroy_entity_of_interest>();
+    registry.on_destroy<graph_edge>().connect<&on_destroy_entity_of_interest>();
+    registry.on_construct<graph_edge>().connect<&on_construct_graph_edge>();
+    registry.on_destroy<aabb_of_interest>().connect<&on_destroy_aabb_of_interest>();
+
     auto &settings = registry.ctx().at<edyn::settings>();
     settings.network_settings = server_network_settings{};
 }
@@ -298,6 +355,10 @@ void init_network_server(entt::registry &registry) {
 void deinit_network_server(entt::registry &registry) {
     registry.ctx().erase<server_network_context>();
     registry.on_construct<island>().disconnect<&entt::registry::emplace<entity_owner>>();
+    registry.on_destroy<graph_node>().disconnect<&on_destroy_entity_of_interest>();
+    registry.on_destroy<graph_edge>().disconnect<&on_destroy_entity_of_interest>();
+    registry.on_construct<graph_edge>().disconnect<&on_construct_graph_edge>();
+    registry.on_destroy<aabb_of_interest>().disconnect<&on_destroy_aabb_of_interest>();
 
     auto &settings = registry.ctx().at<edyn::settings>();
     settings.network_settings = {};
@@ -342,11 +403,11 @@ static void publish_pending_created_clients(entt::registry &registry) {
     ctx.pending_created_clients.clear();
 }
 
-static void process_aabb_of_interest_destroyed_entities(entt::registry &registry,
+static void process_aabb_of_interest_destroyed_entities(const entt::registry &registry,
                                                         entt::entity client_entity,
-                                                        remote_client &client,
                                                         aabb_of_interest &aabboi,
-                                                        double time) {
+                                                        double time,
+                                                        std::vector<packet::edyn_packet> &packets) {
     if (aabboi.destroy_entities.empty()) {
         return;
     }
@@ -369,16 +430,15 @@ static void process_aabb_of_interest_destroyed_entities(entt::registry &registry
     aabboi.destroy_entities.clear();
 
     if (!packet.entities.empty()) {
-        auto &ctx = registry.ctx().at<server_network_context>();
-        ctx.packet_signal.publish(client_entity, packet::edyn_packet{packet});
+        packets.push_back(packet::edyn_packet{packet});
     }
 }
 
-static void process_aabb_of_interest_created_entities(entt::registry &registry,
+static void process_aabb_of_interest_created_entities(const entt::registry &registry,
                                                       entt::entity client_entity,
-                                                      remote_client &client,
                                                       aabb_of_interest &aabboi,
-                                                      double time) {
+                                                      double time,
+                                                      std::vector<packet::edyn_packet> &packets) {
     if (aabboi.create_entities.empty()) {
         return;
     }
@@ -406,21 +466,141 @@ static void process_aabb_of_interest_created_entities(entt::registry &registry,
             return lhs.component_index < rhs.component_index;
         });
 
-        ctx.packet_signal.publish(client_entity, packet::edyn_packet{packet});
+        packets.push_back(packet::edyn_packet{packet});
     }
 
     aabboi.create_entities.clear();
 }
 
-static void maybe_publish_client_registry_snapshot(entt::registry &registry,
+// Returns the baseline a snapshot with the given sequence number is encoded
+// against, i.e. the last acknowledged snapshot if it is still in the history
+// and is not going to be replaced by the snapshot being encoded.
+static const snapshot_baseline * find_client_snapshot_baseline(const remote_client &client, uint32_t sequence) {
+    if (sequence - client.last_acked_snapshot < snapshot_baseline_history::max_size) {
+        return client.snapshot_baselines.find(client.last_acked_snapshot);
+    }
+
+    return nullptr;
+}
+
+static void pack_client_registry_snapshot(remote_client &client,
+                                          const server_network_settings &server_settings,
+                                          packet::registry_snapshot &snapshot) {
+    snapshot.sequence = client.next_snapshot_sequence++;
+    auto *baseline = find_client_snapshot_baseline(client, snapshot.sequence);
+    snapshot.baseline_sequence = baseline ? client.last_acked_snapshot : 0;
+    auto *current = client.snapshot_baselines.insert(snapshot.sequence);
+    EDYN_ASSERT(current != nullptr);
+
+    for (auto &pool : snapshot.pools) {
+        pool.ptr->pack(server_settings.snapshot_codec, snapshot.entities, baseline, *current);
+    }
+}
+
+// Accumulates the priority of the candidate entities and selects the ones with
+// highest priority that fit in the snapshot byte budget.
+static void select_client_snapshot_entities(const entt::registry &registry,
+                                            entt::entity client_entity,
+                                            remote_client &client,
+                                            const aabb_of_interest &aabboi,
+                                            const std::vector<entt::entity> &candidates,
+                                            double elapsed,
+                                            std::vector<entt::entity> &selected) {
+    auto &ctx = registry.ctx().at<server_network_context>();
+    auto &settings = registry.ctx().at<edyn::settings>();
+    auto &server_settings = std::get<server_network_settings>(settings.network_settings);
+    auto position_view = registry.view<position>();
+    auto linvel_view = registry.view<linvel>();
+    auto owner_view = registry.view<entity_owner>();
+    auto center = aabboi.aabb.center();
+
+    // Forget entities which left the AABB of interest.
+    client.snapshot_priorities.erase_if([&](entt::entity entity, scalar) {
+        return !aabboi.entities.contains(entity);
+    });
+
+    std::vector<std::pair<scalar, entt::entity>> priorities;
+    priorities.reserve(candidates.size());
+
+    for (auto entity : candidates) {
+        auto rate = scalar(1);
+
+        if (position_view.contains(entity)) {
+            auto [pos] = position_view.get(entity);
+            rate /= 1 + distance(pos, center) / server_settings.snapshot_priority_distance_scale;
+        }
+
+        if (linvel_view.contains(entity)) {
+            auto [vel] = linvel_view.get(entity);
+            rate *= 1 + length(vel) * server_settings.snapshot_priority_speed_factor;
+        }
+
+        if (owner_view.contains(entity) &&
+            std::get<0>(owner_view.get(entity)).client_entity == client_entity) {
+            rate *= server_settings.snapshot_priority_owned_multiplier;
+        }
+
+        auto priority = rate * static_cast<scalar>(elapsed);
+
+        if (client.snapshot_priorities.contains(entity)) {
+            priority += client.snapshot_priorities.at(entity);
+        }
+
+        client.snapshot_priorities.insert_or_assign(entity, priority);
+        priorities.emplace_back(priority, entity);
+    }
+
+    std::sort(priorities.begin(), priorities.end(), [](auto &&lhs, auto &&rhs) {
+        return lhs.first > rhs.first ||
+               (lhs.first == rhs.first && entt::to_integral(lhs.second) < entt::to_integral(rhs.second));
+    });
+
+    // Estimate the size of the components as they will be packed.
+    const snapshot_codec_settings *codec_settings = nullptr;
+    const snapshot_baseline *baseline = nullptr;
+
+    if (server_settings.snapshot_compression_enabled) {
+        codec_settings = &server_settings.snapshot_codec;
+        baseline = find_client_snapshot_baseline(client, client.next_snapshot_sequence);
+    }
+
+    // Entities are referenced by an 8-bit index in the snapshot pools.
+    constexpr size_t max_entities = std::numeric_limits<pool_snapshot_data::index_type>::max();
+    size_t size = 0;
+
+    for (auto [priority, entity] : priorities) {
+        if (selected.size() == max_entities) {
+            break;
+        }
+
+        auto entity_size = sizeof(entt::entity) +
+            ctx.snapshot_exporter->estimate_dirty_size(registry, entity, client_entity,
+                                                       codec_settings, baseline);
+
+        // Skip entities that do not fit, but keep looking for smaller ones.
+        // Always include at least one entity so oversized entities do not
+        // stall.
+        if (!selected.empty() && size + entity_size > server_settings.snapshot_byte_budget) {
+            continue;
+        }
+
+        size += entity_size;
+        selected.push_back(entity);
+        client.snapshot_priorities.at(entity) = 0;
+    }
+}
+
+static void maybe_publish_client_registry_snapshot(const entt::registry &registry,
                                                    entt::entity client_entity,
                                                    remote_client &client,
                                                    aabb_of_interest &aabboi,
-                                                   double time) {
+                                                   double time,
+                                                   std::vector<packet::edyn_packet> &packets) {
     if (time - client.last_snapshot_time < 1 / client.snapshot_rate) {
         return;
     }
 
+    auto elapsed = time - client.last_snapshot_time;
     client.last_snapshot_time = time;
 
     auto &ctx = registry.ctx().at<server_network_context>();
@@ -432,16 +612,22 @@ static void maybe_publish_client_registry_snapshot(entt::registry &registry,
     auto should_include = [&](entt::entity entity) {
         return
             !registry.any_of<sleeping_tag>(entity) &&
-            registry.all_of<networked_tag, network_dirty>(entity) &&
+            registry.all_of<networked_tag>(entity) &&
+            (registry.all_of<network_dirty>(entity) || client.pending_dirty.contains(entity)) &&
             !is_fully_owned_by_client(registry, client_entity, entity);
     };
 
+    std::vector<entt::entity> candidates;
+
     for (auto entity : aabboi.entities) {
         if (should_include(entity)) {
-            packet.entities.push_back(entity);
+            candidates.push_back(entity);
         }
     }
 
+    select_client_snapshot_entities(registry, client_entity, client, aabboi,
+                                    candidates, elapsed, packet.entities);
+
     ctx.snapshot_exporter->export_dirty(registry, packet, client_entity);
 
     if (!packet.entities.empty() && !packet.pools.empty()) {
@@ -463,14 +649,67 @@ static void maybe_publish_client_registry_snapshot(entt::registry &registry,
             }
         }
 
-        ctx.packet_signal.publish(client_entity, packet::edyn_packet{packet});
+        auto &settings = registry.ctx().at<edyn::settings>();
+        auto &server_settings = std::get<server_network_settings>(settings.network_settings);
+
+        if (server_settings.snapshot_compression_enabled) {
+            pack_client_registry_snapshot(client, server_settings, packet);
+
+            // Keep pending components until the snapshot is acknowledged.
+            if (client.unacked_snapshots.size() == snapshot_baseline_history::max_size) {
+                client.unacked_snapshots.erase(client.unacked_snapshots.begin());
+            }
+
+            client.unacked_snapshots.push_back({packet.sequence, time, packet.entities});
+        } else {
+            // Snapshots are not acknowledged without compression, thus assume
+            // they arrive.
+            for (auto entity : packet.entities) {
+                client.pending_dirty.erase(entity);
+            }
+        }
+
+        packets.push_back(packet::edyn_packet{packet});
+    }
+}
+
+// Collects the components marked as dirty in this step for the entities in the
+// AABB of interest, which remain pending until they reach the client.
+static void update_client_pending_dirty(const entt::registry &registry,
+                                        remote_client &client,
+                                        const aabb_of_interest &aabboi,
+                                        double time) {
+    client.pending_dirty.erase_if([&](entt::entity entity, network_dirty &) {
+        return !aabboi.entities.contains(entity);
+    });
+
+    auto dirty_view = registry.view<network_dirty>();
+
+    for (auto entity : aabboi.entities) {
+        if (!dirty_view.contains(entity)) {
+            continue;
+        }
+
+        auto [n_dirty] = dirty_view.get(entity);
+
+        for (unsigned i = 0; i < n_dirty.size; ++i) {
+            auto &entry = n_dirty.entries[i];
+
+            if (entry.time == time) {
+                if (!client.pending_dirty.contains(entity)) {
+                    client.pending_dirty.insert_or_assign(entity, network_dirty{});
+                }
+
+                client.pending_dirty.at(entity).insert(entry.type_id, entry.time);
+            }
+        }
     }
 }
 
-static void calculate_client_playout_delay(entt::registry &registry,
-                                           entt::entity client_entity,
+static void calculate_client_playout_delay(const entt::registry &registry,
                                            remote_client &client,
-                                           aabb_of_interest &aabboi) {
+                                           aabb_of_interest &aabboi,
+                                           std::vector<packet::edyn_packet> &packets) {
     auto owner_view = registry.view<entity_owner>();
     auto client_view = registry.view<remote_client>();
     auto biggest_rtt = client.round_trip_time;
@@ -496,17 +735,49 @@ static void calculate_client_playout_delay(entt::registry &registry,
         client.playout_delay = playout_delay;
 
         auto packet = edyn::packet::set_playout_delay{playout_delay};
-        auto &ctx = registry.ctx().at<server_network_context>();
-        ctx.packet_signal.publish(client_entity, edyn::packet::edyn_packet{packet});
+        packets.push_back(edyn::packet::edyn_packet{packet});
     }
 }
 
 static void process_aabbs_of_interest(entt::registry &registry, double time) {
-    for (auto [client_entity, client, aabboi] : registry.view<remote_client, aabb_of_interest>().each()) {
-        process_aabb_of_interest_destroyed_entities(registry, client_entity, client, aabboi, time);
-        process_aabb_of_interest_created_entities(registry, client_entity, client, aabboi, time);
-        maybe_publish_client_registry_snapshot(registry, client_entity, client, aabboi, time);
-        calculate_client_playout_delay(registry, client_entity, client, aabboi);
+    auto client_view = registry.view<remote_client, aabb_of_interest>();
+    auto client_entities = std::vector<entt::entity>(client_view.begin(), client_view.end());
+
+    if (client_entities.empty()) {
+        return;
+    }
+
+    // Clients are processed in parallel. Each one only modifies its own
+    // components and reads from the registry, thus the registry is accessed
+    // via a const reference which does not create storages on demand. Packets
+    // are collected per client and published afterwards in order, since packet
+    // observers are not expected to be thread-safe.
+    const auto &const_registry = registry;
+    auto packets = std::vector<std::vector<packet::edyn_packet>>(client_entities.size());
+
+    auto process_client = [&](size_t index) {
+        auto client_entity = client_entities[index];
+        auto [client, aabboi] = client_view.get(client_entity);
+        auto &client_packets = packets[index];
+        process_aabb_of_interest_destroyed_entities(const_registry, client_entity, aabboi, time, client_packets);
+        process_aabb_of_interest_created_entities(const_registry, client_entity, aabboi, time, client_packets);
+        update_client_pending_dirty(const_registry, client, aabboi, time);
+        maybe_publish_client_registry_snapshot(const_registry, client_entity, client, aabboi, time, client_packets);
+        calculate_client_playout_delay(const_registry, client, aabboi, client_packets);
+    };
+
+    if (client_entities.size() > 1) {
+        parallel_for(size_t{0}, client_entities.size(), process_client);
+    } else {
+        process_client(0);
+    }
+
+    auto &ctx = registry.ctx().at<server_network_context>();
+
+    for (size_t i = 0; i < client_entities.size(); ++i) {
+        for (auto &packet : packets[i]) {
+            ctx.packet_signal.publish(client_entities[i], packet);
+        }
     }
 }
 
@@ -1,19 +1,28 @@
 #include "edyn/networking/sys/update_aabbs_of_interest.hpp"
 #include "edyn/collision/contact_manifold.hpp"
 #include "edyn/collision/broadphase_main.hpp"
-#include "edyn/comp/island.hpp"
+#include "edyn/comp/graph_node.hpp"
+#include "edyn/comp/graph_edge.hpp"
 #include "edyn/comp/position.hpp"
+#include "edyn/comp/tag.hpp"
+#include "edyn/context/settings.hpp"
+#include "edyn/parallel/entity_graph.hpp"
 #include "edyn/networking/comp/aabb_of_interest.hpp"
 #include "edyn/networking/comp/aabb_oi_follow.hpp"
 #include "edyn/networking/comp/entity_owner.hpp"
+#include "edyn/networking/context/server_network_context.hpp"
+#include "edyn/networking/settings/server_network_settings.hpp"
+#include "edyn/parallel/parallel_for.hpp"
+#include "edyn/util/flat_hash_map.hpp"
 #include <entt/entity/registry.hpp>
+#include <algorithm>
+#include <variant>
+#include <vector>
 
 namespace edyn {
 
 void update_aabbs_of_interest(entt::registry &registry) {
     auto &bphase = registry.ctx().at<broadphase_main>();
-    auto owner_view = registry.view<entity_owner>();
-    auto manifold_view = registry.view<contact_manifold>();
     auto position_view = registry.view<position>();
 
     registry.view<aabb_of_interest, aabb_oi_follow>().each([&](aabb_of_interest &aabboi, aabb_oi_follow &follow) {
@@ -23,74 +32,223 @@ void update_aabbs_of_interest(entt::registry &registry) {
         aabboi.aabb.max = pos + half_size;
     });
 
-    registry.view<aabb_of_interest>().each([&](aabb_of_interest &aabboi) {
-        entt::sparse_set contained_entities;
+    auto &ctx = registry.ctx().at<server_network_context>();
+    auto &settings = registry.ctx().at<edyn::settings>();
+    auto &server_settings = std::get<server_network_settings>(settings.network_settings);
+    auto &grid = ctx.interest;
+    grid.set_cell_size(server_settings.interest_grid_cell_size);
+
+    // Update the cells of bodies and clients in the interest grid, which
+    // records the bodies that entered and exited the area of each client.
+    for (auto [entity, pos] : registry.view<position, procedural_tag>().each()) {
+        grid.move_body(entity, pos);
+    }
+
+    auto aabboi_view = registry.view<aabb_of_interest>();
+
+    for (auto [entity, aabboi] : aabboi_view.each()) {
+        grid.move_client(entity, aabboi.aabb);
+    }
+
+    // Only constraints are of interest among newly created edges.
+    const auto &const_registry = registry;
+    auto manifold_view = const_registry.view<contact_manifold>();
+    auto &created_edges = ctx.interest_created_edges;
+    created_edges.erase(std::remove_if(created_edges.begin(), created_edges.end(), [&](entt::entity entity) {
+        return !registry.valid(entity) || manifold_view.contains(entity);
+    }), created_edges.end());
+
+    // AABBs of interest are updated in parallel. The registry is only read
+    // from, via const views which do not create storages on demand.
+    auto &graph = registry.ctx().at<entity_graph>();
+    auto owner_view = const_registry.view<entity_owner>();
+    auto node_view = const_registry.view<graph_node>();
+    auto aabboi_entities = std::vector<entt::entity>(aabboi_view.begin(), aabboi_view.end());
+
+    auto update_aabboi = [&](size_t index) {
+        auto client_entity = aabboi_entities[index];
+        auto &aabboi = aabboi_view.get<aabb_of_interest>(client_entity);
+
+        // Whether each entity that was inserted or erased was of interest
+        // before this update. Entities might enter and exit more than once in
+        // an update, thus the client is only notified of the net change.
+        flat_hash_map<entt::entity, bool> touched_entities;
+
+        auto insert_plain = [&](entt::entity entity) {
+            aabboi.entities.emplace(entity);
+
+            if (!touched_entities.contains(entity)) {
+                touched_entities.insert_or_assign(entity, false);
+            }
+        };
 
-        aabboi.island_entities.clear();
-        // Collect entities of islands which intersect the AABB of interest.
-        bphase.query_islands(aabboi.aabb, [&](entt::entity island_entity) {
-            auto &island = registry.get<edyn::island>(island_entity);
+        auto erase_plain = [&](entt::entity entity) {
+            aabboi.entities.erase(entity);
 
-            for (auto entity : island.nodes) {
-                if (!contained_entities.contains(entity)) {
-                    contained_entities.emplace(entity);
-                }
+            if (!touched_entities.contains(entity)) {
+                touched_entities.insert_or_assign(entity, true);
             }
+        };
 
-            for (auto entity : island.edges) {
-                // Ignore contact manifolds.
-                if (manifold_view.contains(entity)) {
-                    continue;
-                }
+        auto insert_entity = [&](entt::entity entity) {
+            if (aabboi.entities.contains(entity)) {
+                return;
+            }
+
+            insert_plain(entity);
+
+            // Insert owner when the first entity it owns is inserted.
+            if (!owner_view.contains(entity)) {
+                return;
+            }
+
+            auto owner = owner_view.get<entity_owner>(entity).client_entity;
+
+            if (owner == entt::null) {
+                return;
+            }
+
+            aabboi.entity_owners.insert_or_assign(entity, owner);
+
+            if (aabboi.owner_counts.contains(owner)) {
+                ++aabboi.owner_counts.at(owner);
+            } else {
+                aabboi.owner_counts.insert_or_assign(owner, 1u);
 
-                if (!contained_entities.contains(entity)) {
-                    contained_entities.emplace(entity);
+                if (!aabboi.entities.contains(owner)) {
+                    insert_plain(owner);
+                }
+            }
+        };
+
+        auto erase_entity = [&](entt::entity entity) {
+            // Entities destroyed on request of their owner are erased from the
+            // set beforehand, thus update owners regardless.
+            if (aabboi.entity_owners.contains(entity)) {
+                auto owner = aabboi.entity_owners.at(entity);
+                aabboi.entity_owners.erase(entity);
+                auto &count = aabboi.owner_counts.at(owner);
+
+                if (--count == 0) {
+                    aabboi.owner_counts.erase(owner);
+
+                    if (aabboi.entities.contains(owner)) {
+                        erase_plain(owner);
+                    }
                 }
             }
 
-            if (!aabboi.island_entities.contains(island_entity)) {
-                aabboi.island_entities.emplace(island_entity);
+            if (aabboi.entities.contains(entity)) {
+                erase_plain(entity);
+            }
+        };
+
+        // Constraints are of interest if all of their bodies are.
+        auto insert_edge_if_connected = [&](entity_graph::index_type edge_index) {
+            auto edge_entity = graph.edge_entity(edge_index);
+
+            if (manifold_view.contains(edge_entity)) {
+                return;
+            }
+
+            auto [first, second] = graph.edge_node_entities(edge_index);
+
+            if (aabboi.entities.contains(first) && aabboi.entities.contains(second)) {
+                insert_entity(edge_entity);
+            }
+        };
+
+        auto erase_edges = [&](entt::entity node_entity) {
+            if (!node_view.contains(node_entity)) {
+                return;
             }
-        });
+
+            auto node_index = node_view.get<graph_node>(node_entity).node_index;
+            graph.visit_edges(node_index, [&](entity_graph::index_type edge_index) {
+                erase_entity(graph.edge_entity(edge_index));
+            });
+        };
+
+        auto insert_edges = [&](entt::entity node_entity) {
+            if (!node_view.contains(node_entity)) {
+                return;
+            }
+
+            auto node_index = node_view.get<graph_node>(node_entity).node_index;
+            graph.visit_edges(node_index, insert_edge_if_connected);
+        };
+
+        for (auto entity : ctx.interest_destroyed_entities) {
+            erase_entity(entity);
+
+            if (aabboi.non_procedural_entities.contains(entity)) {
+                aabboi.non_procedural_entities.erase(entity);
+            }
+        }
+
+        // Non-procedural entities are not in the interest grid since they
+        // can be arbitrarily large, e.g. a static triangle mesh, but there
+        // are usually few of them and they're found quickly in their own tree.
+        entt::sparse_set np_entities;
 
         bphase.query_non_procedural(aabboi.aabb, [&](entt::entity np_entity) {
-            if (!contained_entities.contains(np_entity)) {
-                contained_entities.emplace(np_entity);
+            if (!np_entities.contains(np_entity)) {
+                np_entities.emplace(np_entity);
             }
         });
 
-        // Insert owners of each entity.
-        entt::sparse_set client_entities;
-
-        for (auto entity : contained_entities) {
-            if (owner_view.contains(entity)) {
-                auto client_entity = owner_view.get<entity_owner>(entity).client_entity;
+        for (auto entity : aabboi.non_procedural_entities) {
+            if (!np_entities.contains(entity)) {
+                erase_edges(entity);
+                erase_entity(entity);
+            }
+        }
 
-                if (!client_entities.contains(client_entity)) {
-                    client_entities.emplace(client_entity);
+        if (auto *changes = grid.changes(client_entity)) {
+            for (auto [entity, entered] : *changes) {
+                if (entered) {
+                    insert_entity(entity);
+                    insert_edges(entity);
+                } else {
+                    erase_edges(entity);
+                    erase_entity(entity);
                 }
             }
         }
 
-        contained_entities.insert(client_entities.begin(), client_entities.end());
-
-        // Calculate which entities have entered and exited the AABB of interest.
-        for (auto entity : aabboi.entities) {
-            if (!contained_entities.contains(entity)) {
-                aabboi.destroy_entities.push_back(entity);
+        for (auto entity : np_entities) {
+            if (!aabboi.non_procedural_entities.contains(entity)) {
+                insert_entity(entity);
+                insert_edges(entity);
             }
         }
 
-        for (auto entity : contained_entities) {
-            if (!aabboi.entities.contains(entity)) {
+        aabboi.non_procedural_entities = std::move(np_entities);
+
+        for (auto edge_entity : created_edges) {
+            insert_edge_if_connected(const_registry.get<graph_edge>(edge_entity).edge_index);
+        }
+
+        touched_entities.each([&](entt::entity entity, bool was_contained) {
+            auto is_contained = aabboi.entities.contains(entity);
+
+            if (was_contained && !is_contained) {
+                aabboi.destroy_entities.push_back(entity);
+            } else if (!was_contained && is_contained) {
                 aabboi.create_entities.push_back(entity);
             }
-        }
+        });
+    };
 
-        // Assign the current set of entities which are in an island that
-        // intersects the AABB of interest.
-        aabboi.entities = std::move(contained_entities);
-    });
+    if (aabboi_entities.size() > 1) {
+        parallel_for(size_t{0}, aabboi_entities.size(), update_aabboi);
+    } else if (!aabboi_entities.empty()) {
+        update_aabboi(0);
+    }
+
+    grid.clear_changes();
+    ctx.interest_destroyed_entities.clear();
+    ctx.interest_created_edges.clear();
 }
 
 }
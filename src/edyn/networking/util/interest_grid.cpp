@@ -0,0 +1,279 @@
+#include "edyn/networking/util/interest_grid.hpp"
+#include "edyn/config/config.h"
+#include <algorithm>
+#include <cmath>
+
+namespace edyn {
+
+// Cell coordinates are clamped to 21 bits each so they can be packed into a
+// 64-bit key.
+static constexpr int32_t cell_coord_offset = INT32_C(1) << 20;
+
+interest_grid::interest_grid(scalar cell_size)
+    : m_cell_size(cell_size)
+{
+    EDYN_ASSERT(cell_size > 0);
+}
+
+interest_grid::cell_coords interest_grid::coords_of(const vector3 &pos) const {
+    auto coords = cell_coords{};
+
+    for (int i = 0; i < 3; ++i) {
+        auto c = std::floor(pos[i] / m_cell_size);
+        c = std::clamp(c, scalar(-cell_coord_offset), scalar(cell_coord_offset - 1));
+        coords[i] = static_cast<int32_t>(c);
+    }
+
+    return coords;
+}
+
+interest_grid::cell_range interest_grid::range_of(const AABB &aabb) const {
+    return {coords_of(aabb.min), coords_of(aabb.max)};
+}
+
+uint64_t interest_grid::cell_key(const cell_coords &coords) {
+    auto x = static_cast<uint64_t>(coords[0] + cell_coord_offset);
+    auto y = static_cast<uint64_t>(coords[1] + cell_coord_offset);
+    auto z = static_cast<uint64_t>(coords[2] + cell_coord_offset);
+    return (x << 42) | (y << 21) | z;
+}
+
+uint32_t interest_grid::get_or_create_cell(const cell_coords &coords) {
+    auto key = cell_key(coords);
+
+    if (m_cell_indices.contains(key)) {
+        return m_cell_indices.at(key);
+    }
+
+    auto index = static_cast<uint32_t>(m_cells.size());
+    m_cells.push_back(cell{coords, {}});
+    m_cell_indices.insert_or_assign(key, index);
+    return index;
+}
+
+void interest_grid::insert_into_cell(uint32_t cell_index, entt::entity entity) {
+    m_cells[cell_index].entities.push_back(entity);
+}
+
+void interest_grid::remove_from_cell(uint32_t cell_index, entt::entity entity) {
+    auto &entities = m_cells[cell_index].entities;
+    auto it = std::find(entities.begin(), entities.end(), entity);
+    EDYN_ASSERT(it != entities.end());
+    *it = entities.back();
+    entities.pop_back();
+}
+
+void interest_grid::move_body(entt::entity entity, const vector3 &pos) {
+    auto coords = coords_of(pos);
+
+    if (m_body_cells.contains(entity)) {
+        auto &body = m_body_cells.at(entity);
+        body.position = pos;
+        auto &old_coords = m_cells[body.cell_index].coords;
+
+        if (old_coords == coords) {
+            return;
+        }
+
+        for (auto &client : m_clients) {
+            auto was_in = client.range.contains(old_coords);
+            auto is_in = client.range.contains(coords);
+
+            if (was_in && !is_in) {
+                client.changes.push_back({entity, false});
+            } else if (!was_in && is_in) {
+                client.changes.push_back({entity, true});
+            }
+        }
+
+        remove_from_cell(body.cell_index, entity);
+        // Might reallocate cells and invalidate `old_coords`.
+        auto cell_index = get_or_create_cell(coords);
+        insert_into_cell(cell_index, entity);
+        body.cell_index = cell_index;
+    } else {
+        for (auto &client : m_clients) {
+            if (client.range.contains(coords)) {
+                client.changes.push_back({entity, true});
+            }
+        }
+
+        auto cell_index = get_or_create_cell(coords);
+        insert_into_cell(cell_index, entity);
+        m_body_cells.insert_or_assign(entity, body_entry{pos, cell_index});
+    }
+}
+
+void interest_grid::remove_body(entt::entity entity) {
+    if (!m_body_cells.contains(entity)) {
+        return;
+    }
+
+    remove_from_cell(m_body_cells.at(entity).cell_index, entity);
+    m_body_cells.erase(entity);
+}
+
+template<typename Func>
+void interest_grid::visit_cells(const cell_range &range, Func func) {
+    // Visit the cells in the range directly if there are fewer of them than
+    // the total number of existing cells. Otherwise, visit all cells and
+    // filter out those outside the range.
+    uint64_t volume = 1;
+
+    for (int i = 0; i < 3; ++i) {
+        volume *= static_cast<uint64_t>(range.max[i] - range.min[i] + 1);
+    }
+
+    if (volume < m_cells.size()) {
+        for (auto x = range.min[0]; x <= range.max[0]; ++x) {
+            for (auto y = range.min[1]; y <= range.max[1]; ++y) {
+                for (auto z = range.min[2]; z <= range.max[2]; ++z) {
+                    auto key = cell_key({x, y, z});
+
+                    if (m_cell_indices.contains(key)) {
+                        func(m_cells[m_cell_indices.at(key)]);
+                    }
+                }
+            }
+        }
+    } else {
+        for (auto &cell : m_cells) {
+            if (range.contains(cell.coords)) {
+                func(cell);
+            }
+        }
+    }
+}
+
+void interest_grid::move_client(entt::entity entity, const AABB &aabb) {
+    auto range = range_of(aabb);
+    auto it = std::find_if(m_clients.begin(), m_clients.end(), [&](auto &&client) {
+        return client.entity == entity;
+    });
+
+    if (it == m_clients.end()) {
+        auto &client = m_clients.emplace_back();
+        client.entity = entity;
+        client.aabb = aabb;
+        client.range = range;
+
+        visit_cells(range, [&](const cell &cell) {
+            for (auto body_entity : cell.entities) {
+                client.changes.push_back({body_entity, true});
+            }
+        });
+
+        return;
+    }
+
+    auto &client = *it;
+    client.aabb = aabb;
+
+    if (client.range == range) {
+        return;
+    }
+
+    auto old_range = client.range;
+    client.range = range;
+
+    // Visit the union of both ranges and compare subscription before and after.
+    auto union_range = cell_range{};
+
+    for (int i = 0; i < 3; ++i) {
+        union_range.min[i] = std::min(old_range.min[i], range.min[i]);
+        union_range.max[i] = std::max(old_range.max[i], range.max[i]);
+    }
+
+    visit_cells(union_range, [&](const cell &cell) {
+        auto was_in = old_range.contains(cell.coords);
+        auto is_in = range.contains(cell.coords);
+
+        if (was_in && !is_in) {
+            for (auto body_entity : cell.entities) {
+                client.changes.push_back({body_entity, false});
+            }
+        } else if (!was_in && is_in) {
+            for (auto body_entity : cell.entities) {
+                client.changes.push_back({body_entity, true});
+            }
+        }
+    });
+}
+
+void interest_grid::remove_client(entt::entity entity) {
+    auto it = std::find_if(m_clients.begin(), m_clients.end(), [&](auto &&client) {
+        return client.entity == entity;
+    });
+
+    if (it != m_clients.end()) {
+        *it = std::move(m_clients.back());
+        m_clients.pop_back();
+    }
+}
+
+const std::vector<interest_grid::interest_change> * interest_grid::changes(entt::entity entity) const {
+    for (auto &client : m_clients) {
+        if (client.entity == entity) {
+            return &client.changes;
+        }
+    }
+
+    return nullptr;
+}
+
+void interest_grid::clear_changes() {
+    for (auto &client : m_clients) {
+        client.changes.clear();
+    }
+}
+
+void interest_grid::set_cell_size(scalar cell_size) {
+    EDYN_ASSERT(cell_size > 0);
+
+    if (cell_size == m_cell_size) {
+        return;
+    }
+
+    // Remember where bodies were and which cells clients were subscribed to,
+    // then reassign everything to the new cells and record the difference.
+    auto old_cells = std::move(m_cells);
+    auto old_ranges = std::vector<cell_range>{};
+
+    m_cells.clear();
+    m_cell_indices.clear();
+    m_cell_size = cell_size;
+
+    for (auto &client : m_clients) {
+        old_ranges.push_back(client.range);
+        client.range = range_of(client.aabb);
+    }
+
+    auto bodies = std::vector<std::pair<entt::entity, body_entry>>{};
+    bodies.reserve(m_body_cells.size());
+    m_body_cells.each([&](entt::entity entity, const body_entry &body) {
+        bodies.emplace_back(entity, body);
+    });
+
+    for (auto &[entity, body] : bodies) {
+        auto &old_coords = old_cells[body.cell_index].coords;
+        auto coords = coords_of(body.position);
+
+        for (size_t i = 0; i < m_clients.size(); ++i) {
+            auto &client = m_clients[i];
+            auto was_in = old_ranges[i].contains(old_coords);
+            auto is_in = client.range.contains(coords);
+
+            if (was_in && !is_in) {
+                client.changes.push_back({entity, false});
+            } else if (!was_in && is_in) {
+                client.changes.push_back({entity, true});
+            }
+        }
+
+        auto cell_index = get_or_create_cell(coords);
+        insert_into_cell(cell_index, entity);
+        m_body_cells.at(entity).cell_index = cell_index;
+    }
+}
+
+}
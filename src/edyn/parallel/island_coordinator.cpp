@@ -382,6 +382,7 @@ entt::entity island_coordinator::create_island(double timestamp, bool sleeping,
     }
 
     m_registry->emplace<tree_view>(island_entity, tree.view());
+    m_registry->emplace<island_solver_stats>(island_entity);
 
     return island_entity;
 }
@@ -11,6 +11,7 @@
 #include "edyn/comp/collision_exclusion.hpp"
 #include "edyn/comp/origin.hpp"
 #include "edyn/comp/center_of_mass.hpp"
+#include "edyn/comp/aabb.hpp"
 #include "edyn/config/config.h"
 #include "edyn/math/vector3.hpp"
 #include "edyn/parallel/job.hpp"
@@ -43,12 +44,54 @@
 #include "edyn/networking/extrapolation_result.hpp"
 #include "edyn/networking/comp/discontinuity.hpp"
 #include "edyn/parallel/component_index_source.hpp"
+#include <cmath>
 #include <memory>
 #include <variant>
 #include <entt/entity/registry.hpp>
 
 namespace edyn {
 
+// Values of the components last sent to the coordinator in incremental sync.
+struct synced_aabb : public AABB {};
+
+struct synced_contact_manifold {
+    contact_manifold manifold;
+};
+
+static bool aabb_changed(const AABB &aabb, const AABB &synced, scalar tolerance) {
+    auto tolerance_sqr = tolerance * tolerance;
+    return distance_sqr(aabb.min, synced.min) > tolerance_sqr ||
+           distance_sqr(aabb.max, synced.max) > tolerance_sqr;
+}
+
+static bool manifold_changed(const contact_manifold &manifold, const contact_manifold &synced, scalar tolerance) {
+    if (manifold.body != synced.body || manifold.num_points != synced.num_points) {
+        return true;
+    }
+
+    // Applied impulses are not compared. They're only used for warm starting
+    // in case the manifold is moved into another island.
+    auto tolerance_sqr = tolerance * tolerance;
+
+    for (unsigned i = 0; i < manifold.num_points; ++i) {
+        if (manifold.ids[i] != synced.ids[i]) {
+            return true;
+        }
+
+        auto &cp = manifold.get_point(i);
+        auto &synced_cp = synced.get_point(i);
+
+        if (distance_sqr(cp.pivotA, synced_cp.pivotA) > tolerance_sqr ||
+            distance_sqr(cp.pivotB, synced_cp.pivotB) > tolerance_sqr ||
+            distance_sqr(cp.normal, synced_cp.normal) > tolerance_sqr ||
+            std::abs(cp.distance - synced_cp.distance) > tolerance) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void island_worker_func(job::data_type &data) {
     auto archive = memory_input_archive(data.data(), data.size());
     intptr_t worker_intptr;
@@ -144,6 +187,7 @@ void island_worker::init() {
     // Assign tree view containing the updated broad-phase tree.
     auto tview = bphase.view();
     m_registry.emplace<tree_view>(m_island_entity, tview);
+    m_registry.emplace<island_solver_stats>(m_island_entity);
 
     m_state = state::step;
 }
@@ -325,20 +369,29 @@ void island_worker::on_wake_up_island(const msg::wake_up_island &) {
 }
 
 void island_worker::sync() {
-    // Always update AABBs since they're needed for broad-phase in the coordinator.
-    m_op_builder->replace<AABB>(m_registry);
+    auto &settings = m_registry.ctx().at<edyn::settings>();
 
-    // Updated contact points are needed when moving entities from one island to
-    // another when merging/splitting in the coordinator.
-    // TODO: the island worker refactor would eliminate the need to share these
-    // components continuously.
-    m_op_builder->replace<contact_manifold>(m_registry);
+    if (settings.incremental_island_sync) {
+        sync_changed(settings.island_sync_tolerance);
+    } else {
+        // Always update AABBs since they're needed for broad-phase in the coordinator.
+        m_op_builder->replace<AABB>(m_registry);
+
+        // Updated contact points are needed when moving entities from one island to
+        // another when merging/splitting in the coordinator.
+        // TODO: the island worker refactor would eliminate the need to share these
+        // components continuously.
+        m_op_builder->replace<contact_manifold>(m_registry);
+
+        // Forget values from incremental sync since they'll become outdated.
+        m_registry.clear<synced_aabb>();
+        m_registry.clear<synced_contact_manifold>();
+    }
 
     // Always update discontinuities since they decay in every step.
     m_op_builder->replace<discontinuity>(m_registry);
 
     // Update continuous components.
-    auto &settings = m_registry.ctx().at<edyn::settings>();
     auto &index_source = *settings.index_source;
     m_registry.view<continuous>().each([&](entt::entity entity, continuous &cont) {
         for (size_t i = 0; i < cont.size; ++i) {
@@ -352,6 +405,58 @@ void island_worker::sync() {
     m_message_queue.send<msg::island_reg_ops>(std::move(op));
 }
 
+void island_worker::sync_changed(scalar tolerance) {
+    // Only send AABBs and contact manifolds which changed significantly since
+    // they were last sent. Sleeping entities do not change.
+    m_changed_entities.clear();
+    auto aabb_view = m_registry.view<AABB>(entt::exclude_t<sleeping_tag>{});
+    auto synced_aabb_view = m_registry.view<synced_aabb>();
+
+    for (auto [entity, aabb] : aabb_view.each()) {
+        if (synced_aabb_view.contains(entity)) {
+            auto &synced = synced_aabb_view.get<synced_aabb>(entity);
+
+            if (!aabb_changed(aabb, synced, tolerance)) {
+                continue;
+            }
+
+            static_cast<AABB &>(synced) = aabb;
+        } else {
+            m_registry.emplace<synced_aabb>(entity, aabb);
+        }
+
+        m_changed_entities.push_back(entity);
+    }
+
+    if (!m_changed_entities.empty()) {
+        m_op_builder->replace<AABB>(m_registry, m_changed_entities.begin(), m_changed_entities.end());
+    }
+
+    m_changed_entities.clear();
+    auto manifold_view = m_registry.view<contact_manifold>(entt::exclude_t<sleeping_tag>{});
+    auto synced_manifold_view = m_registry.view<synced_contact_manifold>();
+
+    for (auto [entity, manifold] : manifold_view.each()) {
+        if (synced_manifold_view.contains(entity)) {
+            auto &synced = synced_manifold_view.get<synced_contact_manifold>(entity);
+
+            if (!manifold_changed(manifold, synced.manifold, tolerance)) {
+                continue;
+            }
+
+            synced.manifold = manifold;
+        } else {
+            m_registry.emplace<synced_contact_manifold>(entity, manifold);
+        }
+
+        m_changed_entities.push_back(entity);
+    }
+
+    if (!m_changed_entities.empty()) {
+        m_op_builder->replace<contact_manifold>(m_registry, m_changed_entities.begin(), m_changed_entities.end());
+    }
+}
+
 void island_worker::sync_dirty() {
     // Assign dirty components to the operation builder. This can be called at
     // any time to move the current dirty entities into the next operation.
@@ -575,6 +680,9 @@ void island_worker::finish_step() {
 
     m_op_builder->replace<island_timestamp>(m_registry, m_island_entity);
 
+    m_registry.replace<island_solver_stats>(m_island_entity, m_solver.stats());
+    m_op_builder->replace<island_solver_stats>(m_registry, m_island_entity);
+
     // Update tree view.
     auto &bphase = m_registry.ctx().at<broadphase_worker>();
     auto tview = bphase.view();
@@ -821,6 +929,15 @@ void island_worker::go_to_sleep() {
     m_op_builder->replace<linvel>(m_registry, vel_view_proc.begin(), vel_view_proc.end());
     m_op_builder->replace<angvel>(m_registry, vel_view_proc.begin(), vel_view_proc.end());
     m_op_builder->emplace<sleeping_tag>(m_registry, proc_view.begin(), proc_view.end());
+
+    // Sleeping entities are skipped in incremental sync thus send their final
+    // state now.
+    if (m_registry.ctx().at<edyn::settings>().incremental_island_sync) {
+        m_op_builder->replace<AABB>(m_registry, proc_view.begin(), proc_view.end(), true);
+        m_op_builder->replace<contact_manifold>(m_registry);
+        m_registry.clear<synced_aabb>();
+        m_registry.clear<synced_contact_manifold>();
+    }
 }
 
 void island_worker::on_set_paused(const msg::set_paused &msg) {
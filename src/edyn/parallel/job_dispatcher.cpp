@@ -35,13 +35,14 @@ void job_dispatcher::start() {
 void job_dispatcher::start(size_t num_worker_threads) {
     EDYN_ASSERT(m_workers.empty());
 
+    // Create all workers before starting the threads since workers access
+    // one another when stealing jobs.
     for (size_t i = 0; i < num_worker_threads; ++i) {
-        auto w = std::make_unique<worker>();
-        auto t = std::make_unique<std::thread>(&worker::run, w.get());
-        auto id = t->get_id();
+        m_workers.push_back(std::make_unique<worker>(*this, i));
+    }
 
-        m_threads.push_back(std::move(t));
-        m_workers[id] = std::move(w);
+    for (auto &w : m_workers) {
+        m_threads.push_back(std::make_unique<std::thread>(&worker::run, w.get()));
     }
 
     m_scheduler.start();
@@ -50,9 +51,16 @@ void job_dispatcher::start(size_t num_worker_threads) {
 void job_dispatcher::stop() {
     m_scheduler.stop();
 
-    for (auto &pair : m_workers) {
-        pair.second->stop();
+    for (auto &w : m_workers) {
+        w->stop();
+    }
+
+    // Wake up all sleeping workers so they can exit.
+    {
+        auto lock = std::lock_guard(m_park_mutex);
+        ++m_park_epoch;
     }
+    m_park_cv.notify_all();
 
     for (auto &t : m_threads) {
         t->join();
@@ -69,39 +77,99 @@ bool job_dispatcher::running() const {
 void job_dispatcher::async(const job &j) {
     EDYN_ASSERT(!m_workers.empty());
 
-    if (m_workers.size() == 1) {
-        m_workers.begin()->second->push_job(j);
-        return;
+    // Keep jobs scheduled from a worker thread in that worker, where they can
+    // be inserted without locking. Otherwise, spread them among all workers.
+    auto *current = worker::current();
+
+    if (current != nullptr && current->index() < m_workers.size() &&
+        m_workers[current->index()].get() == current) {
+        current->push_job(j);
+    } else {
+        auto index = m_start.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+        m_workers[index]->push_job(j);
+    }
+
+    notify_workers(1);
+}
+
+void job_dispatcher::async_batch(const std::vector<job> &jobs) {
+    EDYN_ASSERT(!m_workers.empty());
+    // Must not be called from a worker thread.
+    EDYN_ASSERT(worker::current() == nullptr);
+
+    auto start = m_start.fetch_add(jobs.size(), std::memory_order_relaxed);
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        m_workers[(start + i) % m_workers.size()]->push_job(jobs[i]);
     }
 
-    // Find least busy worker to insert job into. Start search from a different
-    // worker each time to create a better spread. This prevents the first
-    // worker from being prioritized and getting most jobs.
-    auto best_id = std::thread::id();
-    auto min_num_jobs = SIZE_MAX;
-    auto start = m_start.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
-    auto end = start + m_workers.size();
-
-    for (size_t i = start; i < end; ++i) {
-        auto k = i % m_workers.size();
-        auto first = m_workers.begin();
-        std::advance(first, k);
-        auto &pair = *first;
-
-        auto s = pair.second->size();
-        if (s == 0) {
-            pair.second->push_job(j);
-            return;
+    notify_workers(jobs.size());
+}
+
+bool job_dispatcher::steal_job(size_t thief_index, job &j) {
+    auto num_workers = m_workers.size();
+
+    // Start from the next worker so that not all thieves go after the same
+    // victim.
+    for (size_t i = 1; i < num_workers; ++i) {
+        auto index = (thief_index + i) % num_workers;
+        auto &victim = *m_workers[index];
+
+        // Skip workers that seem idle without touching their locks.
+        if (victim.has_jobs_hint() && victim.try_take_job(j)) {
+            return true;
         }
-        if (s < min_num_jobs) {
-            min_num_jobs = s;
-            best_id = pair.first;
+    }
+
+    return false;
+}
+
+bool job_dispatcher::has_pending_jobs() const {
+    for (auto &w : m_workers) {
+        if (w->size() > 0) {
+            return true;
         }
     }
 
-    EDYN_ASSERT(m_workers.count(best_id));
+    return false;
+}
+
+void job_dispatcher::park_worker(worker &w) {
+    auto lock = std::unique_lock(m_park_mutex);
+    auto epoch = m_park_epoch;
+    m_num_parked.fetch_add(1, std::memory_order_relaxed);
+
+    // Pairs with the fence in `notify_workers`. Either the job that was just
+    // scheduled is seen here or the parked count is seen there.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (w.running() && !has_pending_jobs()) {
+        m_park_cv.wait(lock, [&]() { return m_park_epoch != epoch; });
+    }
+
+    m_num_parked.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void job_dispatcher::notify_workers(size_t count) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto num_parked = m_num_parked.load(std::memory_order_relaxed);
+
+    if (num_parked == 0 || count == 0) {
+        return;
+    }
 
-    m_workers[best_id]->push_job(j);
+    {
+        auto lock = std::lock_guard(m_park_mutex);
+        ++m_park_epoch;
+    }
+
+    if (count >= num_parked) {
+        m_park_cv.notify_all();
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            m_park_cv.notify_one();
+        }
+    }
 }
 
 void job_dispatcher::async_after(double delta_time, const job &j) {
@@ -132,7 +200,7 @@ job_queue_scheduler job_dispatcher::get_current_scheduler() {
 void job_dispatcher::assure_current_queue() {
     auto id = std::this_thread::get_id();
     // Must not be called from a worker thread.
-    EDYN_ASSERT(!m_workers.count(id));
+    EDYN_ASSERT(worker::current() == nullptr);
 
     auto lock = std::lock_guard(m_queues_mutex);
     if (!m_queues_map.count(id)) {
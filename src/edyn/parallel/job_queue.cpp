@@ -7,6 +7,7 @@ void job_queue::push(const job &j) {
     {
         std::lock_guard<std::mutex> lock(m_mutex);
         m_jobs.push(j);
+        m_size.store(m_jobs.size(), std::memory_order_relaxed);
     }
     m_cv.notify_one();
 }
@@ -19,10 +20,16 @@ job job_queue::pop() {
 
     auto j = m_jobs.front();
     m_jobs.pop();
+    m_size.store(m_jobs.size(), std::memory_order_relaxed);
     return j;
 }
 
 bool job_queue::try_pop(job &j) {
+    // Avoid locking if the queue seems empty. Callers try again later anyway.
+    if (size_hint() == 0) {
+        return false;
+    }
+
     std::lock_guard<std::mutex> lock(m_mutex);
     if (m_jobs.empty()) {
         return false;
@@ -30,6 +37,7 @@ bool job_queue::try_pop(job &j) {
 
     j = m_jobs.front();
     m_jobs.pop();
+    m_size.store(m_jobs.size(), std::memory_order_relaxed);
     return true;
 }
 
@@ -2,6 +2,7 @@
 #include "edyn/parallel/job_dispatcher.hpp"
 #include "edyn/time/time.hpp"
 #include "edyn/config/config.h"
+#include <cmath>
 #include <algorithm>
 
 namespace edyn {
@@ -15,6 +16,8 @@ job_scheduler::~job_scheduler() {
 }
 
 void job_scheduler::start() {
+    m_start_time = performance_time();
+    m_current_tick = 0;
     m_running.store(true, std::memory_order_release);
     m_thread = std::make_unique<std::thread>(&job_scheduler::update, this);
 }
@@ -28,60 +31,123 @@ void job_scheduler::stop() {
     m_thread.reset();
 }
 
+uint64_t job_scheduler::time_to_tick(double time) const {
+    // Round up so jobs never run before their time.
+    auto tick = std::ceil((time - m_start_time) / tick_duration);
+    return tick > 0 ? static_cast<uint64_t>(tick) : 0;
+}
+
 void job_scheduler::schedule_after(const job &j, double delta_time) {
     EDYN_ASSERT(delta_time > 0);
 
     auto lock = std::unique_lock(m_mutex);
-    auto current_time = performance_time();
-    auto job_timestamp = current_time + delta_time;
+    auto tick = time_to_tick(performance_time() + delta_time);
+
+    // The slot of the current tick has already been processed.
+    tick = std::max(tick, m_current_tick + 1);
+
+    m_slots[tick % num_slots].push_back(timed_job{j, tick});
+    ++m_num_jobs;
 
-    auto found_it = std::find_if(m_jobs.begin(), m_jobs.end(), [job_timestamp](const timed_job &j) {
-        return j.m_timestamp > job_timestamp;
-    });
+    auto is_next = tick < m_next_tick;
+
+    if (is_next) {
+        m_next_tick = tick;
+    }
 
-    auto did_replace_first = found_it == m_jobs.begin();
-    m_jobs.insert(found_it, timed_job{j, job_timestamp});
     lock.unlock();
 
-    if (did_replace_first) {
-        // If this new job is going to be inserted at the beginning, it is
-        // necessary to wake up the timer thread so the condition variable
-        // can be readjusted to unblock at the earliest time again.
+    if (is_next) {
+        // Wake up the timer thread so it can readjust the time it waits for
+        // since this job is due earlier than all others.
         m_cv.notify_one();
     }
 }
 
+uint64_t job_scheduler::find_next_tick() const {
+    if (m_num_jobs == 0) {
+        return no_tick;
+    }
+
+    // Look for the first job within one revolution of the wheel.
+    for (size_t i = 1; i <= num_slots; ++i) {
+        auto tick = m_current_tick + i;
+
+        for (auto &timed : m_slots[tick % num_slots]) {
+            if (timed.m_tick == tick) {
+                return tick;
+            }
+        }
+    }
+
+    // All jobs are due further in the future.
+    auto next_tick = no_tick;
+
+    for (auto &slot : m_slots) {
+        for (auto &timed : slot) {
+            next_tick = std::min(timed.m_tick, next_tick);
+        }
+    }
+
+    return next_tick;
+}
+
 void job_scheduler::update() {
     while (m_running.load(std::memory_order_acquire)) {
         auto lock = std::unique_lock(m_mutex);
 
-        if (m_jobs.empty()) {
+        if (m_num_jobs == 0) {
             // Wait until there's a job available.
-            m_cv.wait(lock, [&]() { return !m_jobs.empty() || !m_running.load(std::memory_order_acquire); });
+            m_cv.wait(lock, [&]() { return m_num_jobs > 0 || !m_running.load(std::memory_order_acquire); });
         } else {
-            // Wait until the next job is ready.
-            auto current_time = performance_time();
-            double time_until_next_job = m_jobs.front().m_timestamp - current_time;
+            // Wait until the next job is due or until a job that is due earlier
+            // is scheduled.
+            auto next_tick = m_next_tick;
+            auto time_until_next_job = m_start_time + next_tick * tick_duration - performance_time();
 
             if (time_until_next_job > 0) {
                 auto duration = std::chrono::duration<double>(time_until_next_job);
-                m_cv.wait_for(lock, duration, [&]() { return !m_running.load(std::memory_order_acquire); });
+                m_cv.wait_for(lock, duration, [&]() {
+                    return m_next_tick < next_tick || !m_running.load(std::memory_order_acquire);
+                });
             }
         }
 
-        auto current_time = performance_time();
+        // Collect all jobs due until the current tick, visiting each slot at
+        // most once.
+        auto elapsed_ticks = (performance_time() - m_start_time) / tick_duration;
+        auto current_tick = static_cast<uint64_t>(std::max(elapsed_ticks, 0.0));
 
-        // Dispatch all jobs with a timestamp before the current time.
-        auto it = m_jobs.begin();
-        for (; it != m_jobs.end(); ++it) {
-            if (it->m_timestamp > current_time) {
-                break;
-            }
-            m_dispatcher->async(it->m_job);
+        if (current_tick <= m_current_tick) {
+            continue;
         }
 
-        // Erase all jobs that were dispatched.
-        m_jobs.erase(m_jobs.begin(), it);
+        auto first_tick = std::max(m_current_tick + 1, current_tick >= num_slots ? current_tick - num_slots + 1 : 0);
+
+        for (auto tick = first_tick; tick <= current_tick && m_num_jobs > 0; ++tick) {
+            auto &slot = m_slots[tick % num_slots];
+
+            // Remove due jobs, keeping the ones in later revolutions.
+            auto it = std::remove_if(slot.begin(), slot.end(), [&](const timed_job &timed) {
+                if (timed.m_tick <= current_tick) {
+                    m_due_jobs.push_back(timed.m_job);
+                    return true;
+                }
+                return false;
+            });
+            slot.erase(it, slot.end());
+        }
+
+        m_num_jobs -= m_due_jobs.size();
+        m_current_tick = current_tick;
+        m_next_tick = find_next_tick();
+        lock.unlock();
+
+        // Dispatch all due jobs at once.
+        if (!m_due_jobs.empty()) {
+            m_dispatcher->async_batch(m_due_jobs);
+            m_due_jobs.clear();
+        }
     }
 }
 
@@ -0,0 +1,88 @@
+#include "edyn/parallel/work_stealing_deque.hpp"
+#include "edyn/config/config.h"
+#include <cstring>
+#include <type_traits>
+
+namespace edyn {
+
+static_assert(std::is_trivially_copyable_v<job>);
+
+void work_stealing_deque::slot::store(const job &j) {
+    uint64_t buffer[num_words];
+    std::memcpy(buffer, &j, sizeof(job));
+
+    for (size_t i = 0; i < num_words; ++i) {
+        words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+}
+
+job work_stealing_deque::slot::load() const {
+    uint64_t buffer[num_words];
+
+    for (size_t i = 0; i < num_words; ++i) {
+        buffer[i] = words[i].load(std::memory_order_relaxed);
+    }
+
+    job j;
+    std::memcpy(&j, buffer, sizeof(job));
+    return j;
+}
+
+work_stealing_deque::work_stealing_deque(int64_t initial_capacity) {
+    EDYN_ASSERT(initial_capacity > 0 && (initial_capacity & (initial_capacity - 1)) == 0);
+    auto &buf = m_buffers.emplace_back(std::make_unique<buffer>(initial_capacity));
+    m_buffer.store(buf.get(), std::memory_order_relaxed);
+}
+
+void work_stealing_deque::push(const job &j) {
+    auto bottom = m_bottom.load(std::memory_order_relaxed);
+    auto top = m_top.load(std::memory_order_acquire);
+    auto *buf = m_buffer.load(std::memory_order_relaxed);
+
+    if (bottom - top > buf->capacity - 1) {
+        // Full. Grow the buffer and copy the current range of jobs over.
+        auto &new_buf = m_buffers.emplace_back(std::make_unique<buffer>(buf->capacity * 2));
+
+        for (auto i = top; i < bottom; ++i) {
+            new_buf->at(i).store(buf->at(i).load());
+        }
+
+        buf = new_buf.get();
+        m_buffer.store(buf, std::memory_order_release);
+    }
+
+    buf->at(bottom).store(j);
+    m_bottom.store(bottom + 1, std::memory_order_release);
+}
+
+bool work_stealing_deque::steal(job &j) {
+    auto top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto bottom = m_bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom) {
+        return false;
+    }
+
+    // The slot could be overwritten by the owner once another thread takes
+    // this job, in which case the copy is discarded because the exchange
+    // below fails.
+    auto *buf = m_buffer.load(std::memory_order_acquire);
+    auto stolen = buf->at(top).load();
+
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed)) {
+        return false;
+    }
+
+    j = stolen;
+    return true;
+}
+
+size_t work_stealing_deque::size() const {
+    auto bottom = m_bottom.load(std::memory_order_relaxed);
+    auto top = m_top.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+}
+
+}
@@ -0,0 +1,100 @@
+#include "edyn/parallel/worker.hpp"
+#include "edyn/parallel/job_dispatcher.hpp"
+#include <thread>
+#include <algorithm>
+
+namespace edyn {
+
+// Number of times an idle worker looks for jobs before going to sleep.
+static constexpr unsigned worker_spin_count = 16;
+
+// An idle worker yields this many times between searches for jobs, doubling
+// after each failed search, up to the maximum. Idle workers thus visit the
+// other workers less frequently, which reduces contention on their queues.
+static constexpr unsigned worker_min_backoff = 1;
+static constexpr unsigned worker_max_backoff = 4;
+
+static thread_local worker *t_current_worker = nullptr;
+
+worker::worker(job_dispatcher &dispatcher, size_t index)
+    : m_dispatcher(&dispatcher)
+    , m_index(index)
+{}
+
+worker * worker::current() {
+    return t_current_worker;
+}
+
+void worker::push_job(const job &j) {
+    if (t_current_worker == this) {
+        m_deque.push(j);
+    } else {
+        m_queue.push(j);
+    }
+}
+
+bool worker::try_take_job(job &j) {
+    // Take jobs in the order they were scheduled in both containers. Some
+    // jobs, such as island workers, reschedule themselves continuously and
+    // would starve older jobs otherwise.
+    return m_deque.steal(j) || m_queue.try_pop(j);
+}
+
+bool worker::find_job(job &j) {
+    return try_take_job(j) || m_dispatcher->steal_job(m_index, j);
+}
+
+void worker::run() {
+    t_current_worker = this;
+
+    for (;;) {
+        job j;
+
+        if (find_job(j)) {
+            j();
+            continue;
+        }
+
+        if (!running()) {
+            break;
+        }
+
+        auto found = false;
+        auto backoff = worker_min_backoff;
+
+        for (unsigned i = 0; i < worker_spin_count; ++i) {
+            for (unsigned k = 0; k < backoff; ++k) {
+                std::this_thread::yield();
+            }
+
+            backoff = std::min(backoff * 2, worker_max_backoff);
+
+            if (find_job(j)) {
+                found = true;
+                break;
+            }
+        }
+
+        if (found) {
+            j();
+            continue;
+        }
+
+        m_dispatcher->park_worker(*this);
+    }
+
+    t_current_worker = nullptr;
+}
+
+void worker::once() {
+    job j;
+    while (try_take_job(j)) {
+        j();
+    }
+}
+
+void worker::stop() {
+    m_running.store(false, std::memory_order_relaxed);
+}
+
+}
@@ -63,7 +63,7 @@ void compound_shape::finish() {
     auto report_leaf = [](static_tree::tree_node &node, auto ids_begin, auto ids_end) {
         node.id = *ids_begin;
     };
-    tree.build(aabbs.begin(), aabbs.end(), report_leaf);
+    tree.build(aabbs.begin(), aabbs.end(), report_leaf, 1, static_tree_build_mode::sah);
 }
 
 }
@@ -16,6 +16,7 @@ void convex_mesh::initialize() {
 void convex_mesh::update_calculated_properties() {
     calculate_normals();
     calculate_edges();
+    calculate_vertex_neighbors();
     calculate_relevant_normals();
     calculate_relevant_edges();
 }
@@ -52,35 +53,30 @@ void convex_mesh::calculate_normals() {
     for (size_t i = 0; i < num_faces(); ++i) {
         auto first = faces[i * 2];
         auto count = faces[i * 2 + 1];
-        // Grab first edge.
-        auto i0 = indices[first];
-        auto i1 = indices[first + 1];
-        auto &v0 = vertices[i0];
-        auto &v1 = vertices[i1];
-
-        // Find a second edge that's not collinear.
-        for (size_t j = 1; j < count; ++j) {
-            auto i2 = indices[first + j];
-            auto i3 = indices[first + (j + 1) % count];
-            auto &v2 = vertices[i2];
-            auto &v3 = vertices[i3];
-
-            auto normal = cross(v1 - v0, v3 - v2);
-            auto normal_len_sqr = length_sqr(normal);
-
-            if (normal_len_sqr > EDYN_EPSILON) {
-                normal /= std::sqrt(normal_len_sqr);
-                normals.push_back(normal);
-                break;
-            }
+        auto &v0 = vertices[indices[first]];
+
+        // Sum the cross products of the triangles in a fan around the first
+        // vertex, which gives the area vector of the face. Unlike the cross
+        // product of two edges, it isn't affected by short or nearly
+        // collinear edges and it's the best fit for faces that are not
+        // perfectly flat.
+        auto normal = vector3_zero;
+
+        for (size_t j = 1; j + 1 < count; ++j) {
+            auto &v1 = vertices[indices[first + j]];
+            auto &v2 = vertices[indices[first + j + 1]];
+            normal += cross(v1 - v0, v2 - v0);
         }
-    }
 
-    EDYN_ASSERT(normals.size() == num_faces());
+        auto normal_len_sqr = length_sqr(normal);
+        EDYN_ASSERT(normal_len_sqr > scalar(0));
+        normals.push_back(normal / std::sqrt(normal_len_sqr));
+    }
 }
 
 void convex_mesh::calculate_edges() {
     edges.clear();
+    edge_faces.clear();
 
     for (size_t i = 0; i < num_faces(); ++i) {
         const auto first = faces[i * 2];
@@ -94,6 +90,7 @@ void convex_mesh::calculate_edges() {
             for (size_t k = 0; k < edges.size(); k += 2) {
                 if ((edges[k] == i0 && edges[k + 1] == i1) ||
                     (edges[k] == i1 && edges[k + 1] == i0)) {
+                    edge_faces[k + 1] = static_cast<uint32_t>(i);
                     contains = true;
                     break;
                 }
@@ -102,9 +99,62 @@ void convex_mesh::calculate_edges() {
             if (!contains) {
                 edges.push_back(i0);
                 edges.push_back(i1);
+                // The second face is assigned when the edge is found again.
+                edge_faces.push_back(static_cast<uint32_t>(i));
+                edge_faces.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+}
+
+void convex_mesh::calculate_vertex_neighbors() {
+    vertex_neighbor_offsets.assign(vertices.size() + 1, 0);
+    vertex_neighbors.resize(edges.size());
+
+    for (auto idx : edges) {
+        ++vertex_neighbor_offsets[idx + 1];
+    }
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        vertex_neighbor_offsets[i + 1] += vertex_neighbor_offsets[i];
+    }
+
+    auto cursors = std::vector<uint32_t>(vertex_neighbor_offsets.begin(), vertex_neighbor_offsets.end() - 1);
+
+    for (size_t i = 0; i < edges.size(); i += 2) {
+        auto i0 = edges[i];
+        auto i1 = edges[i + 1];
+        vertex_neighbors[cursors[i0]++] = i1;
+        vertex_neighbors[cursors[i1]++] = i0;
+    }
+}
+
+uint32_t convex_mesh::hill_climb_support_vertex(const std::vector<vector3> &points,
+                                                const vector3 &dir, uint32_t start) const {
+    EDYN_ASSERT(points.size() == vertices.size());
+    EDYN_ASSERT(start < points.size());
+    auto best_idx = start;
+    auto best_proj = dot(points[start], dir);
+    auto improved = true;
+
+    while (improved) {
+        improved = false;
+        auto first = vertex_neighbor_offsets[best_idx];
+        auto last = vertex_neighbor_offsets[best_idx + 1];
+
+        for (auto k = first; k < last; ++k) {
+            auto idx = vertex_neighbors[k];
+            auto proj = dot(points[idx], dir);
+
+            if (proj > best_proj) {
+                best_proj = proj;
+                best_idx = idx;
+                improved = true;
             }
         }
     }
+
+    return best_idx;
 }
 
 void convex_mesh::calculate_relevant_normals() {
@@ -138,7 +138,7 @@ void triangle_mesh::build_triangle_tree() {
     auto report_leaf = [](static_tree::tree_node &node, auto ids_begin, auto ids_end) {
         node.id = *ids_begin;
     };
-    m_triangle_tree.build(aabbs.begin(), aabbs.end(), report_leaf);
+    m_triangle_tree.build(aabbs.begin(), aabbs.end(), report_leaf, 1, static_tree_build_mode::parallel_sah);
 }
 
 triangle_vertices triangle_mesh::get_triangle_vertices(size_t tri_idx) const {
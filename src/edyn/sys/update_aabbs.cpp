@@ -3,7 +3,9 @@
 #include "edyn/comp/orientation.hpp"
 #include "edyn/comp/position.hpp"
 #include "edyn/comp/aabb.hpp"
+#include "edyn/comp/linvel.hpp"
 #include "edyn/comp/tag.hpp"
+#include "edyn/context/settings.hpp"
 #include "edyn/util/aabb_util.hpp"
 #include <entt/entity/registry.hpp>
 
@@ -35,6 +37,15 @@ void update_aabb(entt::entity entity, ShapeType &shape, TransformView &tr_view,
     aabb = updated_aabb(shape, origin, orn);
 }
 
+static void sweep_aabb(AABB &aabb, const vector3 &v, scalar dt) {
+    // Extend AABB to contain the region the body will move through in the
+    // next step, thus the broadphase will find the bodies in its path before
+    // it moves past them.
+    auto displacement = v * dt;
+    aabb.min += min(displacement, vector3_zero);
+    aabb.max += max(displacement, vector3_zero);
+}
+
 void update_aabb(entt::registry &registry, entt::entity entity) {
     auto tr_view = registry.view<position, orientation, AABB>();
     auto origin_view = registry.view<origin>();
@@ -42,6 +53,11 @@ void update_aabb(entt::registry &registry, entt::entity entity) {
     visit_shape(registry, entity, [&](auto &&shape) {
         update_aabb(entity, shape, tr_view, origin_view);
     });
+
+    if (registry.all_of<ccd_tag, linvel>(entity)) {
+        auto dt = registry.ctx().at<settings>().fixed_dt;
+        sweep_aabb(registry.get<AABB>(entity), registry.get<linvel>(entity), dt);
+    }
 }
 
 template<typename ShapeType>
@@ -63,6 +79,13 @@ void update_aabbs(entt::registry &registry, std::tuple<Ts...>) {
 void update_aabbs(entt::registry &registry) {
     // Update AABBs for all shapes that can be transformed.
     update_aabbs(registry, dynamic_shapes_tuple);
+
+    auto dt = registry.ctx().at<settings>().fixed_dt;
+    auto ccd_view = registry.view<AABB, linvel, ccd_tag>();
+
+    for (auto [entity, aabb, v] : ccd_view.each()) {
+        sweep_aabb(aabb, v, dt);
+    }
 }
 
 }
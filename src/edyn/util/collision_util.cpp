@@ -397,9 +397,32 @@ void destroy_contact_point(entt::registry &registry, entt::entity manifold_entit
     registry.get_or_emplace<dirty>(manifold_entity).updated<contact_manifold, contact_manifold_events>();
 }
 
+scalar get_collision_threshold(std::array<entt::entity, 2> body,
+                               const linvel_view_t &linvel_view, const ccd_view_t &ccd_view,
+                               scalar dt) {
+    if (!ccd_view.contains(body[0]) && !ccd_view.contains(body[1])) {
+        return collision_threshold;
+    }
+
+    // Only linear velocity is taken into account. Fast spinning bodies can
+    // still tunnel at their extremities.
+    auto relvel = vector3_zero;
+
+    if (linvel_view.contains(body[0])) {
+        relvel += linvel_view.get<linvel>(body[0]);
+    }
+
+    if (linvel_view.contains(body[1])) {
+        relvel -= linvel_view.get<linvel>(body[1]);
+    }
+
+    return collision_threshold + length(relvel) * dt;
+}
+
 void detect_collision(std::array<entt::entity, 2> body, collision_result &result,
                       const detect_collision_body_view_t &body_view, const origin_view_t &origin_view,
-                      const tuple_of_shape_views_t &views_tuple) {
+                      const tuple_of_shape_views_t &views_tuple, scalar threshold,
+                      sat_axis_cache *sat_cache) {
     auto &aabbA = body_view.get<AABB>(body[0]);
     auto &aabbB = body_view.get<AABB>(body[1]);
     const auto offset = vector3_one * -contact_breaking_threshold;
@@ -421,7 +444,7 @@ void detect_collision(std::array<entt::entity, 2> body, collision_result &result
 
         auto shape_indexA = body_view.get<shape_index>(body[0]);
         auto shape_indexB = body_view.get<shape_index>(body[1]);
-        auto ctx = collision_context{originA, ornA, aabbA, originB, ornB, aabbB, collision_threshold};
+        auto ctx = collision_context{originA, ornA, aabbA, originB, ornB, aabbB, threshold, sat_cache};
 
         visit_shape(shape_indexA, body[0], views_tuple, [&](auto &&shA) {
             visit_shape(shape_indexB, body[1], views_tuple, [&](auto &&shB) {
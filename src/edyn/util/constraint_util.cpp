@@ -13,6 +13,8 @@
 #include "edyn/parallel/component_index_source.hpp"
 #include "edyn/constraints/constraint_row.hpp"
 #include "edyn/dynamics/material_mixing.hpp"
+#include "edyn/math/constants.hpp"
+#include <cmath>
 
 namespace edyn {
 
@@ -113,8 +115,10 @@ void swap_manifold(contact_manifold &manifold) {
     });
 }
 
-scalar get_effective_mass(const constraint_row &row) {
-    return get_effective_mass(row.J, row.inv_mA, row.inv_IA, row.inv_mB, row.inv_IB);
+scalar get_effective_mass(const constraint_row &row, const std::vector<solver_body> &bodies) {
+    auto &bodyA = bodies[row.bodyA];
+    auto &bodyB = bodies[row.bodyB];
+    return get_effective_mass(row.J, bodyA.inv_m, bodyA.inv_I, bodyB.inv_m, bodyB.inv_I);
 }
 
 scalar get_effective_mass(const std::array<vector3, 4> &J,
@@ -141,14 +145,11 @@ scalar get_relative_speed(const std::array<vector3, 4> &J,
 }
 
 void prepare_row(constraint_row &row,
+                 const std::vector<solver_body> &bodies,
                  const constraint_row_options &options,
                  const vector3 &linvelA, const vector3 &angvelA,
                  const vector3 &linvelB, const vector3 &angvelB) {
-    auto J_invM_JT = dot(row.J[0], row.J[0]) * row.inv_mA +
-                     dot(row.inv_IA * row.J[1], row.J[1]) +
-                     dot(row.J[2], row.J[2]) * row.inv_mB +
-                     dot(row.inv_IB * row.J[3], row.J[3]);
-    row.eff_mass = 1 / J_invM_JT;
+    row.eff_mass = get_effective_mass(row, bodies);
 
     auto relvel = dot(row.J[0], linvelA) +
                   dot(row.J[1], angvelA) +
@@ -156,20 +157,30 @@ void prepare_row(constraint_row &row,
                   dot(row.J[3], angvelB);
 
     row.rhs = -(options.error * options.erp + relvel * (1 + options.restitution));
+    row.error = options.error;
+
+    // Rows with an error of `large_scalar` are driven at their impulse limits
+    // instead of correcting a position error, thus their bias must not be
+    // recalculated.
+    auto has_position_error = options.error != 0 && std::abs(options.error) < large_scalar;
+    row.erp = has_position_error ? options.erp : scalar(0);
 }
 
-void apply_impulse(scalar impulse, constraint_row &row) {
+void apply_impulse(scalar impulse, const constraint_row &row, std::vector<solver_body> &bodies) {
+    auto &bodyA = bodies[row.bodyA];
+    auto &bodyB = bodies[row.bodyB];
+
     // Apply linear impulse.
-    *row.dvA += row.inv_mA * row.J[0] * impulse;
-    *row.dvB += row.inv_mB * row.J[2] * impulse;
+    bodyA.dv += bodyA.inv_m * row.J[0] * impulse;
+    bodyB.dv += bodyB.inv_m * row.J[2] * impulse;
 
     // Apply angular impulse.
-    *row.dwA += row.inv_IA * row.J[1] * impulse;
-    *row.dwB += row.inv_IB * row.J[3] * impulse;
+    bodyA.dw += bodyA.inv_I * row.J[1] * impulse;
+    bodyB.dw += bodyB.inv_I * row.J[3] * impulse;
 }
 
-void warm_start(constraint_row &row) {
-    apply_impulse(row.impulse, row);
+void warm_start(const constraint_row &row, std::vector<solver_body> &bodies) {
+    apply_impulse(row.impulse, row, bodies);
 }
 
 }
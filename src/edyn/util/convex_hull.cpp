@@ -0,0 +1,503 @@
+#include "edyn/util/convex_hull.hpp"
+#include "edyn/shapes/convex_mesh.hpp"
+#include "edyn/config/config.h"
+#include "edyn/math/math.hpp"
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+
+namespace edyn {
+
+namespace {
+
+constexpr auto null_index = std::numeric_limits<uint32_t>::max();
+
+struct hull_face {
+    // Vertices in counter-clockwise order when seen from outside.
+    std::array<uint32_t, 3> vertices;
+    vector3 normal;
+    scalar offset;
+    // Points outside of this face which have not been added to the hull.
+    std::vector<uint32_t> outside;
+    uint32_t furthest {null_index};
+    scalar furthest_distance {0};
+    bool alive {true};
+
+    scalar distance(const vector3 &point) const {
+        return dot(normal, point) - offset;
+    }
+};
+
+// Key of the directed edge from `i0` to `i1`.
+uint64_t edge_key(uint32_t i0, uint32_t i1) {
+    return (static_cast<uint64_t>(i0) << 32) | i1;
+}
+
+// Incremental construction of the hull by the quickhull algorithm. Faces are
+// triangles which are never removed from the array, only marked as dead, and
+// are found across edges using a map of directed edges to faces.
+class quickhull {
+public:
+    quickhull(const std::vector<vector3> &points, scalar tolerance)
+        : m_points(points)
+        , m_tolerance(tolerance)
+    {
+        // Distance below which a point is considered to be on the plane of a
+        // face due to the limited precision of the calculation.
+        auto max_coords = vector3_zero;
+
+        for (auto &point : points) {
+            max_coords = max(max_coords, abs(point));
+        }
+
+        m_visibility_epsilon = 3 * EDYN_EPSILON * (max_coords.x + max_coords.y + max_coords.z);
+    }
+
+    bool build_simplex();
+    bool add_furthest_point();
+
+    size_t num_vertices() const {
+        return m_num_vertices;
+    }
+
+    const std::vector<hull_face> &faces() const {
+        return m_faces;
+    }
+
+    // Index of face which contains the directed edge, or `null_index`.
+    uint32_t edge_face(uint32_t i0, uint32_t i1) const {
+        auto it = m_edges.find(edge_key(i0, i1));
+        return it == m_edges.end() ? null_index : it->second;
+    }
+
+private:
+    uint32_t add_face(uint32_t i0, uint32_t i1, uint32_t i2);
+    void assign_outside(const std::vector<uint32_t> &candidates,
+                        const std::vector<uint32_t> &faces);
+
+    const std::vector<vector3> &m_points;
+    scalar m_tolerance;
+    scalar m_visibility_epsilon;
+    std::vector<hull_face> m_faces;
+    std::unordered_map<uint64_t, uint32_t> m_edges;
+    size_t m_num_vertices {0};
+
+    // Faces with points outside of them ordered by the distance of their
+    // furthest point. The outside points of a face don't change until it's
+    // removed, thus dead faces are simply skipped when popped.
+    std::priority_queue<std::pair<scalar, uint32_t>> m_queue;
+};
+
+uint32_t quickhull::add_face(uint32_t i0, uint32_t i1, uint32_t i2) {
+    auto &v0 = m_points[i0];
+    auto &v1 = m_points[i1];
+    auto &v2 = m_points[i2];
+
+    auto face = hull_face{};
+    face.vertices = {i0, i1, i2};
+    face.normal = normalize(cross(v1 - v0, v2 - v0));
+    face.offset = dot(face.normal, v0);
+
+    auto face_idx = static_cast<uint32_t>(m_faces.size());
+    m_faces.push_back(std::move(face));
+
+    m_edges[edge_key(i0, i1)] = face_idx;
+    m_edges[edge_key(i1, i2)] = face_idx;
+    m_edges[edge_key(i2, i0)] = face_idx;
+
+    return face_idx;
+}
+
+// Assigns each candidate point to the first face it is outside of. Points
+// which are not outside any face are inside the hull and are discarded.
+void quickhull::assign_outside(const std::vector<uint32_t> &candidates,
+                               const std::vector<uint32_t> &faces) {
+    for (auto point_idx : candidates) {
+        auto &point = m_points[point_idx];
+
+        for (auto face_idx : faces) {
+            auto &face = m_faces[face_idx];
+            auto dist = face.distance(point);
+
+            if (dist > m_tolerance) {
+                face.outside.push_back(point_idx);
+
+                if (dist > face.furthest_distance) {
+                    face.furthest_distance = dist;
+                    face.furthest = point_idx;
+                }
+
+                break;
+            }
+        }
+    }
+
+    for (auto face_idx : faces) {
+        auto &face = m_faces[face_idx];
+
+        if (!face.outside.empty()) {
+            m_queue.emplace(face.furthest_distance, face_idx);
+        }
+    }
+}
+
+bool quickhull::build_simplex() {
+    if (m_points.size() < 4) {
+        return false;
+    }
+
+    // Find the two most distant points among the extreme points along the
+    // coordinate axes.
+    std::array<uint32_t, 6> extremes {};
+
+    for (uint32_t i = 0; i < m_points.size(); ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (m_points[i][axis] < m_points[extremes[axis * 2]][axis]) {
+                extremes[axis * 2] = i;
+            }
+
+            if (m_points[i][axis] > m_points[extremes[axis * 2 + 1]][axis]) {
+                extremes[axis * 2 + 1] = i;
+            }
+        }
+    }
+
+    uint32_t i0 = 0, i1 = 0;
+    scalar max_dist_sqr = 0;
+
+    for (auto a : extremes) {
+        for (auto b : extremes) {
+            auto dist_sqr = distance_sqr(m_points[a], m_points[b]);
+
+            if (dist_sqr > max_dist_sqr) {
+                max_dist_sqr = dist_sqr;
+                i0 = a;
+                i1 = b;
+            }
+        }
+    }
+
+    if (max_dist_sqr <= square(m_tolerance)) {
+        return false;
+    }
+
+    // Point furthest from the line.
+    auto &p0 = m_points[i0];
+    auto line_dir = normalize(m_points[i1] - p0);
+    auto i2 = null_index;
+    max_dist_sqr = square(m_tolerance);
+
+    for (uint32_t i = 0; i < m_points.size(); ++i) {
+        auto dist_sqr = length_sqr(cross(m_points[i] - p0, line_dir));
+
+        if (dist_sqr > max_dist_sqr) {
+            max_dist_sqr = dist_sqr;
+            i2 = i;
+        }
+    }
+
+    if (i2 == null_index) {
+        return false;
+    }
+
+    // Point furthest from the plane.
+    auto plane_normal = normalize(cross(m_points[i1] - p0, m_points[i2] - p0));
+    auto i3 = null_index;
+    auto max_dist = m_tolerance;
+
+    for (uint32_t i = 0; i < m_points.size(); ++i) {
+        auto dist = std::abs(dot(m_points[i] - p0, plane_normal));
+
+        if (dist > max_dist) {
+            max_dist = dist;
+            i3 = i;
+        }
+    }
+
+    if (i3 == null_index) {
+        return false;
+    }
+
+    // Make the base triangle face away from the fourth point.
+    if (dot(m_points[i3] - p0, plane_normal) > 0) {
+        std::swap(i1, i2);
+    }
+
+    auto faces = std::vector<uint32_t>{
+        add_face(i0, i1, i2),
+        add_face(i0, i3, i1),
+        add_face(i1, i3, i2),
+        add_face(i2, i3, i0)
+    };
+    m_num_vertices = 4;
+
+    auto candidates = std::vector<uint32_t>{};
+
+    for (uint32_t i = 0; i < m_points.size(); ++i) {
+        if (i != i0 && i != i1 && i != i2 && i != i3) {
+            candidates.push_back(i);
+        }
+    }
+
+    assign_outside(candidates, faces);
+
+    return true;
+}
+
+// Adds the point which is furthest outside of the hull. Returns false if
+// there are no points outside of the hull.
+bool quickhull::add_furthest_point() {
+    while (!m_queue.empty() && !m_faces[m_queue.top().second].alive) {
+        m_queue.pop();
+    }
+
+    if (m_queue.empty()) {
+        return false;
+    }
+
+    auto eye_face = m_queue.top().second;
+    m_queue.pop();
+
+    auto eye_idx = m_faces[eye_face].furthest;
+    auto &eye = m_points[eye_idx];
+
+    // Find all faces visible from the eye point, which are connected, and
+    // the horizon, i.e. the edges between visible and hidden faces.
+    auto visible = std::vector<uint32_t>{eye_face};
+    auto horizon = std::vector<std::array<uint32_t, 2>>{};
+    m_faces[eye_face].alive = false;
+
+    for (size_t k = 0; k < visible.size(); ++k) {
+        auto vertices = m_faces[visible[k]].vertices;
+
+        for (size_t j = 0; j < 3; ++j) {
+            auto i0 = vertices[j];
+            auto i1 = vertices[(j + 1) % 3];
+            auto neighbor_idx = edge_face(i1, i0);
+            EDYN_ASSERT(neighbor_idx != null_index);
+            auto &neighbor = m_faces[neighbor_idx];
+
+            if (!neighbor.alive) {
+                continue;
+            }
+
+            // Faces which see the eye by less than the tolerance must also be
+            // replaced, otherwise the new faces could fold over them.
+            if (neighbor.distance(eye) > m_visibility_epsilon) {
+                neighbor.alive = false;
+                visible.push_back(neighbor_idx);
+            } else {
+                horizon.push_back({i0, i1});
+            }
+        }
+    }
+
+    // Points outside of the visible faces must be reassigned to the new
+    // faces.
+    auto candidates = std::vector<uint32_t>{};
+
+    for (auto face_idx : visible) {
+        auto &face = m_faces[face_idx];
+
+        for (auto point_idx : face.outside) {
+            if (point_idx != eye_idx) {
+                candidates.push_back(point_idx);
+            }
+        }
+
+        face.outside.clear();
+        face.outside.shrink_to_fit();
+
+        for (size_t j = 0; j < 3; ++j) {
+            m_edges.erase(edge_key(face.vertices[j], face.vertices[(j + 1) % 3]));
+        }
+    }
+
+    // Connect the horizon to the eye point.
+    auto new_faces = std::vector<uint32_t>{};
+    new_faces.reserve(horizon.size());
+
+    for (auto &edge : horizon) {
+        new_faces.push_back(add_face(edge[0], edge[1], eye_idx));
+    }
+
+    assign_outside(candidates, new_faces);
+    ++m_num_vertices;
+
+    return true;
+}
+
+}
+
+bool make_convex_hull(const std::vector<vector3> &points, convex_mesh &mesh,
+                      const convex_hull_options &options) {
+    EDYN_ASSERT(options.max_vertices == 0 || options.max_vertices >= 4);
+
+    auto hull = quickhull(points, options.tolerance);
+
+    if (!hull.build_simplex()) {
+        return false;
+    }
+
+    while (options.max_vertices == 0 || hull.num_vertices() < options.max_vertices) {
+        if (!hull.add_furthest_point()) {
+            break;
+        }
+    }
+
+    // Merge coplanar triangles into polygons. Starting from the largest
+    // triangle that hasn't been merged yet, grow the polygon across edges
+    // while all vertices of the adjacent triangle are close to the plane of
+    // the first. Comparing against the first triangle instead of the
+    // adjacent one keeps curved regions from being merged into a single face.
+    auto &faces = hull.faces();
+    auto triangles = std::vector<uint32_t>{};
+
+    for (uint32_t i = 0; i < faces.size(); ++i) {
+        if (faces[i].alive) {
+            triangles.push_back(i);
+        }
+    }
+
+    auto triangle_area_sqr = [&](uint32_t face_idx) {
+        auto &vertices = faces[face_idx].vertices;
+        auto &v0 = points[vertices[0]];
+        return length_sqr(cross(points[vertices[1]] - v0, points[vertices[2]] - v0));
+    };
+
+    std::sort(triangles.begin(), triangles.end(), [&](auto a, auto b) {
+        return triangle_area_sqr(a) > triangle_area_sqr(b);
+    });
+
+    auto merge_tolerance = std::max(options.tolerance, options.coplanar_tolerance);
+    auto polygon_of_face = std::vector<uint32_t>(faces.size(), null_index);
+    auto polygons = std::vector<std::vector<uint32_t>>{};
+
+    for (auto seed_idx : triangles) {
+        if (polygon_of_face[seed_idx] != null_index) {
+            continue;
+        }
+
+        auto polygon_idx = static_cast<uint32_t>(polygons.size());
+        auto &seed = faces[seed_idx];
+        auto &members = polygons.emplace_back();
+        members.push_back(seed_idx);
+        polygon_of_face[seed_idx] = polygon_idx;
+
+        for (size_t k = 0; k < members.size(); ++k) {
+            auto &vertices = faces[members[k]].vertices;
+
+            for (size_t j = 0; j < 3; ++j) {
+                auto neighbor_idx = hull.edge_face(vertices[(j + 1) % 3], vertices[j]);
+
+                if (polygon_of_face[neighbor_idx] != null_index) {
+                    continue;
+                }
+
+                auto &neighbor = faces[neighbor_idx];
+                auto coplanar = dot(neighbor.normal, seed.normal) > 0 &&
+                    std::all_of(neighbor.vertices.begin(), neighbor.vertices.end(), [&](auto idx) {
+                        return std::abs(seed.distance(points[idx])) <= merge_tolerance;
+                    });
+
+                if (coplanar) {
+                    polygon_of_face[neighbor_idx] = polygon_idx;
+                    members.push_back(neighbor_idx);
+                }
+            }
+        }
+    }
+
+    // The boundary of each polygon is made of the edges of its triangles
+    // which are adjacent to a triangle of another polygon. Edges are stored
+    // as a map from the first to the second vertex to walk around it.
+    auto loops = std::vector<std::vector<uint32_t>>(polygons.size());
+    auto face_count = std::vector<uint32_t>(points.size(), 0);
+
+    for (size_t polygon_idx = 0; polygon_idx < polygons.size(); ++polygon_idx) {
+        auto next_vertex = std::unordered_map<uint32_t, uint32_t>{};
+
+        for (auto face_idx : polygons[polygon_idx]) {
+            auto &vertices = faces[face_idx].vertices;
+
+            for (size_t j = 0; j < 3; ++j) {
+                auto i0 = vertices[j];
+                auto i1 = vertices[(j + 1) % 3];
+
+                if (polygon_of_face[hull.edge_face(i1, i0)] != polygon_idx) {
+                    next_vertex[i0] = i1;
+                }
+            }
+        }
+
+        auto &loop = loops[polygon_idx];
+        auto first = next_vertex.begin()->first;
+        auto idx = first;
+
+        do {
+            loop.push_back(idx);
+            ++face_count[idx];
+            idx = next_vertex.at(idx);
+        } while (idx != first && loop.size() <= next_vertex.size());
+
+        EDYN_ASSERT(loop.size() == next_vertex.size());
+    }
+
+    // Vertices of a convex polyhedron are shared by at least three faces.
+    // Those shared by two are usually in the middle of an edge between two
+    // merged polygons and are removed if they're collinear with their
+    // neighbors. Vertices inside of merged polygons are not referenced by any
+    // face anymore.
+    auto removed = std::vector<bool>(points.size(), false);
+
+    for (auto &loop : loops) {
+        for (size_t k = 0; k < loop.size(); ++k) {
+            auto idx = loop[k];
+
+            if (face_count[idx] != 2) {
+                continue;
+            }
+
+            auto &prev = points[loop[(k + loop.size() - 1) % loop.size()]];
+            auto &next = points[loop[(k + 1) % loop.size()]];
+            auto line_dir = normalize(next - prev);
+
+            if (length(cross(points[idx] - prev, line_dir)) <= merge_tolerance) {
+                removed[idx] = true;
+            }
+        }
+    }
+
+    auto vertex_index = std::vector<uint32_t>(points.size(), null_index);
+    mesh = convex_mesh{};
+
+    for (auto &loop : loops) {
+        auto first_index = static_cast<uint32_t>(mesh.indices.size());
+
+        for (auto idx : loop) {
+            if (removed[idx]) {
+                continue;
+            }
+
+            if (vertex_index[idx] == null_index) {
+                vertex_index[idx] = static_cast<uint32_t>(mesh.vertices.size());
+                mesh.vertices.push_back(points[idx]);
+            }
+
+            mesh.indices.push_back(vertex_index[idx]);
+        }
+
+        auto count = static_cast<uint32_t>(mesh.indices.size()) - first_index;
+        EDYN_ASSERT(count >= 3);
+        mesh.faces.push_back(first_index);
+        mesh.faces.push_back(count);
+    }
+
+    mesh.initialize();
+
+    return true;
+}
+
+}
@@ -127,6 +127,10 @@ void make_rigidbody(entt::entity entity, entt::registry &registry, const rigidbo
         registry.emplace<continuous_contacts_tag>(entity);
     }
 
+    if (def.ccd && def.kind == rigidbody_kind::rb_dynamic) {
+        registry.emplace<ccd_tag>(entity);
+    }
+
     switch (def.kind) {
     case rigidbody_kind::rb_dynamic:
         registry.emplace<dynamic_tag>(entity);
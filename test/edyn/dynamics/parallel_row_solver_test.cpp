@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include <edyn/constraints/constraint_row.hpp>
+#include <edyn/dynamics/parallel_row_solver.hpp>
+#include <edyn/parallel/job_dispatcher.hpp>
+
+namespace {
+
+constexpr size_t num_workers = 6;
+
+std::vector<edyn::solver_body> make_bodies(size_t count) {
+    auto bodies = std::vector<edyn::solver_body>(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        auto &body = bodies[i];
+        body.dv = edyn::vector3_zero;
+        body.dw = edyn::vector3_zero;
+
+        // Some static bodies, which are shared by rows of the same color.
+        if (i % 50 == 0) {
+            body.inv_m = 0;
+            body.inv_I = edyn::matrix3x3_zero;
+        } else {
+            body.inv_m = 1;
+            body.inv_I = edyn::matrix3x3_identity;
+        }
+    }
+
+    return bodies;
+}
+
+// Rows between random pairs of bodies, which results in many colors with
+// enough rows to be solved in parallel.
+std::vector<edyn::constraint_row> make_rows(size_t count, size_t num_bodies, bool zero_jacobian) {
+    auto rng = std::mt19937(3);
+    auto dist = std::uniform_real_distribution<edyn::scalar>(-1, 1);
+    auto rows = std::vector<edyn::constraint_row>(count);
+
+    for (auto &row : rows) {
+        row.bodyA = rng() % num_bodies;
+
+        do {
+            row.bodyB = rng() % num_bodies;
+        } while (row.bodyB == row.bodyA);
+
+        if (zero_jacobian) {
+            // The relative velocity is always zero thus every time the row is
+            // solved the same impulse is applied and the accumulated impulse
+            // counts how many times it was solved.
+            for (auto &J : row.J) {
+                J = edyn::vector3_zero;
+            }
+
+            row.eff_mass = 1;
+            row.rhs = 1;
+        } else {
+            for (auto &J : row.J) {
+                J = edyn::vector3{dist(rng), dist(rng), dist(rng)};
+            }
+
+            row.eff_mass = edyn::scalar(0.3);
+            row.rhs = dist(rng);
+        }
+
+        row.lower_limit = -EDYN_SCALAR_MAX;
+        row.upper_limit = EDYN_SCALAR_MAX;
+        row.impulse = 0;
+    }
+
+    return rows;
+}
+
+class parallel_row_solver_test : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dispatcher.start(num_workers);
+    }
+
+    void TearDown() override {
+        dispatcher.stop();
+    }
+
+    edyn::job_dispatcher dispatcher;
+};
+
+}
+
+TEST_F(parallel_row_solver_test, rows_solved_once_per_iteration) {
+    auto bodies = make_bodies(3000);
+    auto rows = make_rows(12000, bodies.size(), true);
+
+    edyn::parallel_row_solver solver;
+    solver.build(rows, bodies);
+    ASSERT_GT(solver.num_colors(), size_t(2));
+
+    // Jobs of one color can still be running when the next color starts,
+    // and of the last color when the next iteration starts.
+    constexpr size_t num_iterations = 200;
+
+    for (size_t i = 0; i < num_iterations; ++i) {
+        solver.solve(dispatcher, bodies);
+
+        for (auto &row : rows) {
+            ASSERT_EQ(row.impulse, static_cast<edyn::scalar>(i + 1));
+        }
+    }
+}
+
+TEST_F(parallel_row_solver_test, same_result_as_sequential) {
+    auto bodies = make_bodies(3000);
+    auto rows = make_rows(12000, bodies.size(), false);
+
+    // Solves sequentially since the dispatcher is not running.
+    edyn::job_dispatcher sequential_dispatcher;
+
+    for (size_t rep = 0; rep < 10; ++rep) {
+        auto bodies_seq = bodies;
+        auto bodies_par = bodies;
+        auto rows_seq = rows;
+        auto rows_par = rows;
+
+        edyn::parallel_row_solver solver_seq;
+        edyn::parallel_row_solver solver_par;
+        solver_seq.build(rows_seq, bodies_seq);
+        solver_par.build(rows_par, bodies_par);
+
+        for (size_t i = 0; i < 10; ++i) {
+            auto residual_seq = solver_seq.solve(sequential_dispatcher, bodies_seq);
+            auto residual_par = solver_par.solve(dispatcher, bodies_par);
+            ASSERT_EQ(residual_seq, residual_par);
+        }
+
+        // Rows of the same color do not share dynamic bodies thus the order
+        // in which they're solved within a color does not change the result.
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            ASSERT_EQ(bodies_seq[i].dv, bodies_par[i].dv);
+            ASSERT_EQ(bodies_seq[i].dw, bodies_par[i].dw);
+        }
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+            ASSERT_EQ(rows_seq[i].impulse, rows_par[i].impulse);
+        }
+    }
+}
@@ -0,0 +1,310 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <edyn/comp/position.hpp>
+#include <edyn/comp/orientation.hpp>
+#include <edyn/comp/linvel.hpp>
+#include <edyn/comp/angvel.hpp>
+#include <edyn/networking/util/pool_snapshot_data.hpp>
+#include <edyn/networking/util/snapshot_codec.hpp>
+#include <edyn/serialization/memory_archive.hpp>
+
+namespace {
+
+std::vector<entt::entity> make_entities(size_t count) {
+    auto entities = std::vector<entt::entity>{};
+
+    for (size_t i = 0; i < count; ++i) {
+        entities.push_back(static_cast<entt::entity>(i + 1));
+    }
+
+    return entities;
+}
+
+// Packs the components against a baseline, writes them into a buffer, reads
+// them back and unpacks them as a client would.
+template<typename Component>
+std::vector<Component> round_trip(const edyn::snapshot_codec_settings &settings,
+                                  const std::vector<entt::entity> &entities,
+                                  const std::vector<Component> &components,
+                                  const edyn::snapshot_baseline *sent_baseline,
+                                  const edyn::snapshot_baseline *received_baseline,
+                                  edyn::snapshot_baseline &sent,
+                                  edyn::snapshot_baseline &received,
+                                  size_t *packed_size = nullptr) {
+    auto pool = edyn::pool_snapshot_data_impl<Component>{};
+
+    for (size_t i = 0; i < components.size(); ++i) {
+        pool.entity_indices.push_back(static_cast<edyn::pool_snapshot_data::index_type>(i));
+    }
+
+    pool.components = components;
+    pool.pack(settings, entities, sent_baseline, sent);
+    EXPECT_FALSE(pool.packed.empty());
+
+    if (packed_size) {
+        *packed_size = pool.packed.size();
+    }
+
+    auto buffer = std::vector<uint8_t>{};
+    auto output = edyn::memory_output_archive(buffer);
+    pool.write(output);
+
+    auto result = edyn::pool_snapshot_data_impl<Component>{};
+    auto input = edyn::memory_input_archive(buffer.data(), buffer.size());
+    result.read(input);
+    EXPECT_FALSE(input.failed());
+    EXPECT_TRUE(result.unpack(entities, received_baseline, received));
+    EXPECT_EQ(result.entity_indices, pool.entity_indices);
+
+    return result.components;
+}
+
+template<typename Component>
+void expect_same_quantized_values(const edyn::snapshot_baseline &sent,
+                                  const edyn::snapshot_baseline &received,
+                                  const std::vector<entt::entity> &entities) {
+    auto slot = edyn::snapshot_codec<Component>::slot;
+    ASSERT_EQ(sent[slot].size(), entities.size());
+    ASSERT_EQ(received[slot].size(), entities.size());
+
+    for (auto entity : entities) {
+        ASSERT_TRUE(received[slot].contains(entity));
+        EXPECT_EQ(sent[slot].at(entity), received[slot].at(entity));
+    }
+}
+
+template<typename Component>
+void test_vector3_round_trip(edyn::scalar resolution) {
+    auto settings = edyn::snapshot_codec_settings{};
+    auto values = std::vector<Component>{
+        Component{edyn::vector3_zero},
+        Component{edyn::vector3{1, -2, 3}},
+        Component{edyn::vector3{-0.12345, 0.00049, 7.77777}},
+        Component{edyn::vector3{120.5, -0.0001, -300.25}}
+    };
+    auto entities = make_entities(values.size());
+    edyn::snapshot_baseline sent;
+    edyn::snapshot_baseline received;
+    auto result = round_trip(settings, entities, values, nullptr, nullptr, sent, received);
+
+    ASSERT_EQ(result.size(), values.size());
+    // Resolution is sent as a float.
+    auto tolerance = resolution * edyn::scalar(0.5) + edyn::scalar(1e-5);
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_NEAR(result[i][j], values[i][j], tolerance);
+        }
+    }
+
+    expect_same_quantized_values<Component>(sent, received, entities);
+}
+
+edyn::orientation make_orientation(edyn::scalar x, edyn::scalar y, edyn::scalar z, edyn::scalar w) {
+    return edyn::orientation{edyn::normalize(edyn::quaternion{x, y, z, w})};
+}
+
+bool same_rotation(const edyn::quaternion &q0, const edyn::quaternion &q1, edyn::scalar tolerance) {
+    auto d = q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
+    return std::abs(std::abs(d) - 1) < tolerance;
+}
+
+}
+
+TEST(snapshot_codec_test, position_round_trip) {
+    test_vector3_round_trip<edyn::position>(edyn::snapshot_codec_settings{}.position_resolution);
+}
+
+TEST(snapshot_codec_test, linvel_round_trip) {
+    test_vector3_round_trip<edyn::linvel>(edyn::snapshot_codec_settings{}.velocity_resolution);
+}
+
+TEST(snapshot_codec_test, angvel_round_trip) {
+    test_vector3_round_trip<edyn::angvel>(edyn::snapshot_codec_settings{}.velocity_resolution);
+}
+
+TEST(snapshot_codec_test, orientation_smallest_three_round_trip) {
+    auto settings = edyn::snapshot_codec_settings{};
+    auto values = std::vector<edyn::orientation>{
+        edyn::orientation{edyn::quaternion_identity},
+        make_orientation(0.9, 0.1, -0.2, 0.3),
+        make_orientation(0.1, -0.9, 0.2, 0.3),
+        make_orientation(-0.1, 0.2, -0.9, 0.3),
+        make_orientation(0.3, 0.2, 0.1, -0.9),
+        // Two components of equal magnitude.
+        make_orientation(0.5, 0.5, 0.5, 0.5),
+        make_orientation(0, 0.70710678, 0, -0.70710678)
+    };
+    auto entities = make_entities(values.size());
+    edyn::snapshot_baseline sent;
+    edyn::snapshot_baseline received;
+    auto result = round_trip(settings, entities, values, nullptr, nullptr, sent, received);
+
+    ASSERT_EQ(result.size(), values.size());
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_NEAR(edyn::length(result[i]), 1, edyn::scalar(1e-5));
+        EXPECT_TRUE(same_rotation(result[i], values[i], settings.orientation_resolution * 4));
+    }
+
+    expect_same_quantized_values<edyn::orientation>(sent, received, entities);
+}
+
+TEST(snapshot_codec_test, delta_against_baseline) {
+    auto settings = edyn::snapshot_codec_settings{};
+    auto positions = std::vector<edyn::position>{
+        edyn::position{edyn::vector3{100, 20, -300}},
+        edyn::position{edyn::vector3{-5, 0.5, 42}},
+        edyn::position{edyn::vector3{1000, -1000, 1000}}
+    };
+    auto entities = make_entities(positions.size());
+
+    // First snapshot without baseline.
+    edyn::snapshot_baseline sent0;
+    edyn::snapshot_baseline received0;
+    size_t full_size;
+    round_trip(settings, entities, positions, nullptr, nullptr, sent0, received0, &full_size);
+
+    // Move the first entity slightly, keep the second unchanged and the third
+    // in the opposite direction.
+    auto moved = positions;
+    moved[0] += edyn::vector3{0.01, -0.002, 0};
+    moved[2] -= edyn::vector3{0.5, 0.5, 0.5};
+
+    edyn::snapshot_baseline sent1;
+    edyn::snapshot_baseline received1;
+    size_t delta_size;
+    auto result = round_trip(settings, entities, moved, &sent0, &received0, sent1, received1, &delta_size);
+
+    ASSERT_EQ(result.size(), moved.size());
+    auto tolerance = settings.position_resolution * edyn::scalar(0.5) + edyn::scalar(1e-4);
+
+    for (size_t i = 0; i < moved.size(); ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_NEAR(result[i][j], moved[i][j], tolerance);
+        }
+    }
+
+    // The unchanged value is decoded from the baseline.
+    auto slot = edyn::snapshot_codec<edyn::position>::slot;
+    EXPECT_EQ(received1[slot].at(entities[1]), received0[slot].at(entities[1]));
+    expect_same_quantized_values<edyn::position>(sent1, received1, entities);
+
+    // Small differences take fewer bits than full values.
+    EXPECT_LT(delta_size, full_size);
+}
+
+TEST(snapshot_codec_test, orientation_delta_against_baseline) {
+    auto settings = edyn::snapshot_codec_settings{};
+    auto values = std::vector<edyn::orientation>{
+        make_orientation(0.9, 0.1, -0.2, 0.3),
+        make_orientation(0.69, 0.7, 0.1, 0.1)
+    };
+    auto entities = make_entities(values.size());
+    edyn::snapshot_baseline sent0;
+    edyn::snapshot_baseline received0;
+    round_trip(settings, entities, values, nullptr, nullptr, sent0, received0);
+
+    // The largest component of the second orientation changes, thus it
+    // cannot be encoded as a difference.
+    auto rotated = values;
+    rotated[0] = make_orientation(0.9, 0.11, -0.2, 0.3);
+    rotated[1] = make_orientation(0.71, 0.69, 0.1, 0.1);
+
+    edyn::snapshot_baseline sent1;
+    edyn::snapshot_baseline received1;
+    auto result = round_trip(settings, entities, rotated, &sent0, &received0, sent1, received1);
+
+    ASSERT_EQ(result.size(), rotated.size());
+
+    for (size_t i = 0; i < rotated.size(); ++i) {
+        EXPECT_TRUE(same_rotation(result[i], rotated[i], settings.orientation_resolution * 4));
+    }
+
+    expect_same_quantized_values<edyn::orientation>(sent1, received1, entities);
+}
+
+TEST(snapshot_codec_test, max_quantized_value) {
+    auto settings = edyn::snapshot_codec_settings{};
+    // A coarse resolution so the extremes are representable as floats.
+    settings.position_resolution = 1;
+    auto max_value = static_cast<edyn::scalar>(edyn::detail::max_quantized_value);
+    auto positions = std::vector<edyn::position>{
+        edyn::position{edyn::vector3{max_value, -max_value, 0}},
+        // Out of range values are clamped.
+        edyn::position{edyn::vector3{max_value * 4, -max_value * 4, 1}}
+    };
+    auto entities = make_entities(positions.size());
+    edyn::snapshot_baseline sent0;
+    edyn::snapshot_baseline received0;
+    round_trip(settings, entities, positions, nullptr, nullptr, sent0, received0);
+
+    auto slot = edyn::snapshot_codec<edyn::position>::slot;
+    auto max_q = edyn::detail::max_quantized_value;
+
+    for (auto entity : entities) {
+        auto &value = received0[slot].at(entity);
+        EXPECT_EQ(value[0], max_q);
+        EXPECT_EQ(value[1], -max_q);
+    }
+
+    // Largest possible difference, from one extreme to the other.
+    auto flipped = std::vector<edyn::position>{
+        edyn::position{edyn::vector3{-max_value, max_value, 0}},
+        edyn::position{edyn::vector3{-max_value, max_value, 1}}
+    };
+    edyn::snapshot_baseline sent1;
+    edyn::snapshot_baseline received1;
+    round_trip(settings, entities, flipped, &sent0, &received0, sent1, received1);
+
+    for (auto entity : entities) {
+        auto &value = received1[slot].at(entity);
+        EXPECT_EQ(value[0], -max_q);
+        EXPECT_EQ(value[1], max_q);
+    }
+
+    expect_same_quantized_values<edyn::position>(sent1, received1, entities);
+}
+
+TEST(snapshot_codec_test, baseline_history_clear) {
+    edyn::snapshot_baseline_history history;
+    auto *baseline = history.insert(40);
+    ASSERT_NE(baseline, nullptr);
+    (*baseline)[0].insert_or_assign(static_cast<entt::entity>(1), edyn::quantized_value{1, 2, 3, 0});
+
+    // Sequence 8 takes the same place as 40 and is older.
+    EXPECT_EQ(history.insert(8), nullptr);
+
+    history.clear();
+    EXPECT_EQ(history.find(40), nullptr);
+    baseline = history.insert(8);
+    ASSERT_NE(baseline, nullptr);
+    EXPECT_TRUE((*baseline)[0].empty());
+}
+
+TEST(snapshot_codec_test, null_entity_is_rejected) {
+    auto settings = edyn::snapshot_codec_settings{};
+    auto entities = make_entities(2);
+    auto pool = edyn::pool_snapshot_data_impl<edyn::position>{};
+    pool.entity_indices = {0, 1};
+    pool.components = {edyn::position{edyn::vector3_one}, edyn::position{edyn::vector3_zero}};
+    edyn::snapshot_baseline sent;
+    pool.pack(settings, entities, nullptr, sent);
+
+    auto buffer = std::vector<uint8_t>{};
+    auto output = edyn::memory_output_archive(buffer);
+    pool.write(output);
+
+    // A remote peer could send null entities.
+    auto remote_entities = std::vector<entt::entity>{entities[0], entt::null};
+    auto result = edyn::pool_snapshot_data_impl<edyn::position>{};
+    auto input = edyn::memory_input_archive(buffer.data(), buffer.size());
+    result.read(input);
+    edyn::snapshot_baseline received;
+    EXPECT_FALSE(result.unpack(remote_entities, nullptr, received));
+
+    auto slot = edyn::snapshot_codec<edyn::position>::slot;
+    EXPECT_FALSE(received[slot].contains(entt::null));
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <edyn/parallel/job.hpp>
+#include <edyn/parallel/job_dispatcher.hpp>
+#include <edyn/parallel/parallel_for.hpp>
+
+namespace {
+
+constexpr size_t num_workers = 4;
+
+std::atomic<uint32_t> g_num_jobs_run {0};
+edyn::job_dispatcher *g_dispatcher {nullptr};
+
+// Runs the job in `data` and schedules two copies of it with a depth one
+// less from the worker thread, until the depth reaches zero.
+void fan_out_job_func(edyn::job::data_type &data) {
+    g_num_jobs_run.fetch_add(1, std::memory_order_relaxed);
+    auto depth = data[0];
+
+    if (depth == 0) {
+        return;
+    }
+
+    auto child = edyn::job();
+    child.func = &fan_out_job_func;
+    child.data[0] = depth - 1;
+    g_dispatcher->async(child);
+    g_dispatcher->async(child);
+}
+
+void count_job_func(edyn::job::data_type &) {
+    g_num_jobs_run.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Waits for the number of jobs to reach the expected value for a while.
+bool wait_for_jobs(uint32_t expected) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (g_num_jobs_run.load(std::memory_order_relaxed) < expected) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+
+        std::this_thread::yield();
+    }
+
+    return true;
+}
+
+class job_dispatcher_test : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dispatcher.start(num_workers);
+        g_dispatcher = &dispatcher;
+        g_num_jobs_run.store(0);
+    }
+
+    void TearDown() override {
+        dispatcher.stop();
+        g_dispatcher = nullptr;
+    }
+
+    edyn::job_dispatcher dispatcher;
+};
+
+}
+
+TEST_F(job_dispatcher_test, parallel_for) {
+    for (size_t rep = 0; rep < 200; ++rep) {
+        auto sum = std::atomic<size_t>{0};
+        edyn::parallel_for(dispatcher, size_t{0}, size_t{10000}, size_t{1}, [&](size_t i) {
+            sum.fetch_add(i, std::memory_order_relaxed);
+        });
+        ASSERT_EQ(sum.load(), size_t{49995000});
+    }
+}
+
+TEST_F(job_dispatcher_test, jobs_scheduled_from_workers) {
+    // Jobs scheduled in a worker's own queue must be stolen by the others.
+    constexpr uint8_t depth = 14;
+    auto j = edyn::job();
+    j.func = &fan_out_job_func;
+    j.data[0] = depth;
+    dispatcher.async(j);
+
+    ASSERT_TRUE(wait_for_jobs((1u << (depth + 1)) - 1));
+}
+
+TEST_F(job_dispatcher_test, parked_workers_wake_up) {
+    auto j = edyn::job();
+    j.func = &count_job_func;
+    uint32_t expected = 0;
+
+    for (size_t rep = 0; rep < 5; ++rep) {
+        // Give the workers time to run out of work and park.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        for (size_t i = 0; i < 100; ++i) {
+            dispatcher.async(j);
+        }
+
+        expected += 100;
+        ASSERT_TRUE(wait_for_jobs(expected));
+    }
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <edyn/parallel/job.hpp>
+#include <edyn/parallel/work_stealing_deque.hpp>
+
+namespace {
+
+edyn::job make_job(uint32_t id) {
+    auto j = edyn::job::noop();
+    std::memcpy(j.data.data(), &id, sizeof(id));
+    return j;
+}
+
+uint32_t get_id(const edyn::job &j) {
+    uint32_t id;
+    std::memcpy(&id, j.data.data(), sizeof(id));
+    return id;
+}
+
+}
+
+TEST(work_stealing_deque_test, jobs_are_taken_in_order) {
+    auto deque = edyn::work_stealing_deque(4);
+    edyn::job j;
+    EXPECT_FALSE(deque.steal(j));
+
+    // Push more than the initial capacity so the buffer grows.
+    for (uint32_t i = 0; i < 100; ++i) {
+        deque.push(make_job(i));
+    }
+
+    EXPECT_EQ(deque.size(), 100u);
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(deque.steal(j));
+        EXPECT_EQ(get_id(j), i);
+    }
+
+    EXPECT_EQ(deque.size(), 0u);
+    EXPECT_FALSE(deque.steal(j));
+}
+
+TEST(work_stealing_deque_test, concurrent_steal) {
+    constexpr uint32_t num_jobs = 200000;
+    constexpr size_t num_thieves = 4;
+
+    // A small initial capacity makes the buffer grow while thieves read it.
+    auto deque = edyn::work_stealing_deque(16);
+    auto taken = std::vector<std::atomic<uint32_t>>(num_jobs);
+    auto num_taken = std::atomic<uint32_t>{0};
+    auto done_pushing = std::atomic<bool>{false};
+
+    auto take = [&](edyn::job &j) {
+        taken[get_id(j)].fetch_add(1, std::memory_order_relaxed);
+        num_taken.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    auto thieves = std::vector<std::thread>{};
+
+    for (size_t i = 0; i < num_thieves; ++i) {
+        thieves.emplace_back([&] {
+            edyn::job j;
+
+            while (!done_pushing.load(std::memory_order_acquire) || deque.size() > 0) {
+                if (deque.steal(j)) {
+                    take(j);
+                }
+            }
+        });
+    }
+
+    // The owner also takes jobs every now and then.
+    for (uint32_t i = 0; i < num_jobs; ++i) {
+        deque.push(make_job(i));
+
+        if (i % 7 == 0) {
+            edyn::job j;
+
+            if (deque.steal(j)) {
+                take(j);
+            }
+        }
+    }
+
+    done_pushing.store(true, std::memory_order_release);
+
+    for (auto &thief : thieves) {
+        thief.join();
+    }
+
+    // Every job is taken exactly once.
+    ASSERT_EQ(num_taken.load(), num_jobs);
+
+    for (uint32_t i = 0; i < num_jobs; ++i) {
+        ASSERT_EQ(taken[i].load(), 1u);
+    }
+}
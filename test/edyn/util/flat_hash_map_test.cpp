@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <edyn/util/entity_map.hpp>
+#include <edyn/util/entity_pair.hpp>
+#include <edyn/util/flat_hash_map.hpp>
+
+namespace {
+
+// Places all keys in one of four home slots, which are evenly spaced, thus
+// keys with the same remainder form clusters. Keys which are 3 modulo 4 are
+// placed in the last quarter of the table and wrap around.
+struct colliding_traits {
+    static uint64_t empty_key() {
+        return UINT64_MAX;
+    }
+
+    static uint64_t hash(uint64_t key) {
+        return (key % 4) << 62;
+    }
+};
+
+using colliding_map = edyn::flat_hash_map<uint64_t, uint64_t, colliding_traits>;
+
+entt::entity make_entity(uint32_t value) {
+    return static_cast<entt::entity>(value);
+}
+
+template<typename Map>
+void expect_contents(const Map &map, const std::map<uint64_t, uint64_t> &expected) {
+    ASSERT_EQ(map.size(), expected.size());
+
+    for (auto &[key, value] : expected) {
+        ASSERT_TRUE(map.contains(key));
+        EXPECT_EQ(map.at(key), value);
+    }
+
+    size_t count = 0;
+    map.each([&](uint64_t key, uint64_t value) {
+        ASSERT_EQ(expected.count(key), 1u);
+        EXPECT_EQ(expected.at(key), value);
+        ++count;
+    });
+    EXPECT_EQ(count, expected.size());
+}
+
+}
+
+TEST(flat_hash_map_test, insert_and_find) {
+    auto map = edyn::flat_hash_map<entt::entity, int>{};
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(make_entity(1)));
+
+    EXPECT_TRUE(map.insert_or_assign(make_entity(1), 10));
+    EXPECT_TRUE(map.insert_or_assign(make_entity(2), 20));
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map.at(make_entity(1)), 10);
+    EXPECT_EQ(map.at(make_entity(2)), 20);
+
+    // Existing keys are assigned.
+    EXPECT_FALSE(map.insert_or_assign(make_entity(1), 11));
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map.at(make_entity(1)), 11);
+
+    EXPECT_TRUE(map.erase(make_entity(1)));
+    EXPECT_FALSE(map.erase(make_entity(1)));
+    EXPECT_FALSE(map.contains(make_entity(1)));
+    EXPECT_EQ(map.size(), 1u);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(make_entity(2)));
+}
+
+TEST(flat_hash_map_test, rehash_keeps_elements) {
+    auto map = edyn::flat_hash_map<entt::entity, uint32_t>{};
+
+    for (uint32_t i = 0; i < 10000; ++i) {
+        map.insert_or_assign(make_entity(i), i * 3);
+    }
+
+    ASSERT_EQ(map.size(), 10000u);
+
+    for (uint32_t i = 0; i < 10000; ++i) {
+        ASSERT_EQ(map.at(make_entity(i)), i * 3);
+    }
+}
+
+TEST(flat_hash_map_test, erase_shifts_back_cluster) {
+    auto map = colliding_map{};
+    auto expected = std::map<uint64_t, uint64_t>{};
+
+    // Two clusters that run into each other.
+    for (uint64_t key : {0, 4, 8, 12, 1, 5}) {
+        map.insert_or_assign(key, key + 100);
+        expected[key] = key + 100;
+    }
+
+    expect_contents(map, expected);
+
+    // Erasing from the start and the middle of the clusters must shift the
+    // following elements back so they can still be found.
+    for (uint64_t key : {0, 8, 1}) {
+        EXPECT_TRUE(map.erase(key));
+        expected.erase(key);
+        expect_contents(map, expected);
+    }
+
+    // Elements are placed again after the shifts.
+    for (uint64_t key : {16, 9}) {
+        map.insert_or_assign(key, key + 100);
+        expected[key] = key + 100;
+    }
+
+    expect_contents(map, expected);
+}
+
+TEST(flat_hash_map_test, erase_shifts_back_wrapping_cluster) {
+    auto map = colliding_map{};
+    auto expected = std::map<uint64_t, uint64_t>{};
+
+    // Seven keys in the last home slot of a table of 16 slots, thus the
+    // cluster wraps around to the first slots.
+    for (uint64_t key = 3; key < 28; key += 4) {
+        map.insert_or_assign(key, key);
+        expected[key] = key;
+    }
+
+    expect_contents(map, expected);
+
+    for (uint64_t key : {7, 3, 23}) {
+        EXPECT_TRUE(map.erase(key));
+        expected.erase(key);
+        expect_contents(map, expected);
+    }
+}
+
+TEST(flat_hash_map_test, erase_if) {
+    auto map = colliding_map{};
+    auto expected = std::map<uint64_t, uint64_t>{};
+
+    // Fifteen keys fit in a table of 32 slots. Ten in the last home slot, at
+    // index 24, which wrap around and run into the five keys in the first.
+    for (uint64_t i = 0; i < 10; ++i) {
+        auto key = i * 4 + 3;
+        map.insert_or_assign(key, i);
+        expected[key] = i;
+    }
+
+    for (uint64_t i = 0; i < 5; ++i) {
+        auto key = i * 4;
+        map.insert_or_assign(key, i);
+        expected[key] = i;
+    }
+
+    auto visited = std::vector<uint64_t>{};
+    map.erase_if([&](uint64_t key, uint64_t value) {
+        visited.push_back(key);
+        return value % 2 == 0;
+    });
+
+    for (auto it = expected.begin(); it != expected.end();) {
+        if (it->second % 2 == 0) {
+            it = expected.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    expect_contents(map, expected);
+
+    // Every element is visited exactly once, even if shifted.
+    std::sort(visited.begin(), visited.end());
+    EXPECT_EQ(std::adjacent_find(visited.begin(), visited.end()), visited.end());
+    EXPECT_EQ(visited.size(), 15u);
+}
+
+TEST(flat_hash_map_test, random_operations_match_std_map) {
+    auto rng = std::mt19937(1);
+    auto map = edyn::flat_hash_map<edyn::entity_pair, entt::entity>{};
+    auto expected = std::map<edyn::entity_pair, entt::entity>{};
+
+    for (size_t i = 0; i < 100000; ++i) {
+        auto first = make_entity(rng() % 500);
+        auto second = make_entity(rng() % 500);
+        auto pair = edyn::entity_pair(first, second);
+
+        switch (rng() % 3) {
+        case 0:
+            ASSERT_EQ(map.insert_or_assign(pair, first), expected.count(pair) == 0);
+            expected[pair] = first;
+            break;
+        case 1:
+            ASSERT_EQ(map.erase(pair), expected.erase(pair) > 0);
+            break;
+        default:
+            ASSERT_EQ(map.contains(pair), expected.count(pair) > 0);
+        }
+
+        if (i % 10000 == 0) {
+            auto predicate = [](auto &&key) {
+                return entt::to_integral(key.first) % 3 == 0;
+            };
+
+            map.erase_if([&](const edyn::entity_pair &key, entt::entity) {
+                return predicate(key);
+            });
+
+            for (auto it = expected.begin(); it != expected.end();) {
+                if (predicate(it->first)) {
+                    it = expected.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        ASSERT_EQ(map.size(), expected.size());
+    }
+
+    for (auto &[pair, entity] : expected) {
+        ASSERT_EQ(map.at(pair), entity);
+    }
+}
+
+TEST(entity_map_test, insert_and_erase) {
+    auto emap = edyn::entity_map{};
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        emap.insert(make_entity(i), make_entity(i + 1000));
+    }
+
+    EXPECT_EQ(emap.at(make_entity(5)), make_entity(1005));
+    EXPECT_EQ(emap.at_other(make_entity(1005)), make_entity(5));
+
+    emap.erase(make_entity(5));
+    emap.erase_other(make_entity(1006));
+    EXPECT_FALSE(emap.contains(make_entity(5)));
+    EXPECT_FALSE(emap.contains_other(make_entity(1005)));
+    EXPECT_FALSE(emap.contains(make_entity(6)));
+    EXPECT_FALSE(emap.contains_other(make_entity(1006)));
+
+    emap.erase_if([](entt::entity entity, entt::entity) {
+        return entt::to_integral(entity) % 2 == 1;
+    });
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        auto keep = i % 2 == 0 && i != 6;
+        EXPECT_EQ(emap.contains(make_entity(i)), keep);
+        EXPECT_EQ(emap.contains_other(make_entity(i + 1000)), keep);
+    }
+
+    emap.swap();
+    EXPECT_EQ(emap.at(make_entity(1000)), make_entity(0));
+    EXPECT_EQ(emap.at_other(make_entity(0)), make_entity(1000));
+}
+
+TEST(entity_map_test, null_entities_are_ignored) {
+    auto emap = edyn::entity_map{};
+    emap.insert(entt::null, make_entity(1));
+    emap.insert(make_entity(2), entt::null);
+
+    EXPECT_FALSE(emap.contains(entt::null));
+    EXPECT_FALSE(emap.contains_other(make_entity(1)));
+    EXPECT_FALSE(emap.contains(make_entity(2)));
+    EXPECT_FALSE(emap.contains_other(entt::null));
+
+    size_t count = 0;
+    emap.each([&](auto, auto) { ++count; });
+    EXPECT_EQ(count, 0u);
+}